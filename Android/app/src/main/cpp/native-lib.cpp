@@ -85,6 +85,8 @@ void JNI_CLASS_PREFIX(nativeDestroy)(JNIEnv *env, jobject /* this */,
     ctrl->spineDestroy();
 
     SAFE_DELETE(ctrl)
+    // GLProducerThread destroys the EGL context next, the next surface gets a new one
+    SpineController::spineContextLost();
 }
 
 void SpineLogFunc(void *context, int level, const char *str) {
@@ -130,10 +132,10 @@ namespace spine {
             if (assetFile) {
                 int totalLen = AAsset_getLength(assetFile);
                 if (totalLen > 0) {
-                    readBuffer = new char[totalLen + 1];
+                    readBuffer = SpineExtension::alloc<char>(totalLen + 1, __FILE__, __LINE__);
                     int readLen = AAsset_read(assetFile, readBuffer, totalLen);
                     if (readLen != totalLen) {
-                        delete[] readBuffer;
+                        SpineExtension::free(readBuffer, __FILE__, __LINE__);
                         readBuffer = nullptr;
                         *length = 0;
                     } else {
@@ -148,6 +150,15 @@ namespace spine {
 
             return readBuffer;
         };
+
+        // assets are not plain files, read them into a buffer instead of mmap
+        const char *_mapFile(const String &path, int *length) override {
+            return SpineExtension::_mapFile(path, length);
+        }
+
+        void _unmapFile(const char *data, int length) override {
+            SpineExtension::_unmapFile(data, length);
+        }
     };
 
     SpineExtension *getDefaultExtension() {
@@ -80,6 +80,7 @@ public class GLProducerThread extends Thread {
                 EGL10.EGL_BLUE_SIZE, 8,
                 EGL10.EGL_GREEN_SIZE, 8,
                 EGL10.EGL_RED_SIZE, 8,
+                EGL10.EGL_STENCIL_SIZE, 8,
                 EGL10.EGL_RENDERABLE_TYPE, EGL_OPENGL_ES2_BIT,
                 EGL10.EGL_SURFACE_TYPE, EGL10.EGL_WINDOW_BIT,
                 EGL10.EGL_NONE
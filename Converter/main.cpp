@@ -0,0 +1,38 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * Converts exported skeleton json to the binary .skel format at build time,
+ * so the runtimes load it without parsing text.
+ *
+ */
+
+#include <spine/spine.h>
+#include <spine/SkeletonBinaryWriter.h>
+
+#include <cstdio>
+
+namespace spine {
+SpineExtension *getDefaultExtension() {
+    return new DefaultSpineExtension();
+}
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 3 || (argc - 1) % 2 != 0) {
+        printf("usage: %s <input.json> <output.skel> [<input.json> <output.skel> ...]\n", argv[0]);
+        return -1;
+    }
+
+    int ret = 0;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        spine::SkeletonBinaryWriter writer;
+        if (!writer.writeSkeletonDataFile(argv[i], argv[i + 1])) {
+            printf("convert %s failed: %s\n", argv[i], writer.getError().buffer());
+            ret = -1;
+            continue;
+        }
+        printf("%s -> %s\n", argv[i], argv[i + 1]);
+    }
+    return ret;
+}
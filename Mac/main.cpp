@@ -11,8 +11,13 @@
 #include "SpineController.h"
 #include "utils/Logger.h"
 
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
 #include <thread>
+#include <vector>
 
 #define WIDTH   300
 #define HEIGHT  400
@@ -27,8 +32,19 @@
 
 #define FPS 30
 #define LOOP_TIME_SECOND 20
+#define UPLOAD_BUDGET_MS 2.0f
+#define TEXTURE_CACHE_DIR "spine-texture-cache"
 
+// usage: spine-mac [spawnCount] [sync]
+// spawns spawnCount characters on the first frame, asynchronously unless "sync" is given,
+// and logs the longest frame spent in spine code
 int main(int argc, char *argv[]) {
+    int spawnCount = argc > 1 ? std::max(1, atoi(argv[1])) : 1;
+    bool syncLoad = argc > 2 && strcmp(argv[2], "sync") == 0;
+
+    // decoded pages are kept between launches, the second run skips the png decode
+    SpineController::spineSetTextureCache(TEXTURE_CACHE_DIR);
+
     SpineGLContext glContext;
     bool glOk = glContext.create(WIDTH, HEIGHT);
     if (!glOk) {
@@ -36,22 +52,15 @@ int main(int argc, char *argv[]) {
         return -1;
     }
 
-    SpineController spineCtrl(WIDTH, HEIGHT);
-    bool createOk = spineCtrl.spineCreate(ATLAS_PATH, JSON_PATH, SKIN_NAME, POS_X, POS_Y, SCALE);
-    if (!createOk) {
-        LOG_ERROR("load spine resources failed");
-        return -1;
-    }
-
-    createOk = spineCtrl.spineSetAnimation(ANIM_NAME);
-    if (!createOk) {
-        LOG_ERROR("set spine animation failed");
-        return -1;
+    std::vector<std::unique_ptr<SpineController>> spineCtrls;
+    for (int i = 0; i < spawnCount; i++) {
+        spineCtrls.emplace_back(new SpineController(WIDTH, HEIGHT));
     }
 
     float frameIdx = 0;
     float delay = 1000.0f / FPS;
     std::chrono::system_clock::time_point a, b;
+    double worstFrameMs = 0;
 
     while (frameIdx < FPS * LOOP_TIME_SECOND) {
         a = std::chrono::system_clock::now();
@@ -67,12 +76,43 @@ int main(int argc, char *argv[]) {
         std::chrono::duration<double, std::milli> sleep_time = b - a;
 
         glContext.beforeDrawFrame();
-        spineCtrl.spineDraw(delay / 1000.0f);
+        auto frameStart = std::chrono::steady_clock::now();
+
+        if (frameIdx == 0) {
+            // spawn burst
+            for (auto &spineCtrl : spineCtrls) {
+                SpineController *ctrl = spineCtrl.get();
+                if (syncLoad) {
+                    if (!ctrl->spineCreate(ATLAS_PATH, JSON_PATH, SKIN_NAME, POS_X, POS_Y, SCALE)
+                        || !ctrl->spineSetAnimation(ANIM_NAME)) {
+                        LOG_ERROR("load spine resources failed");
+                    }
+                    continue;
+                }
+                ctrl->spineCreateAsync(ATLAS_PATH, JSON_PATH, [ctrl](bool success) {
+                    if (!success || !ctrl->spineSetAnimation(ANIM_NAME)) {
+                        LOG_ERROR("load spine resources failed");
+                    }
+                }, SKIN_NAME, POS_X, POS_Y, SCALE);
+            }
+        }
+
+        SpineController::spineProcessUploads(UPLOAD_BUDGET_MS);
+        for (auto &spineCtrl : spineCtrls) {
+            spineCtrl->spineDraw(delay / 1000.0f);
+        }
+
+        std::chrono::duration<double, std::milli> frameTime = std::chrono::steady_clock::now() - frameStart;
+        worstFrameMs = std::max(worstFrameMs, frameTime.count());
         glContext.afterDrawFrame();
 
         frameIdx++;
     }
-    spineCtrl.spineDestroy();
+    LOG_INFO("spawned %d, %s load, worst frame: %.2f ms", spawnCount, syncLoad ? "sync" : "async", worstFrameMs);
+
+    for (auto &spineCtrl : spineCtrls) {
+        spineCtrl->spineDestroy();
+    }
     glContext.destroy();
 
     return 0;
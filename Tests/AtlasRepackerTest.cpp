@@ -0,0 +1,137 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include <cstdlib>
+#include <vector>
+
+#include "AtlasRepacker.h"
+#include "SpineController.h"
+#include "TestUtils.h"
+
+using SpineRender::AtlasRepacker;
+
+void testRepackerPack() {
+    printf("AtlasRepacker::pack\n");
+    AtlasRepacker::Options options;
+    options.maxPageSize = 256;
+    options.padding = 2;
+    std::vector<AtlasRepacker::Rect> rects(300);
+    srand(7);
+    for (auto &rect : rects) {
+        rect.width = 1 + rand() % 90;
+        rect.height = 1 + rand() % 40;
+    }
+    // larger than a page, left out
+    rects[0].width = 300;
+    std::vector<AtlasRepacker::PageSize> pages = AtlasRepacker::pack(rects, options);
+    CHECK(pages.size() > 1);
+    CHECK(rects[0].page == -1);
+
+    bool rotated = false;
+    for (size_t i = 1; i < rects.size(); i++) {
+        const AtlasRepacker::Rect &a = rects[i];
+        CHECK(a.page >= 0 && a.page < (int) pages.size());
+        if (a.page < 0 || a.page >= (int) pages.size()) continue;
+        rotated |= a.rotated;
+        int aw = a.rotated ? a.height : a.width;
+        int ah = a.rotated ? a.width : a.height;
+        CHECK(a.x >= 0 && a.y >= 0 && a.x + aw <= pages[a.page].width && a.y + ah <= pages[a.page].height);
+        // regions don't overlap, nor their padding
+        for (size_t j = i + 1; j < rects.size(); j++) {
+            const AtlasRepacker::Rect &b = rects[j];
+            if (b.page != a.page) continue;
+            int bw = b.rotated ? b.height : b.width;
+            int bh = b.rotated ? b.width : b.height;
+            bool apart = a.x + aw + options.padding <= b.x || b.x + bw + options.padding <= a.x
+                         || a.y + ah + options.padding <= b.y || b.y + bh + options.padding <= a.y;
+            CHECK(apart);
+        }
+    }
+    CHECK(rotated);
+
+    options.allowRotation = false;
+    AtlasRepacker::pack(rects, options);
+    for (size_t i = 1; i < rects.size(); i++) {
+        CHECK(!rects[i].rotated);
+    }
+}
+
+void testRepackerCopyRegion() {
+    printf("AtlasRepacker::copyRegion\n");
+    const int size = 32, width = 7, height = 5;
+    std::vector<unsigned char> src(size * size * 4), rotated(size * size * 4, 0), back(size * size * 4, 0);
+    for (size_t i = 0; i < src.size(); i++) {
+        src[i] = (unsigned char) (i * 31 + 7);
+    }
+    AtlasRepacker::copyRegion(src.data(), size * 4, 3, 4, false, rotated.data(), size * 4, 10, 2, true, width, height);
+    AtlasRepacker::copyRegion(rotated.data(), size * 4, 10, 2, true, back.data(), size * 4, 1, 9, false, width, height);
+
+    bool same = true, layout = true;
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            const unsigned char *s = &src[((4 + j) * size + 3 + i) * 4];
+            // pixel (i, j) is stored at (x + j, y + width - 1 - i) when rotated
+            const unsigned char *r = &rotated[((2 + width - 1 - i) * size + 10 + j) * 4];
+            const unsigned char *b = &back[((9 + j) * size + 1 + i) * 4];
+            for (int c = 0; c < 4; c++) {
+                layout &= r[c] == s[c];
+                same &= b[c] == s[c];
+            }
+        }
+    }
+    CHECK(layout);
+    CHECK(same);
+}
+
+void testRepackerRestore() {
+    printf("AtlasRepacker restores cached atlases\n");
+    withTestSkeleton([](TestSkeleton &test) {
+        spine::Atlas *atlas = test.atlas;
+        spine::SkeletonData *skeletonData = test.skeletonData;
+
+        spine::RegionAttachment *attachment = nullptr;
+        spine::Skin *skin = skeletonData->getDefaultSkin();
+        spine::Skin::AttachmentMap::Entries entries = skin->getAttachments();
+        while (entries.hasNext() && !attachment) {
+            spine::Attachment *next = entries.next()._attachment;
+            if (next->getRTTI().isExactly(spine::RegionAttachment::rtti)) {
+                attachment = (spine::RegionAttachment *) next;
+            }
+        }
+        CHECK(attachment != nullptr);
+
+        if (attachment) {
+            auto *region = (spine::AtlasRegion *) attachment->getRendererObject();
+            spine::AtlasPage *sourcePage = region->page;
+            auto *sourceTexture = (SpineRender::OpenGLTexture *) sourcePage->getRendererObject();
+            spine::AtlasRegion before = *region;
+            std::vector<float> uvs(attachment->getUVs().buffer(), attachment->getUVs().buffer() + 8);
+
+            {
+                AtlasRepacker repacker;
+                CHECK(repacker.build({atlas}, {skeletonData}));
+                CHECK(repacker.apply());
+                CHECK(region->page != sourcePage);
+                CHECK(sourceTexture->textureId == 0);
+            }
+
+            // back on the source page, which is on the GPU again
+            CHECK(region->page == sourcePage);
+            CHECK(region->x == before.x && region->y == before.y && region->rotate == before.rotate);
+            CHECK(region->u == before.u && region->v == before.v && region->u2 == before.u2 && region->v2 == before.v2);
+            bool sameUVs = true;
+            for (int i = 0; i < 8; i++) {
+                sameUVs &= attachment->getUVs()[i] == uvs[i];
+            }
+            CHECK(sameUVs);
+            CHECK(sourceTexture->textureId != 0 && glIsTexture(sourceTexture->textureId));
+            CHECK(sourceTexture->byteSize > 0);
+        }
+    });
+}
@@ -0,0 +1,271 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "CompressedTexture.h"
+#include "TestUtils.h"
+
+using SpineRender::CompressedTexture;
+using SpineRender::OpenGLImage;
+
+static const unsigned char KTX1_ID[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+static const unsigned char KTX2_ID[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+static void putU32(std::vector<unsigned char> &data, size_t offset, uint32_t value, bool bigEndian = false) {
+    for (int i = 0; i < 4; i++) {
+        data[offset + (bigEndian ? 3 - i : i)] = (unsigned char) (value >> (i * 8));
+    }
+}
+
+static void putU16BE(std::vector<unsigned char> &data, size_t offset, int value) {
+    data[offset] = (unsigned char) (value >> 8);
+    data[offset + 1] = (unsigned char) value;
+}
+
+// 2d ktx with keyValueBytes of metadata and imageSize bytes of blocks
+static std::vector<unsigned char> makeKTX1(unsigned int format, int width, int height, uint32_t keyValueBytes,
+                                           uint32_t imageSize, bool bigEndian = false) {
+    std::vector<unsigned char> data(64 + keyValueBytes + 4 + imageSize, 0x55);
+    memcpy(data.data(), KTX1_ID, 12);
+    putU32(data, 12, 0x04030201, bigEndian);
+    putU32(data, 16, 0, bigEndian);         // glType, 0 when compressed
+    putU32(data, 28, format, bigEndian);
+    putU32(data, 36, (uint32_t) width, bigEndian);
+    putU32(data, 40, (uint32_t) height, bigEndian);
+    putU32(data, 44, 0, bigEndian);
+    putU32(data, 48, 0, bigEndian);
+    putU32(data, 52, 1, bigEndian);
+    putU32(data, 56, 1, bigEndian);
+    putU32(data, 60, keyValueBytes, bigEndian);
+    putU32(data, 64 + keyValueBytes, imageSize, bigEndian);
+    return data;
+}
+
+// ktx2 with one level right after the level index
+static std::vector<unsigned char> makeKTX2(uint32_t vkFormat, int width, int height, uint32_t levelLength) {
+    std::vector<unsigned char> data(80 + 24 + levelLength, 0x55);
+    memcpy(data.data(), KTX2_ID, 12);
+    putU32(data, 12, vkFormat);
+    putU32(data, 16, 1);
+    putU32(data, 20, (uint32_t) width);
+    putU32(data, 24, (uint32_t) height);
+    putU32(data, 28, 0);
+    putU32(data, 32, 0);
+    putU32(data, 36, 1);
+    putU32(data, 40, 1);
+    putU32(data, 44, 0);
+    memset(data.data() + 80, 0, 24);
+    putU32(data, 80, 80 + 24);
+    putU32(data, 88, levelLength);
+    return data;
+}
+
+static std::vector<unsigned char> makePKM(char version, int type, int width, int height, size_t dataSize) {
+    std::vector<unsigned char> data(16 + dataSize, 0x55);
+    memcpy(data.data(), "PKM ", 4);
+    data[4] = (unsigned char) version;
+    data[5] = '0';
+    putU16BE(data, 6, type);
+    putU16BE(data, 8, (width + 3) & ~3);
+    putU16BE(data, 10, (height + 3) & ~3);
+    putU16BE(data, 12, width);
+    putU16BE(data, 14, height);
+    return data;
+}
+
+static bool parse(const std::vector<unsigned char> &data, OpenGLImage *image, std::string *error = nullptr) {
+    return CompressedTexture::parse((const char *) data.data(), data.size(), image, error);
+}
+
+static bool isContainer(const std::vector<unsigned char> &data) {
+    return CompressedTexture::isContainer((const char *) data.data(), data.size());
+}
+
+void testCompressedTextureParse() {
+    printf("CompressedTexture::parse\n");
+    OpenGLImage image;
+    std::string error;
+
+    // ktx, both byte orders, metadata skipped
+    for (int bigEndian = 0; bigEndian < 2; bigEndian++) {
+        std::vector<unsigned char> ktx = makeKTX1(GL_COMPRESSED_RGBA8_ETC2_EAC, 8, 4, 12, 32, bigEndian != 0);
+        CHECK(isContainer(ktx));
+        image = OpenGLImage();
+        CHECK(parse(ktx, &image));
+        CHECK(image.width == 8 && image.height == 4);
+        CHECK(image.compressedFormat == GL_COMPRESSED_RGBA8_ETC2_EAC);
+        CHECK(image.dataSize == 32);
+        CHECK(image.pixels == ktx.data() + 64 + 12 + 4);
+    }
+
+    // metadata sizes past the end, including ones that wrap the offset on 32 bit
+    uint32_t badKeyValueBytes[] = {1000, 0xFFFFFFF0u, 0xFFFFFFFFu};
+    for (uint32_t keyValueBytes : badKeyValueBytes) {
+        std::vector<unsigned char> ktx = makeKTX1(GL_ETC1_RGB8_OES, 4, 4, 0, 8);
+        putU32(ktx, 60, keyValueBytes);
+        CHECK(!parse(ktx, &image, &error));
+        CHECK(error == "ktx data truncated");
+    }
+
+    std::vector<unsigned char> ktx = makeKTX1(GL_ETC1_RGB8_OES, 8, 8, 0, 32);
+    CHECK(parse(ktx, &image));
+    ktx.resize(ktx.size() - 1);
+    CHECK(!parse(ktx, &image, &error));
+    CHECK(error == "texture data truncated");
+    ktx.resize(40);
+    CHECK(!parse(ktx, &image, &error));
+    CHECK(error == "ktx header truncated");
+
+    ktx = makeKTX1(GL_ETC1_RGB8_OES, 4, 4, 0, 8);
+    putU32(ktx, 16, GL_UNSIGNED_BYTE);
+    CHECK(!parse(ktx, &image, &error));
+    ktx = makeKTX1(GL_ETC1_RGB8_OES, 4, 4, 0, 8);
+    putU32(ktx, 52, 6);
+    CHECK(!parse(ktx, &image, &error));
+    CHECK(error == "only 2d ktx textures are supported");
+    ktx = makeKTX1(GL_RGBA, 4, 4, 0, 64);
+    CHECK(!parse(ktx, &image, &error));
+    CHECK(error == "unsupported texture format");
+    ktx = makeKTX1(GL_ETC1_RGB8_OES, 0, 4, 0, 8);
+    CHECK(!parse(ktx, &image, &error));
+    CHECK(error == "invalid texture size");
+
+    // ktx2, vulkan formats
+    std::vector<unsigned char> ktx2 = makeKTX2(131, 8, 8, 32);
+    CHECK(isContainer(ktx2));
+    image = OpenGLImage();
+    CHECK(parse(ktx2, &image));
+    CHECK(image.width == 8 && image.height == 8);
+    CHECK(image.compressedFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT);
+    CHECK(image.dataSize == 32);
+    CHECK(image.pixels == ktx2.data() + 80 + 24);
+
+    ktx2 = makeKTX2(157, 4, 4, 16);
+    CHECK(parse(ktx2, &image) && image.compressedFormat == GL_COMPRESSED_RGBA_ASTC_4x4_KHR);
+    ktx2 = makeKTX2(183, 12, 12, 16);
+    CHECK(parse(ktx2, &image) && image.compressedFormat == GL_COMPRESSED_RGBA_ASTC_12x12_KHR);
+    ktx2 = makeKTX2(158, 4, 4, 16);     // ASTC_4x4_SRGB
+    CHECK(!parse(ktx2, &image, &error));
+    CHECK(error == "unsupported ktx2 format");
+
+    ktx2 = makeKTX2(137, 4, 4, 16);
+    putU32(ktx2, 44, 2);                // zstd
+    CHECK(!parse(ktx2, &image, &error));
+    CHECK(error == "supercompressed ktx2 is not supported");
+
+    ktx2 = makeKTX2(137, 4, 4, 16);
+    putU32(ktx2, 80, 0xFFFFFFFFu);      // level offset past the end
+    CHECK(!parse(ktx2, &image, &error));
+    ktx2 = makeKTX2(137, 4, 4, 16);
+    putU32(ktx2, 92, 1);                // level length above 4 GB
+    CHECK(parse(ktx2, &image));
+    ktx2 = makeKTX2(137, 8, 8, 16);
+    CHECK(!parse(ktx2, &image, &error));
+    CHECK(error == "texture data truncated");
+
+    // pkm, the data is padded to whole blocks, the image keeps the original size
+    std::vector<unsigned char> pkm = makePKM('1', 0, 5, 3, 16);
+    CHECK(isContainer(pkm));
+    image = OpenGLImage();
+    CHECK(parse(pkm, &image));
+    CHECK(image.width == 5 && image.height == 3);
+    CHECK(image.compressedFormat == GL_ETC1_RGB8_OES);
+    CHECK(image.dataSize == 16);
+    CHECK(image.pixels == pkm.data() + 16);
+
+    pkm = makePKM('2', 3, 4, 4, 16);
+    CHECK(parse(pkm, &image) && image.compressedFormat == GL_COMPRESSED_RGBA8_ETC2_EAC);
+    pkm = makePKM('2', 4, 4, 4, 8);
+    CHECK(parse(pkm, &image) && image.compressedFormat == GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2);
+    pkm = makePKM('2', 9, 4, 4, 8);
+    CHECK(!parse(pkm, &image, &error));
+    CHECK(error == "unsupported pkm format");
+    pkm = makePKM('1', 0, 8, 8, 31);
+    CHECK(!parse(pkm, &image, &error));
+    CHECK(error == "texture data truncated");
+
+    const unsigned char png[] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n', 0, 0, 0, 13};
+    CHECK(!CompressedTexture::isContainer((const char *) png, sizeof(png)));
+    CHECK(!CompressedTexture::parse((const char *) png, sizeof(png), &image, &error));
+    CHECK(!CompressedTexture::isContainer((const char *) KTX1_ID, 11));
+
+    CHECK(CompressedTexture::levelSize(GL_COMPRESSED_RGBA_ASTC_12x12_KHR, 100, 100) == 9 * 9 * 16);
+    CHECK(CompressedTexture::levelSize(GL_ETC1_RGB8_OES, 5, 3) == 2 * 1 * 8);
+    CHECK(CompressedTexture::levelSize(GL_RGBA, 4, 4) == 0);
+}
+
+// transcodes blocks into a width x height image, with a guard byte past the end
+static std::vector<unsigned char> transcode(unsigned int format, int width, int height,
+                                            const std::vector<unsigned char> &blocks) {
+    OpenGLImage image;
+    image.width = width;
+    image.height = height;
+    image.compressedFormat = format;
+    image.pixels = (unsigned char *) blocks.data();
+    image.dataSize = blocks.size();
+    std::vector<unsigned char> rgba((size_t) width * height * 4 + 1, 0xEE);
+    CHECK(CompressedTexture::transcode(image, rgba.data()));
+    CHECK(rgba.back() == 0xEE);
+    rgba.pop_back();
+    return rgba;
+}
+
+static bool allTexels(const std::vector<unsigned char> &rgba, int r, int g, int b, int a) {
+    for (size_t i = 0; i < rgba.size(); i += 4) {
+        if (rgba[i] != r || rgba[i + 1] != g || rgba[i + 2] != b || rgba[i + 3] != a) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void testCompressedTextureTranscode() {
+    printf("CompressedTexture::transcode\n");
+
+    // etc1 individual mode, black base colors, table 0, all indices 0: +2 on every channel
+    std::vector<unsigned char> etc1(8, 0);
+    CHECK(allTexels(transcode(GL_ETC1_RGB8_OES, 4, 4, etc1), 2, 2, 2, 255));
+
+    // dxt1 red to blue, all indices 0. 5x3 clips the edge blocks of a 2x1 block image
+    std::vector<unsigned char> dxt1 = {0x00, 0xF8, 0x1F, 0x00, 0, 0, 0, 0};
+    dxt1.insert(dxt1.end(), dxt1.begin(), dxt1.end());
+    CHECK(allTexels(transcode(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 5, 3, dxt1), 255, 0, 0, 255));
+
+    // dxt1 with c0 <= c1 has a transparent black fourth color
+    std::vector<unsigned char> dxt1a = {0x1F, 0x00, 0x00, 0xF8, 0xFF, 0xFF, 0xFF, 0xFF};
+    CHECK(allTexels(transcode(GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 4, 4, dxt1a), 0, 0, 0, 0));
+    CHECK(allTexels(transcode(GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 4, 4, dxt1a), 0, 0, 0, 255));
+
+    // dxt5 alpha 0 over red: the color is kept as stored, transcoding doesn't premultiply
+    std::vector<unsigned char> dxt5 = {0, 255, 0, 0, 0, 0, 0, 0, 0x00, 0xF8, 0x1F, 0x00, 0, 0, 0, 0};
+    CHECK(allTexels(transcode(GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 4, 4, dxt5), 255, 0, 0, 0));
+
+    // dxt3 explicit 4 bit alpha
+    std::vector<unsigned char> dxt3 = {0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x88,
+                                       0x00, 0xF8, 0x1F, 0x00, 0, 0, 0, 0};
+    CHECK(allTexels(transcode(GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, 4, 4, dxt3), 255, 0, 0, 0x88));
+
+    // etc2 eac alpha, base 128 multiplier 0: every texel 128, over the etc1 block above
+    std::vector<unsigned char> eac = {128, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
+    CHECK(allTexels(transcode(GL_COMPRESSED_RGBA8_ETC2_EAC, 4, 4, eac), 2, 2, 2, 128));
+
+    OpenGLImage astc;
+    astc.width = 4;
+    astc.height = 4;
+    astc.compressedFormat = GL_COMPRESSED_RGBA_ASTC_4x4_KHR;
+    std::vector<unsigned char> block(16, 0);
+    astc.pixels = block.data();
+    unsigned char rgba[64];
+    CHECK(!CompressedTexture::canTranscode(GL_COMPRESSED_RGBA_ASTC_4x4_KHR));
+    CHECK(!CompressedTexture::transcode(astc, rgba));
+}
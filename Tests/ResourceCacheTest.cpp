@@ -0,0 +1,115 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include <thread>
+#include <vector>
+
+#include "SpineController.h"
+#include "TestUtils.h"
+
+static std::vector<GLuint> textureIds(spine::Atlas *atlas) {
+    std::vector<GLuint> ids;
+    spine::Vector<spine::AtlasPage *> &pages = atlas->getPages();
+    for (size_t i = 0; i < pages.size(); i++) {
+        auto *texture = (SpineRender::OpenGLTexture *) pages[i]->getRendererObject();
+        ids.push_back(texture ? texture->textureId : 0);
+    }
+    return ids;
+}
+
+void testAtlasDitherKey() {
+    printf("atlas cache key with dither\n");
+    SpineRender::TextureUploader *uploader = SpineController::textureUploader();
+    spine::Atlas *dithered = SpineRender::ResourceCache::acquireAtlas(TEST_ATLAS, uploader, true);
+    spine::Atlas *plain = SpineRender::ResourceCache::acquireAtlas(TEST_ATLAS, uploader, false);
+    spine::Atlas *again = SpineRender::ResourceCache::acquireAtlas(TEST_ATLAS, uploader, false);
+    CHECK(dithered != nullptr && plain != nullptr);
+    CHECK(dithered != plain);
+    CHECK(again == plain);
+    uploader->flush(SpineRender::ResourceCache::textureLoader(dithered));
+    uploader->flush(SpineRender::ResourceCache::textureLoader(plain));
+    SpineRender::ResourceCache::releaseAtlas(again);
+    SpineRender::ResourceCache::releaseAtlas(plain);
+    SpineRender::ResourceCache::releaseAtlas(dithered);
+}
+
+void testContextLost() {
+    printf("resource cache after context loss\n");
+    SpineRender::TextureUploader *uploader = SpineController::textureUploader();
+    spine::Atlas *unused = SpineRender::ResourceCache::acquireAtlas(TEST_ATLAS, uploader, true);
+    spine::Atlas *used = SpineRender::ResourceCache::acquireAtlas(TEST_ATLAS, uploader, false);
+    CHECK(unused != nullptr && used != nullptr);
+    if (!unused || !used) return;
+    uploader->flush(SpineRender::ResourceCache::textureLoader(unused));
+    uploader->flush(SpineRender::ResourceCache::textureLoader(used));
+    SpineRender::ResourceCache::releaseAtlas(unused);
+    std::vector<GLuint> lostIds = textureIds(used);
+    std::vector<GLuint> unusedIds = textureIds(unused);
+    CHECK(SpineController::spineResourceStats().residentBytes > 0);
+
+    SpineController::spineContextLost();
+
+    // the names are left to the context, only the atlas in use stays, its pages are queued again
+    for (GLuint id : lostIds) {
+        CHECK(id != 0 && glIsTexture(id));
+    }
+    for (GLuint id : unusedIds) {
+        CHECK(id != 0 && glIsTexture(id));
+    }
+    SpineRender::ResourceCache::Stats stats = SpineController::spineResourceStats();
+    CHECK(stats.atlasCount == 1);
+    CHECK(stats.residentBytes == 0);
+    spine::TextureLoader *loader = SpineRender::ResourceCache::textureLoader(used);
+    CHECK(uploader->pendingCount(loader) == used->getPages().size());
+    CHECK(glGetError() == GL_NO_ERROR);
+
+    // uploaded again as if into a new context
+    uploader->flush(loader);
+    CHECK(SpineController::spineResourceStats().residentBytes > 0);
+    std::vector<GLuint> ids = textureIds(used);
+    for (GLuint id : ids) {
+        CHECK(id != 0 && glIsTexture(id));
+    }
+    SpineRender::ResourceCache::releaseAtlas(used);
+
+    // this context lives on, free what the cache forgot
+    for (GLuint id : lostIds) {
+        glDeleteTextures(1, &id);
+    }
+    for (GLuint id : unusedIds) {
+        glDeleteTextures(1, &id);
+    }
+}
+
+void testReleaseOffThread() {
+    printf("resource cache released on a loader thread\n");
+    SpineRender::TextureUploader *uploader = SpineController::textureUploader();
+    spine::Atlas *atlas = SpineRender::ResourceCache::acquireAtlas(TEST_ATLAS, uploader, true);
+    CHECK(atlas != nullptr);
+    if (!atlas) return;
+    uploader->flush(SpineRender::ResourceCache::textureLoader(atlas));
+    std::vector<GLuint> ids = textureIds(atlas);
+
+    // no GL context on this thread, the evicted textures wait for the GL thread
+    std::thread loader([atlas] {
+        SpineRender::ResourceCache::releaseAtlas(atlas);
+        SpineRender::ResourceCache::trim(0);
+    });
+    loader.join();
+    CHECK(SpineController::spineResourceStats().atlasCount == 0);
+    for (GLuint id : ids) {
+        CHECK(id != 0 && glIsTexture(id));
+    }
+
+    SpineController::spineProcessUploads();
+    for (GLuint id : ids) {
+        CHECK(!glIsTexture(id));
+    }
+    CHECK(glGetError() == GL_NO_ERROR);
+}
@@ -0,0 +1,113 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include <algorithm>
+#include <cstdlib>
+#include <vector>
+
+#include "SpineController.h"
+#include "TestUtils.h"
+
+struct Frame {
+    std::vector<unsigned char> pixels;
+    // alpha coverage: bounding box and sum
+    int minX = TEST_WIDTH, minY = TEST_HEIGHT, maxX = -1, maxY = -1;
+    long long coverage = 0;
+};
+
+static Frame drawFrame(spine::SkeletonDrawable &drawable) {
+    glClearColor(0, 0, 0, 0);
+    glClear(GL_COLOR_BUFFER_BIT);
+    drawable.draw();
+
+    Frame frame;
+    frame.pixels.resize(TEST_WIDTH * TEST_HEIGHT * 4);
+    glReadPixels(0, 0, TEST_WIDTH, TEST_HEIGHT, GL_RGBA, GL_UNSIGNED_BYTE, frame.pixels.data());
+    for (int y = 0; y < TEST_HEIGHT; y++) {
+        for (int x = 0; x < TEST_WIDTH; x++) {
+            unsigned char alpha = frame.pixels[(y * TEST_WIDTH + x) * 4 + 3];
+            if (alpha == 0) continue;
+            frame.coverage += alpha;
+            frame.minX = std::min(frame.minX, x);
+            frame.minY = std::min(frame.minY, y);
+            frame.maxX = std::max(frame.maxX, x);
+            frame.maxY = std::max(frame.maxY, y);
+        }
+    }
+    return frame;
+}
+
+// pixels whose channels differ by more than tolerance, per thousand covered pixels
+static int differingPermille(const Frame &a, const Frame &b, int tolerance) {
+    int differing = 0, covered = 0;
+    for (size_t i = 0; i < a.pixels.size(); i += 4) {
+        if (a.pixels[i + 3] == 0 && b.pixels[i + 3] == 0) continue;
+        covered++;
+        for (int c = 0; c < 4; c++) {
+            if (std::abs(a.pixels[i + c] - b.pixels[i + c]) > tolerance) {
+                differing++;
+                break;
+            }
+        }
+    }
+    return covered ? differing * 1000 / covered : 0;
+}
+
+void testSwirlShader() {
+    printf("swirl on the GPU and the CPU\n");
+    withTestSkeleton([](TestSkeleton &test) {
+        spine::SkeletonDrawable &drawable = test.drawable;
+        Frame plain = drawFrame(drawable);
+
+        spine::PowInterpolation interpolation(2);
+        spine::SwirlVertexEffect swirl(120, interpolation);
+        swirl.setCenterY(-150);
+        swirl.setAngle(60);
+        drawable.setVertexEffect(&swirl);
+        drawable.setUseShaderEffects(true);
+        Frame gpu = drawFrame(drawable);
+        drawable.setUseShaderEffects(false);
+        Frame cpu = drawFrame(drawable);
+        drawable.setVertexEffect(nullptr);
+
+        // the swirl moves a good part of the skeleton, the shader samples the curve at 17 points,
+        // which is off by a fraction of a pixel at the edges of some triangles
+        CHECK(differingPermille(plain, gpu, 8) > 100);
+        CHECK(differingPermille(cpu, gpu, 8) < 10);
+    });
+}
+
+void testJitterShader() {
+    printf("jitter on the GPU and the CPU\n");
+    withTestSkeleton([](TestSkeleton &test) {
+        spine::SkeletonDrawable &drawable = test.drawable;
+        Frame plain = drawFrame(drawable);
+
+        const float amount = 4;
+        spine::JitterVertexEffect jitter(amount, amount);
+        drawable.setVertexEffect(&jitter);
+        drawable.setUseShaderEffects(true);
+        Frame gpu = drawFrame(drawable);
+        drawable.setUseShaderEffects(false);
+        Frame cpu = drawFrame(drawable);
+        drawable.setVertexEffect(nullptr);
+
+        // the CPU and the shader draw different random numbers, compare how far the vertices spread:
+        // as much on both, by no more than the jitter, with the coverage kept
+        int movedGpu = differingPermille(plain, gpu, 8);
+        int movedCpu = differingPermille(plain, cpu, 8);
+        CHECK(movedGpu > 100 && movedCpu > 100);
+        CHECK(movedGpu < movedCpu * 2 && movedCpu < movedGpu * 2);
+        for (const Frame *frame : {&gpu, &cpu}) {
+            CHECK(std::abs(frame->minX - plain.minX) <= amount && std::abs(frame->maxX - plain.maxX) <= amount);
+            CHECK(std::abs(frame->minY - plain.minY) <= amount && std::abs(frame->maxY - plain.maxY) <= amount);
+            CHECK(std::abs(frame->coverage - plain.coverage) < plain.coverage / 20);
+        }
+    });
+}
@@ -0,0 +1,176 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#include "SpineController.h"
+#include "TestUtils.h"
+
+// frames of spineCreateAsync, gives up after a few seconds
+#define LOAD_TIMEOUT_MS 10000
+
+// draws frames the way the host's render loop does until done() or the timeout
+template<typename Done>
+static bool drawUntil(SpineController &controller, Done done) {
+    auto start = std::chrono::steady_clock::now();
+    while (!done()) {
+        if (std::chrono::steady_clock::now() - start > std::chrono::milliseconds(LOAD_TIMEOUT_MS)) {
+            return false;
+        }
+        SpineController::spineProcessUploads();
+        controller.spineDraw(1.0f / 60);
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    return true;
+}
+
+// no controller keeps a reference, everything left is only cached
+static bool nothingReferenced() {
+    SpineRender::ResourceCache::Stats stats = SpineController::spineResourceStats();
+    return stats.unreferencedBytes == stats.residentBytes;
+}
+
+void testAsyncCreate() {
+    printf("spineCreateAsync\n");
+    SpineController controller(TEST_WIDTH, TEST_HEIGHT);
+    int calls = 0;
+    bool loaded = false;
+    size_t pendingAtCallback = 1;
+    CHECK(controller.spineCreateAsync(TEST_ATLAS, TEST_SKELETON, [&](bool success) {
+        calls++;
+        loaded = success;
+        // the skeleton may only be drawn once its pages are on the GPU
+        spine::Atlas *atlas = SpineRender::ResourceCache::acquireAtlas(TEST_ATLAS, SpineController::textureUploader(), true);
+        pendingAtCallback = SpineController::textureUploader()->pendingCount(SpineRender::ResourceCache::textureLoader(atlas));
+        SpineRender::ResourceCache::releaseAtlas(atlas);
+    }, "default", 150, 50));
+
+    // loading: a second load is refused and there is nothing to animate yet
+    CHECK(!controller.spineCreateAsync(TEST_ATLAS, TEST_SKELETON, [](bool) {}));
+    CHECK(!controller.spineSetAnimation("walk"));
+
+    CHECK(drawUntil(controller, [&] { return calls > 0; }));
+    CHECK(calls == 1);
+    CHECK(loaded);
+    CHECK(pendingAtCallback == 0);
+
+    // loaded: the callback is not called again
+    CHECK(controller.spineSetAnimation("walk"));
+    for (int i = 0; i < 10; i++) {
+        controller.spineDraw(1.0f / 60);
+    }
+    CHECK(calls == 1);
+    CHECK(glGetError() == GL_NO_ERROR);
+
+    controller.spineDestroy();
+    CHECK(!controller.spineSetAnimation("walk"));
+    CHECK(nothingReferenced());
+
+    // destroyed: the controller may load again
+    calls = 0;
+    CHECK(controller.spineCreateAsync(TEST_ATLAS, TEST_SKELETON, [&](bool success) {
+        calls++;
+        loaded = success;
+    }));
+    CHECK(drawUntil(controller, [&] { return calls > 0; }));
+    CHECK(calls == 1 && loaded);
+    controller.spineDestroy();
+}
+
+void testAsyncCreateFailure() {
+    printf("spineCreateAsync of missing files\n");
+    SpineController controller(TEST_WIDTH, TEST_HEIGHT);
+    int calls = 0;
+    bool loaded = true;
+    auto callback = [&](bool success) {
+        calls++;
+        loaded = success;
+    };
+
+    CHECK(controller.spineCreateAsync("testdata/missing.atlas", TEST_SKELETON, callback));
+    CHECK(drawUntil(controller, [&] { return calls > 0; }));
+    CHECK(calls == 1 && !loaded);
+    CHECK(!controller.spineSetAnimation("walk"));
+    controller.spineDestroy();
+
+    calls = 0;
+    loaded = true;
+    CHECK(controller.spineCreateAsync(TEST_ATLAS, "testdata/missing.json", callback));
+    CHECK(drawUntil(controller, [&] { return calls > 0; }));
+    CHECK(calls == 1 && !loaded);
+    CHECK(!controller.spineSetAnimation("walk"));
+    controller.spineDestroy();
+    CHECK(nothingReferenced());
+}
+
+void testDestroyWhileLoading() {
+    printf("spineDestroy while spineCreateAsync loads\n");
+    SpineController controller(TEST_WIDTH, TEST_HEIGHT);
+    int calls = 0;
+    auto callback = [&](bool) { calls++; };
+
+    // right away, while the loader thread reads the files
+    CHECK(controller.spineCreateAsync(TEST_ATLAS, TEST_SKELETON, callback));
+    controller.spineDestroy();
+    CHECK(!controller.spineSetAnimation("walk"));
+
+    // once the pages are decoded, before the GL thread uploaded them
+    CHECK(controller.spineCreateAsync(TEST_ATLAS, TEST_SKELETON, callback));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    controller.spineDestroy();
+
+    // the canceled loads never call back, and their uploads don't touch the released atlas. the
+    // loader threads release what they loaded once they finish
+    CHECK(drawUntil(controller, nothingReferenced));
+    CHECK(calls == 0);
+    CHECK(glGetError() == GL_NO_ERROR);
+
+    // before the load even started: destroy doesn't wait for it. the blockers give up after a
+    // while, so a destroy that waits returns late instead of hanging
+    struct Blocker {
+        std::mutex mutex;
+        std::condition_variable cond;
+        bool released = false;
+    };
+    auto blocker = std::make_shared<Blocker>();
+    SpineRender::ThreadPool *pool = SpineController::loaderPool();
+    for (size_t i = 0; i < pool->size(); i++) {
+        pool->post([blocker] {
+            std::unique_lock<std::mutex> lock(blocker->mutex);
+            blocker->cond.wait_for(lock, std::chrono::seconds(2), [&] { return blocker->released; });
+        });
+    }
+    CHECK(controller.spineCreateAsync(TEST_ATLAS, TEST_SKELETON, callback));
+    auto start = std::chrono::steady_clock::now();
+    controller.spineDestroy();
+    CHECK(std::chrono::steady_clock::now() - start < std::chrono::seconds(1));
+    {
+        std::lock_guard<std::mutex> lock(blocker->mutex);
+        blocker->released = true;
+    }
+    blocker->cond.notify_all();
+    CHECK(drawUntil(controller, nothingReferenced));
+    CHECK(calls == 0);
+
+    // the controller still loads normally afterwards
+    bool loaded = false;
+    CHECK(controller.spineCreateAsync(TEST_ATLAS, TEST_SKELETON, [&](bool success) {
+        calls++;
+        loaded = success;
+    }));
+    CHECK(drawUntil(controller, [&] { return calls > 0; }));
+    CHECK(calls == 1 && loaded);
+    CHECK(controller.spineSetAnimation("walk"));
+    controller.spineDestroy();
+    CHECK(nothingReferenced());
+}
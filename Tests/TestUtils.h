@@ -0,0 +1,71 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#ifndef SPINE_TESTS_TESTUTILS_H_
+#define SPINE_TESTS_TESTUTILS_H_
+
+#include <cstdio>
+
+#include "SpineController.h"
+
+// assert is compiled out of release builds, checks count failures for the exit code instead
+extern int failures;
+#define CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+            failures++; \
+        } \
+    } while (0)
+
+#define TEST_ATLAS "testdata/spineboy/spineboy.atlas"
+#define TEST_SKELETON "testdata/spineboy/spineboy-ess.json"
+
+// size of the offscreen framebuffer bound by main
+#define TEST_WIDTH 300
+#define TEST_HEIGHT 400
+
+// the test skeleton in its setup pose at (150, 350) with the default skin, its atlas and skeleton
+// data acquired from the resource cache with the pages uploaded
+struct TestSkeleton {
+    spine::Atlas *atlas;
+    spine::SkeletonData *skeletonData;
+    spine::SkeletonDrawable &drawable;
+};
+
+// runs test(TestSkeleton &) on the GL thread, then releases the skeleton
+template<typename Test>
+void withTestSkeleton(Test test) {
+    SpineRender::GLBatchRender render;
+    render.create(TEST_WIDTH, TEST_HEIGHT);
+    spine::Atlas *atlas = SpineRender::ResourceCache::acquireAtlas(TEST_ATLAS, SpineController::textureUploader(), true);
+    CHECK(atlas != nullptr);
+    spine::SkeletonData *skeletonData = nullptr;
+    if (atlas) {
+        SpineController::textureUploader()->flush(SpineRender::ResourceCache::textureLoader(atlas));
+        skeletonData = SpineRender::ResourceCache::acquireSkeletonData(TEST_SKELETON, atlas, 1.0f);
+        CHECK(skeletonData != nullptr);
+    }
+    if (skeletonData) {
+        spine::SkeletonDrawable drawable(&render, skeletonData);
+        spine::Skeleton *skeleton = drawable.getSkeleton();
+        skeleton->setPosition(150, 350);
+        skeleton->setSkin("default");
+        skeleton->setSlotsToSetupPose();
+        skeleton->updateWorldTransform();
+        TestSkeleton testSkeleton = {atlas, skeletonData, drawable};
+        test(testSkeleton);
+        CHECK(glGetError() == GL_NO_ERROR);
+    }
+    SpineRender::ResourceCache::releaseSkeletonData(skeletonData);
+    SpineRender::ResourceCache::releaseAtlas(atlas);
+    render.destroy();
+}
+
+#endif //SPINE_TESTS_TESTUTILS_H_
@@ -0,0 +1,83 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include <cmath>
+#include <vector>
+
+#include "SpineController.h"
+#include "TestUtils.h"
+
+void testMipmapUpload() {
+    printf("mipmapped upload\n");
+    std::vector<unsigned char> pixels(8 * 8 * 4, 128);
+    SpineRender::OpenGLImage image;
+    image.width = 8;
+    image.height = 8;
+    image.pixels = pixels.data();
+
+    SpineRender::OpenGLTexture texture;
+    texture.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    texture.magFilter = GL_LINEAR;
+    texture.uWrap = GL_CLAMP_TO_EDGE;
+    texture.vWrap = GL_CLAMP_TO_EDGE;
+
+    // an error the host left pending is still there after the upload
+    glEnable(0xFFFF);
+    CHECK(SpineRender::GLBatchRender::uploadTexture(image, &texture));
+    CHECK(glGetError() == GL_INVALID_ENUM);
+    CHECK(glGetError() == GL_NO_ERROR);
+
+    // the chain takes a third more
+    CHECK(texture.minFilter == GL_LINEAR_MIPMAP_LINEAR);
+    CHECK(texture.byteSize == 256 + 256 / 3);
+    SpineRender::GLBatchRender::releaseTexture(&texture);
+}
+
+// draws the skeleton's setup pose at scale, returns the measured pixels per texel
+static float drawAtScale(spine::SkeletonDrawable &drawable, float scale) {
+    spine::Skeleton *skeleton = drawable.getSkeleton();
+    skeleton->setScaleX(scale);
+    skeleton->setScaleY(scale);
+    skeleton->updateWorldTransform();
+    drawable.draw();
+    return drawable.getScreenScale();
+}
+
+void testAutoTextureLodBias() {
+    printf("texture lod bias from the on-screen scale\n");
+    withTestSkeleton([](TestSkeleton &test) {
+        spine::SkeletonDrawable &drawable = test.drawable;
+
+        // off by default
+        drawAtScale(drawable, 1.0f);
+        CHECK(drawable.getScreenScale() == 0.0f);
+        CHECK(drawable.getAutoTextureLodBias() == 0.0f);
+
+        drawable.setAutoTextureLodBias(1.0f, 2.0f);
+        float fullScale = drawAtScale(drawable, 1.0f);
+        CHECK(fullScale > 0.0f);
+        float fullBias = drawable.getAutoTextureLodBias();
+        CHECK(std::fabs(fullBias - std::min(std::max(std::log2(1.0f / fullScale), 0.0f), 2.0f)) < 1e-4f);
+
+        // a quarter of the size on screen is two mip levels further out
+        float quarterScale = drawAtScale(drawable, 0.25f);
+        CHECK(std::fabs(fullScale / quarterScale - 4.0f) < 0.01f);
+        float quarterBias = std::min(std::max(std::log2(1.0f / quarterScale), 0.0f), 2.0f);
+        CHECK(std::fabs(drawable.getAutoTextureLodBias() - quarterBias) < 1e-4f);
+        CHECK(quarterBias > fullBias);
+
+        // capped at maxBias, mirroring doesn't change the scale
+        drawAtScale(drawable, 0.01f);
+        CHECK(drawable.getAutoTextureLodBias() == 2.0f);
+        CHECK(std::fabs(drawAtScale(drawable, -1.0f) - fullScale) < 1e-3f * fullScale);
+
+        drawable.setAutoTextureLodBias(1.0f, 0.0f);
+        CHECK(drawable.getAutoTextureLodBias() == 0.0f);
+    });
+}
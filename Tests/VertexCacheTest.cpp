@@ -0,0 +1,61 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include "SpineController.h"
+#include "TestUtils.h"
+
+// the region attachment of the first slot showing one
+static spine::RegionAttachment *findRegion(spine::Skeleton *skeleton) {
+    spine::Vector<spine::Slot *> &slots = skeleton->getSlots();
+    for (size_t i = 0; i < slots.size(); i++) {
+        spine::Attachment *attachment = slots[i]->getAttachment();
+        if (attachment && attachment->getRTTI().isExactly(spine::RegionAttachment::rtti)) {
+            return (spine::RegionAttachment *) attachment;
+        }
+    }
+    return nullptr;
+}
+
+void testVertexCacheGeometry() {
+    printf("vertex cache after attachment edits\n");
+    withTestSkeleton([](TestSkeleton &test) {
+        spine::SkeletonDrawable &drawable = test.drawable;
+        drawable.setUseVertexCache(true);
+        spine::Skeleton *skeleton = drawable.getSkeleton();
+        drawable.draw();
+        drawable.draw();
+        CHECK(drawable.getVertexCacheStats().misses == 0);
+        CHECK(drawable.getVertexCacheStats().hits > 0);
+
+        // a region moved within its bone
+        auto *region = findRegion(skeleton);
+        CHECK(region != nullptr);
+        if (region) {
+            float x = region->getX();
+            region->setX(x + 10);
+            region->updateOffset();
+            drawable.draw();
+            CHECK(drawable.getVertexCacheStats().misses == 1);
+            region->setX(x);
+            region->updateOffset();
+            drawable.draw();
+            CHECK(drawable.getVertexCacheStats().misses == 1);
+        }
+
+        // geometry edited in place (mesh vertices or bones), reported by the caller. spineboy has
+        // no meshes, the region stands in for one
+        if (region) {
+            region->geometryChanged();
+        }
+        drawable.draw();
+        CHECK(drawable.getVertexCacheStats().misses == 1);
+        drawable.draw();
+        CHECK(drawable.getVertexCacheStats().misses == 0);
+    });
+}
@@ -0,0 +1,92 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <GLES2/gl2.h>
+
+#include "TestUtils.h"
+
+int failures = 0;
+
+void testCompressedTextureParse();
+void testCompressedTextureTranscode();
+void testAsyncCreate();
+void testAsyncCreateFailure();
+void testDestroyWhileLoading();
+void testMipmapUpload();
+void testAutoTextureLodBias();
+void testAtlasDitherKey();
+void testContextLost();
+void testReleaseOffThread();
+void testRepackerPack();
+void testRepackerCopyRegion();
+void testRepackerRestore();
+void testSwirlShader();
+void testJitterShader();
+void testVertexCacheGeometry();
+
+// GLES 2 context without a window, rendering into an RGBA8 framebuffer with a stencil buffer
+static bool createContext(int width, int height) {
+    auto getPlatformDisplay = (PFNEGLGETPLATFORMDISPLAYEXTPROC) eglGetProcAddress("eglGetPlatformDisplayEXT");
+    EGLDisplay display = getPlatformDisplay
+                         ? getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr)
+                         : eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (!eglInitialize(display, nullptr, nullptr)) {
+        return false;
+    }
+    eglBindAPI(EGL_OPENGL_ES_API);
+    EGLint contextAttribs[] = {EGL_CONTEXT_CLIENT_VERSION, 2, EGL_NONE};
+    EGLContext context = eglCreateContext(display, nullptr, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT || !eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, context)) {
+        return false;
+    }
+
+    GLuint renderbuffers[2];
+    GLuint framebuffer;
+    glGenRenderbuffers(2, renderbuffers);
+    glGenFramebuffers(1, &framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[0]);
+    glRenderbufferStorage(GL_RENDERBUFFER, 0x8058 /* GL_RGBA8_OES */, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, renderbuffers[0]);
+    glBindRenderbuffer(GL_RENDERBUFFER, renderbuffers[1]);
+    glRenderbufferStorage(GL_RENDERBUFFER, 0x88F0 /* GL_DEPTH24_STENCIL8_OES */, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, renderbuffers[1]);
+    glViewport(0, 0, width, height);
+    return glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+}
+
+int main(int argc, char **argv) {
+    testCompressedTextureParse();
+    testCompressedTextureTranscode();
+    testRepackerPack();
+    testRepackerCopyRegion();
+
+    if (!createContext(TEST_WIDTH, TEST_HEIGHT)) {
+        printf("no EGL context, skipping the GL tests\n");
+    } else {
+        testAsyncCreate();
+        testAsyncCreateFailure();
+        testDestroyWhileLoading();
+        testMipmapUpload();
+        testAutoTextureLodBias();
+        testAtlasDitherKey();
+        testContextLost();
+        testReleaseOffThread();
+        testRepackerRestore();
+        testSwirlShader();
+        testJitterShader();
+        testVertexCacheGeometry();
+    }
+
+    printf("\n%d failed checks\n", failures);
+    return failures ? 1 : 0;
+}
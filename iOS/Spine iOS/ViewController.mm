@@ -34,6 +34,7 @@
     [super viewDidLoad];
     
     _glView = [[GLKView alloc] initWithFrame:self.view.bounds context:[[EAGLContext alloc] initWithAPI:kEAGLRenderingAPIOpenGLES2]];
+    _glView.drawableStencilFormat = GLKViewDrawableStencilFormat8;    // stencil clipping
     [self.view addSubview:_glView];
     
     CGSize size = self.view.bounds.size;
@@ -79,6 +80,8 @@
 - (void)dealloc {
     [_displayLink invalidate];
     SAFE_DELETE(_spineCtrl);
+    // the context goes with the view
+    SpineController::spineContextLost();
 }
 
 @end
@@ -0,0 +1,482 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include "AtlasRepacker.h"
+#include "SkeletonDrawable.h"
+#include "utils/Logger.h"
+
+#include <algorithm>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <numeric>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace SpineRender {
+
+struct Box {
+    int x, y, w, h;
+};
+
+static bool contains(const Box &a, const Box &b) {
+    return b.x >= a.x && b.y >= a.y && b.x + b.w <= a.x + a.w && b.y + b.h <= a.y + a.h;
+}
+
+static bool overlaps(const Box &a, const Box &b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// the free space of a page as maximal, possibly overlapping, rectangles
+class MaxRects {
+public:
+    explicit MaxRects(int size) {
+        free_.push_back({0, 0, size, size});
+    }
+
+    // best short side fit, the free rect leaving the smallest leftover on its shorter side
+    bool insert(int w, int h, bool allowRotation, Box *placed, bool *rotated) {
+        int bestShort = INT_MAX;
+        int bestLong = INT_MAX;
+        for (const Box &f : free_) {
+            for (int r = 0; r < (allowRotation ? 2 : 1); r++) {
+                int pw = r ? h : w;
+                int ph = r ? w : h;
+                if (pw > f.w || ph > f.h) {
+                    continue;
+                }
+                int leftShort = std::min(f.w - pw, f.h - ph);
+                int leftLong = std::max(f.w - pw, f.h - ph);
+                if (leftShort < bestShort || (leftShort == bestShort && leftLong < bestLong)) {
+                    bestShort = leftShort;
+                    bestLong = leftLong;
+                    *placed = {f.x, f.y, pw, ph};
+                    *rotated = r != 0;
+                }
+            }
+        }
+        if (bestShort == INT_MAX) {
+            return false;
+        }
+        split(*placed);
+        return true;
+    }
+
+private:
+    void split(const Box &used) {
+        std::vector<Box> next;
+        for (const Box &f : free_) {
+            if (!overlaps(f, used)) {
+                next.push_back(f);
+                continue;
+            }
+            if (used.x > f.x) {
+                next.push_back({f.x, f.y, used.x - f.x, f.h});
+            }
+            if (used.x + used.w < f.x + f.w) {
+                next.push_back({used.x + used.w, f.y, f.x + f.w - used.x - used.w, f.h});
+            }
+            if (used.y > f.y) {
+                next.push_back({f.x, f.y, f.w, used.y - f.y});
+            }
+            if (used.y + used.h < f.y + f.h) {
+                next.push_back({f.x, used.y + used.h, f.w, f.y + f.h - used.y - used.h});
+            }
+        }
+
+        // drop rects inside others, of two equal ones the first is kept
+        free_.clear();
+        for (size_t i = 0; i < next.size(); i++) {
+            bool redundant = false;
+            for (size_t j = 0; j < next.size() && !redundant; j++) {
+                if (i != j && contains(next[j], next[i])) {
+                    redundant = !contains(next[i], next[j]) || j < i;
+                }
+            }
+            if (!redundant) {
+                free_.push_back(next[i]);
+            }
+        }
+    }
+
+    std::vector<Box> free_;
+};
+
+static int nextPowerOfTwo(int v) {
+    int p = 1;
+    while (p < v) {
+        p <<= 1;
+    }
+    return p;
+}
+
+std::vector<AtlasRepacker::PageSize> AtlasRepacker::pack(std::vector<Rect> &rects, const Options &options) {
+    int padding = std::max(0, options.padding);
+    std::vector<size_t> order(rects.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&rects](size_t a, size_t b) {
+        int sideA = std::max(rects[a].width, rects[a].height);
+        int sideB = std::max(rects[b].width, rects[b].height);
+        if (sideA != sideB) {
+            return sideA > sideB;
+        }
+        return rects[a].width * rects[a].height > rects[b].width * rects[b].height;
+    });
+
+    // each rect takes its padding on the right and bottom, which may hang over the page edge
+    int binSize = options.maxPageSize + padding;
+    std::vector<MaxRects> bins;
+    std::vector<PageSize> pages;
+    for (size_t index : order) {
+        Rect &rect = rects[index];
+        rect.page = -1;
+        int w = rect.width + padding;
+        int h = rect.height + padding;
+        if (rect.width <= 0 || rect.height <= 0 || w > binSize || h > binSize) {
+            continue;
+        }
+
+        Box placed = {0, 0, 0, 0};
+        bool rotated = false;
+        for (size_t i = 0; i < bins.size() && rect.page < 0; i++) {
+            if (bins[i].insert(w, h, options.allowRotation, &placed, &rotated)) {
+                rect.page = (int) i;
+            }
+        }
+        if (rect.page < 0) {
+            bins.emplace_back(binSize);
+            pages.emplace_back();
+            bins.back().insert(w, h, options.allowRotation, &placed, &rotated);
+            rect.page = (int) bins.size() - 1;
+        }
+
+        rect.x = placed.x;
+        rect.y = placed.y;
+        rect.rotated = rotated;
+        PageSize &page = pages[rect.page];
+        page.width = std::max(page.width, placed.x + placed.w - padding);
+        page.height = std::max(page.height, placed.y + placed.h - padding);
+    }
+
+    for (PageSize &page : pages) {
+        page.width = std::min(nextPowerOfTwo(page.width), options.maxPageSize);
+        page.height = std::min(nextPowerOfTwo(page.height), options.maxPageSize);
+    }
+    return pages;
+}
+
+// pixel (i, j) of a region is stored at (x + j, y + width - 1 - i) when rotated, the layout
+// MeshAttachment::updateUVs and RegionAttachment::setUVs expect of 90 degree regions
+void AtlasRepacker::copyRegion(const unsigned char *src, int srcStride, int srcX, int srcY, bool srcRotated,
+                               unsigned char *dst, int dstStride, int dstX, int dstY, bool dstRotated,
+                               int width, int height) {
+    if (srcRotated == dstRotated) {
+        int rowBytes = (srcRotated ? height : width) * 4;
+        int rows = srcRotated ? width : height;
+        for (int row = 0; row < rows; row++) {
+            memcpy(dst + (size_t) (dstY + row) * dstStride + dstX * 4,
+                   src + (size_t) (srcY + row) * srcStride + srcX * 4, rowBytes);
+        }
+        return;
+    }
+
+    for (int j = 0; j < height; j++) {
+        for (int i = 0; i < width; i++) {
+            int sx = srcRotated ? srcX + j : srcX + i;
+            int sy = srcRotated ? srcY + width - 1 - i : srcY + j;
+            int dx = dstRotated ? dstX + j : dstX + i;
+            int dy = dstRotated ? dstY + width - 1 - i : dstY + j;
+            memcpy(dst + (size_t) dy * dstStride + dx * 4, src + (size_t) sy * srcStride + sx * 4, 4);
+        }
+    }
+}
+
+static spine::AtlasRegion *attachmentRegion(spine::Attachment *attachment) {
+    if (attachment->getRTTI().isExactly(spine::RegionAttachment::rtti)) {
+        return (spine::AtlasRegion *) ((spine::RegionAttachment *) attachment)->getRendererObject();
+    }
+    if (attachment->getRTTI().isExactly(spine::MeshAttachment::rtti)) {
+        return (spine::AtlasRegion *) ((spine::MeshAttachment *) attachment)->getRendererObject();
+    }
+    return nullptr;
+}
+
+// attachments copied the texture coordinates of their region when they were loaded
+static void updateAttachments(const std::vector<spine::SkeletonData *> &skeletons,
+                              const std::unordered_set<spine::AtlasRegion *> &regions) {
+    for (auto *skeleton : skeletons) {
+        spine::Vector<spine::Skin *> &skins = skeleton->getSkins();
+        for (size_t i = 0; i < skins.size(); i++) {
+            spine::Skin::AttachmentMap::Entries entries = skins[i]->getAttachments();
+            while (entries.hasNext()) {
+                spine::Attachment *attachment = entries.next()._attachment;
+                spine::AtlasRegion *region = attachmentRegion(attachment);
+                if (!region || !regions.count(region)) {
+                    continue;
+                }
+                if (attachment->getRTTI().isExactly(spine::RegionAttachment::rtti)) {
+                    ((spine::RegionAttachment *) attachment)->setUVs(region->u, region->v, region->u2, region->v2, region->rotate);
+                } else {
+                    auto *mesh = (spine::MeshAttachment *) attachment;
+                    mesh->setRegionU(region->u);
+                    mesh->setRegionV(region->v);
+                    mesh->setRegionU2(region->u2);
+                    mesh->setRegionV2(region->v2);
+                    mesh->setRegionRotate(region->rotate);
+                    mesh->setRegionDegrees(region->degrees);
+                    mesh->updateUVs();
+                }
+            }
+        }
+    }
+}
+
+AtlasRepacker::~AtlasRepacker() {
+    if (applied_) {
+        std::unordered_set<spine::AtlasRegion *> restored;
+        for (auto &placement : placed_) {
+            spine::AtlasRegion *region = placement.region;
+            const Source &source = placement.source;
+            region->page = source.page;
+            region->x = source.x;
+            region->y = source.y;
+            region->u = source.u;
+            region->v = source.v;
+            region->u2 = source.u2;
+            region->v2 = source.v2;
+            region->rotate = source.rotate;
+            region->degrees = source.degrees;
+            restored.insert(region);
+        }
+        updateAttachments(skeletons_, restored);
+        for (auto *page : released_) {
+            if (!spine::OpenGLTextureLoader::reload(*page)) {
+                LOG_ERROR("reload source page failed: %s", page->texturePath.buffer());
+            }
+        }
+    }
+
+    for (auto &image : images_) {
+        GLBatchRender::freeImage(&image);
+    }
+    for (auto *page : pages_) {
+        // textures of pages that were never applied don't exist on the GPU yet
+        auto *texture = (OpenGLTexture *) page->getRendererObject();
+        if (texture && texture->textureId != 0) {
+            GLBatchRender::releaseTexture(texture);
+        }
+        delete texture;
+        delete page;
+    }
+}
+
+bool AtlasRepacker::build(const std::vector<spine::Atlas *> &atlases,
+                          const std::vector<spine::SkeletonData *> &skeletons,
+                          const Options &options) {
+    if (!pages_.empty()) {
+        LOG_ERROR("atlases are already repacked");
+        return false;
+    }
+
+    // repeating pages need their own texture
+    std::unordered_map<spine::AtlasPage *, OpenGLImage> sources;
+    for (auto *atlas : atlases) {
+        spine::Vector<spine::AtlasPage *> &pages = atlas->getPages();
+        for (size_t i = 0; i < pages.size(); i++) {
+            if (pages[i]->uWrap == spine::TextureWrap_ClampToEdge && pages[i]->vWrap == spine::TextureWrap_ClampToEdge) {
+                sources[pages[i]] = OpenGLImage();
+            }
+        }
+    }
+
+    std::vector<spine::AtlasRegion *> regions;
+    std::unordered_set<spine::AtlasRegion *> seen;
+    for (auto *skeleton : skeletons) {
+        spine::Vector<spine::Skin *> &skins = skeleton->getSkins();
+        for (size_t i = 0; i < skins.size(); i++) {
+            spine::Skin::AttachmentMap::Entries entries = skins[i]->getAttachments();
+            while (entries.hasNext()) {
+                spine::AtlasRegion *region = attachmentRegion(entries.next()._attachment);
+                if (region && sources.count(region->page) && (region->degrees == 0 || region->degrees == 90)
+                    && seen.insert(region).second) {
+                    regions.push_back(region);
+                }
+            }
+        }
+    }
+
+    // decode the pages in use, the pixels are RGBA8 unless the driver takes their compressed format
+    std::unordered_set<spine::AtlasPage *> failed;
+    std::map<std::pair<unsigned int, unsigned int>, std::vector<spine::AtlasRegion *>> groups;
+    for (auto *region : regions) {
+        spine::AtlasPage *page = region->page;
+        OpenGLImage &image = sources[page];
+        if (!image.pixels && !failed.count(page)) {
+            if (!GLBatchRender::decodeImage(page->texturePath.buffer(), &image) || image.compressedFormat != 0) {
+                GLBatchRender::freeImage(&image);
+                failed.insert(page);
+            }
+        }
+        int storedWidth = region->degrees == 90 ? region->height : region->width;
+        int storedHeight = region->degrees == 90 ? region->width : region->height;
+        auto *texture = (OpenGLTexture *) page->getRendererObject();
+        if (failed.count(page) || !texture || region->x + storedWidth > image.width || region->y + storedHeight > image.height) {
+            continue;
+        }
+        // the pages keep the filters of their regions
+        groups[std::make_pair(texture->minFilter, texture->magFilter)].push_back(region);
+    }
+
+    for (auto &group : groups) {
+        std::vector<Rect> rects(group.second.size());
+        for (size_t i = 0; i < rects.size(); i++) {
+            rects[i].width = group.second[i]->width;
+            rects[i].height = group.second[i]->height;
+        }
+        std::vector<PageSize> sizes = pack(rects, options);
+
+        size_t firstPage = pages_.size();
+        for (const PageSize &size : sizes) {
+            auto *page = new spine::AtlasPage(spine::String("repacked"));
+            page->format = spine::Format_RGBA8888;
+            page->minFilter = group.second[0]->page->minFilter;
+            page->magFilter = group.second[0]->page->magFilter;
+            page->width = size.width;
+            page->height = size.height;
+            pages_.push_back(page);
+
+            // released with freeImage, like the pixels of stb_image
+            OpenGLImage image;
+            image.width = size.width;
+            image.height = size.height;
+            image.pixels = (unsigned char *) calloc((size_t) size.width * size.height, 4);
+            images_.push_back(image);
+
+            auto *texture = new OpenGLTexture();
+            texture->minFilter = group.first.first;
+            texture->magFilter = group.first.second;
+            texture->uWrap = GL_CLAMP_TO_EDGE;
+            texture->vWrap = GL_CLAMP_TO_EDGE;
+            page->setRendererObject(texture);
+        }
+
+        for (size_t i = 0; i < rects.size(); i++) {
+            if (rects[i].page < 0) {
+                continue;
+            }
+            spine::AtlasRegion *region = group.second[i];
+            const OpenGLImage &src = sources[region->page];
+            rects[i].page += (int) firstPage;
+            OpenGLImage &dst = images_[rects[i].page];
+            copyRegion(src.pixels, src.width * 4, region->x, region->y, region->degrees == 90,
+                       dst.pixels, dst.width * 4, rects[i].x, rects[i].y, rects[i].rotated,
+                       region->width, region->height);
+            Source source = {region->page, region->x, region->y, region->u, region->v, region->u2, region->v2,
+                             region->rotate, region->degrees};
+            placed_.push_back({region, rects[i], source});
+        }
+    }
+
+    for (auto &source : sources) {
+        GLBatchRender::freeImage(&source.second);
+    }
+    std::unordered_set<spine::AtlasRegion *> placed;
+    for (auto &placement : placed_) {
+        placed.insert(placement.region);
+    }
+    for (auto *region : regions) {
+        if (!placed.count(region)) {
+            unplaced_.push_back(region);
+        }
+    }
+    releaseSourcePages_ = options.releaseSourcePages;
+
+    atlases_ = atlases;
+    skeletons_ = skeletons;
+    LOG_INFO("repacked %d of %d regions into %d pages", (int) placed_.size(), (int) regions.size(), (int) pages_.size());
+    return !placed_.empty();
+}
+
+bool AtlasRepacker::build(const std::vector<spine::Atlas *> &atlases,
+                          const std::vector<spine::SkeletonData *> &skeletons) {
+    return build(atlases, skeletons, Options());
+}
+
+bool AtlasRepacker::apply() {
+    if (applied_ || placed_.empty()) {
+        return false;
+    }
+
+    // every page goes up before a region moves, a failed upload leaves the atlases as they were
+    for (size_t i = 0; i < pages_.size(); i++) {
+        auto *texture = (OpenGLTexture *) pages_[i]->getRendererObject();
+        if (!GLBatchRender::uploadTexture(images_[i], texture)) {
+            LOG_ERROR("upload repacked page failed");
+            for (size_t j = 0; j < i; j++) {
+                GLBatchRender::releaseTexture((OpenGLTexture *) pages_[j]->getRendererObject());
+            }
+            return false;
+        }
+    }
+    for (auto &image : images_) {
+        GLBatchRender::freeImage(&image);
+    }
+    images_.clear();
+
+    std::unordered_set<spine::AtlasRegion *> moved;
+    std::unordered_set<spine::AtlasPage *> left;
+    for (auto &placement : placed_) {
+        spine::AtlasRegion *region = placement.region;
+        left.insert(region->page);
+        spine::AtlasPage *page = pages_[placement.rect.page];
+        region->page = page;
+        region->x = placement.rect.x;
+        region->y = placement.rect.y;
+        region->rotate = placement.rect.rotated;
+        region->degrees = placement.rect.rotated ? 90 : 0;
+        int storedWidth = region->rotate ? region->height : region->width;
+        int storedHeight = region->rotate ? region->width : region->height;
+        region->u = region->x / (float) page->width;
+        region->v = region->y / (float) page->height;
+        region->u2 = (region->x + storedWidth) / (float) page->width;
+        region->v2 = (region->y + storedHeight) / (float) page->height;
+        moved.insert(region);
+    }
+
+    updateAttachments(skeletons_, moved);
+
+    // the pages only hold GPU memory now, their atlas deletes the objects
+    for (auto *page : left) {
+        bool empty = true;
+        if (releaseSourcePages_) {
+            for (size_t i = 0; i < unplaced_.size() && empty; i++) {
+                empty = unplaced_[i]->page != page;
+            }
+        } else {
+            for (auto *atlas : atlases_) {
+                spine::Vector<spine::AtlasRegion *> &regions = atlas->getRegions();
+                for (size_t i = 0; i < regions.size() && empty; i++) {
+                    empty = regions[i]->page != page;
+                }
+            }
+        }
+        auto *texture = (OpenGLTexture *) page->getRendererObject();
+        if (empty && texture && texture->textureId != 0) {
+            GLBatchRender::releaseTexture(texture);
+            texture->byteSize = 0;
+            released_.push_back(page);
+        }
+    }
+
+    applied_ = true;
+    return true;
+}
+
+}
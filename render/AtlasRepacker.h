@@ -0,0 +1,118 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#ifndef SPINE_RENDER_ATLASREPACKER_H_
+#define SPINE_RENDER_ATLASREPACKER_H_
+
+#include <spine/spine.h>
+#include <vector>
+
+#include "GLBatchRender.h"
+
+namespace SpineRender {
+
+// Moves the regions a set of skeletons uses out of their own atlas pages into shared RGBA8 pages,
+// so characters of different atlases draw from the same texture. Opt in, e.g. once a scene's
+// characters are loaded. build() only uses the CPU and may run on a loader thread, apply() uploads
+// the pages on the GL thread and points the regions and attachments at them.
+class AtlasRepacker {
+public:
+    struct Options {
+        int maxPageSize = 2048;
+        int padding = 2;            // transparent pixels between regions
+        bool allowRotation = true;  // store regions rotated by 90 degrees when they fit better
+        // delete the textures of source pages once the regions the skeletons use moved off them,
+        // every skeleton drawn from the atlases must be passed to build then. the destructor
+        // uploads them again
+        bool releaseSourcePages = true;
+    };
+
+    struct Rect {
+        int width = 0;              // size of the region as drawn
+        int height = 0;
+        // placement, written by pack
+        int x = 0;
+        int y = 0;
+        int page = -1;              // -1 if the rect doesn't fit in a page
+        bool rotated = false;
+    };
+
+    struct PageSize {
+        int width = 0;
+        int height = 0;
+    };
+
+    // maxrects (best short side fit) packing of rects, largest first. pages are shrunk to the
+    // power of two that holds their rects
+    static std::vector<PageSize> pack(std::vector<Rect> &rects, const Options &options);
+
+    // copies width x height pixels of an RGBA8 image between two placements. a rotated placement
+    // stores the region as spine's 90 degree atlas regions, height x width pixels
+    static void copyRegion(const unsigned char *src, int srcStride, int srcX, int srcY, bool srcRotated,
+                           unsigned char *dst, int dstStride, int dstX, int dstY, bool dstRotated,
+                           int width, int height);
+
+    AtlasRepacker() = default;
+    // GL thread. moves the regions back to their own pages, uploads the source pages apply released
+    // again and deletes the repacked pages, so atlases kept in the ResourceCache draw as before.
+    // the atlases and skeleton data passed to build must still exist, delete it before releasing them
+    ~AtlasRepacker();
+
+    // packs the regions used by the attachments of skeletons. regions of compressed or repeating
+    // pages, and regions larger than a page, are left where they are
+    bool build(const std::vector<spine::Atlas *> &atlases,
+               const std::vector<spine::SkeletonData *> &skeletons,
+               const Options &options);
+    bool build(const std::vector<spine::Atlas *> &atlases,
+               const std::vector<spine::SkeletonData *> &skeletons);
+    // uploads the pages, moves the regions and releases the source pages they left. if an upload
+    // fails nothing is moved
+    bool apply();
+
+    const std::vector<spine::AtlasPage *> &getPages() const {
+        return pages_;
+    }
+    size_t getRegionCount() const {
+        return placed_.size();
+    }
+
+private:
+    // where a region was on its own page
+    struct Source {
+        spine::AtlasPage *page;
+        int x;
+        int y;
+        float u;
+        float v;
+        float u2;
+        float v2;
+        bool rotate;
+        int degrees;
+    };
+
+    struct Placement {
+        spine::AtlasRegion *region;
+        Rect rect;
+        Source source;
+    };
+
+    std::vector<spine::SkeletonData *> skeletons_;
+    std::vector<spine::Atlas *> atlases_;
+    std::vector<Placement> placed_;
+    std::vector<spine::AtlasRegion *> unplaced_;    // used by the skeletons, not moved
+    bool releaseSourcePages_ = true;
+    std::vector<spine::AtlasPage *> pages_;
+    std::vector<OpenGLImage> images_;   // pixels of pages_, until apply
+    std::vector<spine::AtlasPage *> released_;  // source pages apply deleted the textures of
+    bool applied_ = false;
+};
+
+}
+
+#endif //SPINE_RENDER_ATLASREPACKER_H_
@@ -0,0 +1,548 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include "CompressedTexture.h"
+
+#include <cstdint>
+#include <cstring>
+
+namespace SpineRender {
+
+static const unsigned char KTX1_ID[12] = {0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+static const unsigned char KTX2_ID[12] = {0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n'};
+
+#define KTX1_HEADER_SIZE    64
+#define KTX2_HEADER_SIZE    80
+#define PKM_HEADER_SIZE     16
+
+struct BlockFormat {
+    unsigned int glFormat;
+    int blockWidth;
+    int blockHeight;
+    int blockBytes;
+};
+
+static const BlockFormat blockFormats[] = {
+    {GL_ETC1_RGB8_OES, 4, 4, 8},
+    {GL_COMPRESSED_RGB8_ETC2, 4, 4, 8},
+    {GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2, 4, 4, 8},
+    {GL_COMPRESSED_RGBA8_ETC2_EAC, 4, 4, 16},
+    {GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 4, 4, 8},
+    {GL_COMPRESSED_RGBA_S3TC_DXT1_EXT, 4, 4, 8},
+    {GL_COMPRESSED_RGBA_S3TC_DXT3_EXT, 4, 4, 16},
+    {GL_COMPRESSED_RGBA_S3TC_DXT5_EXT, 4, 4, 16},
+    {0x93B0, 4, 4, 16}, {0x93B1, 5, 4, 16}, {0x93B2, 5, 5, 16}, {0x93B3, 6, 5, 16},
+    {0x93B4, 6, 6, 16}, {0x93B5, 8, 5, 16}, {0x93B6, 8, 6, 16}, {0x93B7, 8, 8, 16},
+    {0x93B8, 10, 5, 16}, {0x93B9, 10, 6, 16}, {0x93BA, 10, 8, 16}, {0x93BB, 10, 10, 16},
+    {0x93BC, 12, 10, 16}, {0x93BD, 12, 12, 16},
+};
+
+static const BlockFormat *findBlockFormat(unsigned int glFormat) {
+    for (auto &format : blockFormats) {
+        if (format.glFormat == glFormat) {
+            return &format;
+        }
+    }
+    return nullptr;
+}
+
+// KTX2 stores vulkan formats
+static unsigned int vkFormatToGL(uint32_t vkFormat) {
+    switch (vkFormat) {
+        case 131: return GL_COMPRESSED_RGB_S3TC_DXT1_EXT;       // BC1_RGB_UNORM
+        case 133: return GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;      // BC1_RGBA_UNORM
+        case 135: return GL_COMPRESSED_RGBA_S3TC_DXT3_EXT;      // BC2_UNORM
+        case 137: return GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;      // BC3_UNORM
+        case 147: return GL_COMPRESSED_RGB8_ETC2;               // ETC2_R8G8B8_UNORM
+        case 149: return GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+        case 151: return GL_COMPRESSED_RGBA8_ETC2_EAC;
+        default:
+            // ASTC_4x4_UNORM .. ASTC_12x12_UNORM, every other value is the SRGB variant
+            if (vkFormat >= 157 && vkFormat <= 183 && (vkFormat - 157) % 2 == 0) {
+                return GL_COMPRESSED_RGBA_ASTC_4x4_KHR + (vkFormat - 157) / 2;
+            }
+            return 0;
+    }
+}
+
+static uint32_t readU32(const unsigned char *p, bool swap) {
+    uint32_t v = (uint32_t) p[0] | ((uint32_t) p[1] << 8) | ((uint32_t) p[2] << 16) | ((uint32_t) p[3] << 24);
+    if (swap) {
+        v = (v >> 24) | ((v >> 8) & 0xFF00) | ((v << 8) & 0xFF0000) | (v << 24);
+    }
+    return v;
+}
+
+static uint64_t readU64(const unsigned char *p) {
+    return (uint64_t) readU32(p, false) | ((uint64_t) readU32(p + 4, false) << 32);
+}
+
+static int readU16BE(const unsigned char *p) {
+    return (p[0] << 8) | p[1];
+}
+
+static bool fail(std::string *error, const char *message) {
+    if (error) {
+        *error = message;
+    }
+    return false;
+}
+
+// check the level fits in the file and fill image
+static bool setLevel(const unsigned char *data, size_t length, size_t offset, size_t levelLength,
+                     unsigned int format, uint32_t width, uint32_t height, OpenGLImage *image, std::string *error) {
+    if (width == 0 || height == 0 || width > 16384 || height > 16384) {
+        return fail(error, "invalid texture size");
+    }
+    size_t expected = CompressedTexture::levelSize(format, (int) width, (int) height);
+    if (expected == 0) {
+        return fail(error, "unsupported texture format");
+    }
+    if (levelLength < expected || offset > length || length - offset < expected) {
+        return fail(error, "texture data truncated");
+    }
+
+    image->width = (int) width;
+    image->height = (int) height;
+    image->pixels = (unsigned char *) data + offset;
+    image->compressedFormat = format;
+    image->dataSize = expected;
+    return true;
+}
+
+static bool parseKTX1(const unsigned char *data, size_t length, OpenGLImage *image, std::string *error) {
+    if (length < KTX1_HEADER_SIZE) {
+        return fail(error, "ktx header truncated");
+    }
+    uint32_t endianness = readU32(data + 12, false);
+    if (endianness != 0x04030201 && endianness != 0x01020304) {
+        return fail(error, "invalid ktx endianness");
+    }
+    bool swap = endianness == 0x01020304;
+    uint32_t glType = readU32(data + 16, swap);
+    uint32_t glInternalFormat = readU32(data + 28, swap);
+    uint32_t width = readU32(data + 36, swap);
+    uint32_t height = readU32(data + 40, swap);
+    uint32_t depth = readU32(data + 44, swap);
+    uint32_t faces = readU32(data + 52, swap);
+    uint32_t keyValueBytes = readU32(data + 60, swap);
+    if (glType != 0) {
+        return fail(error, "uncompressed ktx is not supported");
+    }
+    if (depth > 1 || faces > 1) {
+        return fail(error, "only 2d ktx textures are supported");
+    }
+
+    // compared before adding, the sum wraps size_t on 32 bit
+    if (keyValueBytes > length - KTX1_HEADER_SIZE || length - KTX1_HEADER_SIZE - keyValueBytes < 4) {
+        return fail(error, "ktx data truncated");
+    }
+    size_t offset = (size_t) KTX1_HEADER_SIZE + keyValueBytes;
+    uint32_t imageSize = readU32(data + offset, swap);
+    return setLevel(data, length, offset + 4, imageSize, glInternalFormat, width, height, image, error);
+}
+
+static bool parseKTX2(const unsigned char *data, size_t length, OpenGLImage *image, std::string *error) {
+    // header, index and the first entry of the level index
+    if (length < KTX2_HEADER_SIZE + 24) {
+        return fail(error, "ktx2 header truncated");
+    }
+    uint32_t vkFormat = readU32(data + 12, false);
+    uint32_t width = readU32(data + 20, false);
+    uint32_t height = readU32(data + 24, false);
+    uint32_t depth = readU32(data + 28, false);
+    uint32_t faces = readU32(data + 36, false);
+    uint32_t supercompression = readU32(data + 44, false);
+    if (supercompression != 0) {
+        return fail(error, "supercompressed ktx2 is not supported");
+    }
+    if (depth > 1 || faces > 1) {
+        return fail(error, "only 2d ktx2 textures are supported");
+    }
+    unsigned int format = vkFormatToGL(vkFormat);
+    if (format == 0) {
+        return fail(error, "unsupported ktx2 format");
+    }
+
+    uint64_t levelOffset = readU64(data + KTX2_HEADER_SIZE);
+    uint64_t levelLength = readU64(data + KTX2_HEADER_SIZE + 8);
+    if (levelOffset > length) {
+        return fail(error, "ktx2 data truncated");
+    }
+    // clamped before the cast, 64 bit lengths would be truncated on 32 bit
+    if (levelLength > length) {
+        levelLength = length;
+    }
+    return setLevel(data, length, (size_t) levelOffset, (size_t) levelLength, format, width, height, image, error);
+}
+
+static bool parsePKM(const unsigned char *data, size_t length, OpenGLImage *image, std::string *error) {
+    if (length < PKM_HEADER_SIZE) {
+        return fail(error, "pkm header truncated");
+    }
+    unsigned int format;
+    int type = readU16BE(data + 6);
+    if (data[4] == '1') {
+        format = GL_ETC1_RGB8_OES;
+    } else if (type == 1) {
+        format = GL_COMPRESSED_RGB8_ETC2;
+    } else if (type == 3) {
+        format = GL_COMPRESSED_RGBA8_ETC2_EAC;
+    } else if (type == 4) {
+        format = GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2;
+    } else {
+        return fail(error, "unsupported pkm format");
+    }
+    // the data is padded to whole blocks, the texture keeps the original size
+    uint32_t width = (uint32_t) readU16BE(data + 12);
+    uint32_t height = (uint32_t) readU16BE(data + 14);
+    return setLevel(data, length, PKM_HEADER_SIZE, length - PKM_HEADER_SIZE, format, width, height, image, error);
+}
+
+bool CompressedTexture::isContainer(const char *data, size_t length) {
+    if (length >= 12 && (memcmp(data, KTX1_ID, 12) == 0 || memcmp(data, KTX2_ID, 12) == 0)) {
+        return true;
+    }
+    return length >= 6 && memcmp(data, "PKM ", 4) == 0 && (data[4] == '1' || data[4] == '2') && data[5] == '0';
+}
+
+bool CompressedTexture::parse(const char *data, size_t length, OpenGLImage *image, std::string *error) {
+    auto *bytes = (const unsigned char *) data;
+    if (length >= 12 && memcmp(bytes, KTX1_ID, 12) == 0) {
+        return parseKTX1(bytes, length, image, error);
+    }
+    if (length >= 12 && memcmp(bytes, KTX2_ID, 12) == 0) {
+        return parseKTX2(bytes, length, image, error);
+    }
+    if (isContainer(data, length)) {
+        return parsePKM(bytes, length, image, error);
+    }
+    return fail(error, "not a ktx or pkm file");
+}
+
+size_t CompressedTexture::levelSize(unsigned int format, int width, int height) {
+    const BlockFormat *block = findBlockFormat(format);
+    if (!block || width <= 0 || height <= 0) {
+        return 0;
+    }
+    size_t blocksX = (size_t) (width + block->blockWidth - 1) / block->blockWidth;
+    size_t blocksY = (size_t) (height + block->blockHeight - 1) / block->blockHeight;
+    return blocksX * blocksY * block->blockBytes;
+}
+
+bool CompressedTexture::canTranscode(unsigned int format) {
+    switch (format) {
+        case GL_ETC1_RGB8_OES:
+        case GL_COMPRESSED_RGB8_ETC2:
+        case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+        case GL_COMPRESSED_RGBA8_ETC2_EAC:
+        case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+        case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// ETC1 / ETC2, 64 bit big endian blocks
+
+static const int etcModifiers[8][2] = {
+    {2, 8}, {5, 17}, {9, 29}, {13, 42}, {18, 60}, {24, 80}, {33, 106}, {47, 183}
+};
+
+static const int etcDistances[8] = {3, 6, 11, 16, 23, 32, 41, 64};
+
+static const int eacModifiers[16][8] = {
+    {-3, -6, -9, -15, 2, 5, 8, 14}, {-3, -7, -10, -13, 2, 6, 9, 12},
+    {-2, -5, -8, -13, 1, 4, 7, 12}, {-2, -4, -6, -13, 1, 3, 5, 12},
+    {-3, -6, -8, -12, 2, 5, 7, 11}, {-3, -7, -9, -11, 2, 6, 8, 10},
+    {-4, -7, -8, -11, 3, 6, 7, 10}, {-3, -5, -8, -11, 2, 4, 7, 10},
+    {-2, -6, -8, -10, 1, 5, 7, 9}, {-2, -5, -8, -10, 1, 4, 7, 9},
+    {-2, -4, -8, -10, 1, 3, 7, 9}, {-2, -5, -7, -10, 1, 4, 6, 9},
+    {-3, -4, -7, -10, 2, 3, 6, 9}, {-1, -2, -3, -10, 0, 1, 2, 9},
+    {-4, -6, -8, -9, 3, 5, 7, 8}, {-3, -5, -7, -9, 2, 4, 6, 8}
+};
+
+static inline unsigned char clamp255(int v) {
+    return (unsigned char) (v < 0 ? 0 : (v > 255 ? 255 : v));
+}
+
+static inline uint64_t readBlockBE(const unsigned char *p) {
+    uint64_t v = 0;
+    for (int i = 0; i < 8; i++) {
+        v = (v << 8) | p[i];
+    }
+    return v;
+}
+
+static inline int bits(uint64_t v, int high, int low) {
+    return (int) ((v >> low) & ((1ull << (high - low + 1)) - 1));
+}
+
+static inline int extend4(int v) { return (v << 4) | v; }
+static inline int extend5(int v) { return (v << 3) | (v >> 2); }
+static inline int extend6(int v) { return (v << 2) | (v >> 4); }
+static inline int extend7(int v) { return (v << 1) | (v >> 6); }
+
+// writes the 4x4 texels as rgba, alpha 255. punchthrough selects the ETC2 RGB8A1 semantics
+static void decodeETC2Block(const unsigned char *block, unsigned char out[16][4], bool punchthrough) {
+    uint64_t v = readBlockBE(block);
+    bool diff = bits(v, 33, 33) != 0;
+    bool flip = bits(v, 32, 32) != 0;
+    // in punchthrough blocks the diff bit says "opaque" and individual mode doesn't exist
+    bool opaque = !punchthrough || diff;
+    if (punchthrough) {
+        diff = true;
+    }
+
+    auto pixelIndex = [v](int k) {
+        return (bits(v, k + 16, k + 16) << 1) | bits(v, k, k);
+    };
+
+    int base[2][3];
+    if (!diff) {
+        base[0][0] = extend4(bits(v, 63, 60));
+        base[1][0] = extend4(bits(v, 59, 56));
+        base[0][1] = extend4(bits(v, 55, 52));
+        base[1][1] = extend4(bits(v, 51, 48));
+        base[0][2] = extend4(bits(v, 47, 44));
+        base[1][2] = extend4(bits(v, 43, 40));
+    } else {
+        int r = bits(v, 63, 59), g = bits(v, 55, 51), b = bits(v, 47, 43);
+        int dr = bits(v, 58, 56), dg = bits(v, 50, 48), db = bits(v, 42, 40);
+        dr = dr >= 4 ? dr - 8 : dr;
+        dg = dg >= 4 ? dg - 8 : dg;
+        db = db >= 4 ? db - 8 : db;
+
+        if (r + dr < 0 || r + dr > 31) {
+            // T mode
+            int c[2][3] = {
+                {extend4((bits(v, 60, 59) << 2) | bits(v, 57, 56)), extend4(bits(v, 55, 52)), extend4(bits(v, 51, 48))},
+                {extend4(bits(v, 47, 44)), extend4(bits(v, 43, 40)), extend4(bits(v, 39, 36))}
+            };
+            int d = etcDistances[(bits(v, 35, 34) << 1) | bits(v, 32, 32)];
+            int paint[4][3];
+            for (int ch = 0; ch < 3; ch++) {
+                paint[0][ch] = c[0][ch];
+                paint[1][ch] = clamp255(c[1][ch] + d);
+                paint[2][ch] = c[1][ch];
+                paint[3][ch] = clamp255(c[1][ch] - d);
+            }
+            for (int k = 0; k < 16; k++) {
+                int idx = pixelIndex(k);
+                unsigned char *px = out[(k & 3) * 4 + (k >> 2)];
+                bool transparent = !opaque && idx == 2;
+                for (int ch = 0; ch < 3; ch++) px[ch] = transparent ? 0 : (unsigned char) paint[idx][ch];
+                px[3] = transparent ? 0 : 255;
+            }
+            return;
+        }
+        if (g + dg < 0 || g + dg > 31) {
+            // H mode
+            int c[2][3] = {
+                {extend4(bits(v, 62, 59)), extend4((bits(v, 58, 56) << 1) | bits(v, 52, 52)),
+                 extend4((bits(v, 51, 51) << 3) | bits(v, 49, 47))},
+                {extend4(bits(v, 46, 43)), extend4(bits(v, 42, 39)), extend4(bits(v, 38, 35))}
+            };
+            int value0 = (c[0][0] << 16) | (c[0][1] << 8) | c[0][2];
+            int value1 = (c[1][0] << 16) | (c[1][1] << 8) | c[1][2];
+            int d = etcDistances[(bits(v, 34, 34) << 2) | (bits(v, 32, 32) << 1) | (value0 >= value1 ? 1 : 0)];
+            int paint[4][3];
+            for (int ch = 0; ch < 3; ch++) {
+                paint[0][ch] = clamp255(c[0][ch] + d);
+                paint[1][ch] = clamp255(c[0][ch] - d);
+                paint[2][ch] = clamp255(c[1][ch] + d);
+                paint[3][ch] = clamp255(c[1][ch] - d);
+            }
+            for (int k = 0; k < 16; k++) {
+                int idx = pixelIndex(k);
+                unsigned char *px = out[(k & 3) * 4 + (k >> 2)];
+                bool transparent = !opaque && idx == 2;
+                for (int ch = 0; ch < 3; ch++) px[ch] = transparent ? 0 : (unsigned char) paint[idx][ch];
+                px[3] = transparent ? 0 : 255;
+            }
+            return;
+        }
+        if (b + db < 0 || b + db > 31) {
+            // planar mode, always opaque
+            int o[3] = {extend6(bits(v, 62, 57)),
+                        extend7((bits(v, 56, 56) << 6) | bits(v, 54, 49)),
+                        extend6((bits(v, 48, 48) << 5) | (bits(v, 44, 43) << 3) | bits(v, 41, 39))};
+            int h[3] = {extend6((bits(v, 38, 34) << 1) | bits(v, 32, 32)), extend7(bits(v, 31, 25)), extend6(bits(v, 24, 19))};
+            int vv[3] = {extend6(bits(v, 18, 13)), extend7(bits(v, 12, 6)), extend6(bits(v, 5, 0))};
+            for (int y = 0; y < 4; y++) {
+                for (int x = 0; x < 4; x++) {
+                    unsigned char *px = out[y * 4 + x];
+                    for (int ch = 0; ch < 3; ch++) {
+                        px[ch] = clamp255((x * (h[ch] - o[ch]) + y * (vv[ch] - o[ch]) + 4 * o[ch] + 2) >> 2);
+                    }
+                    px[3] = 255;
+                }
+            }
+            return;
+        }
+
+        base[0][0] = extend5(r);
+        base[1][0] = extend5(r + dr);
+        base[0][1] = extend5(g);
+        base[1][1] = extend5(g + dg);
+        base[0][2] = extend5(b);
+        base[1][2] = extend5(b + db);
+    }
+
+    int table[2] = {bits(v, 39, 37), bits(v, 36, 34)};
+    for (int k = 0; k < 16; k++) {
+        int x = k >> 2, y = k & 3;
+        int sub = flip ? (y >= 2) : (x >= 2);
+        int idx = pixelIndex(k);
+        unsigned char *px = out[y * 4 + x];
+        if (!opaque && idx == 2) {
+            px[0] = px[1] = px[2] = px[3] = 0;
+            continue;
+        }
+        int modifier;
+        if (!opaque) {
+            // non opaque punchthrough blocks drop the +-a modifiers, index 0 is the base color
+            int m = etcModifiers[table[sub]][1];
+            modifier = idx == 1 ? m : (idx == 3 ? -m : 0);
+        } else {
+            int m = etcModifiers[table[sub]][idx & 1];
+            modifier = (idx & 2) ? -m : m;
+        }
+        for (int ch = 0; ch < 3; ch++) {
+            px[ch] = clamp255(base[sub][ch] + modifier);
+        }
+        px[3] = 255;
+    }
+}
+
+static void decodeEACAlpha(const unsigned char *block, unsigned char out[16][4]) {
+    uint64_t v = readBlockBE(block);
+    int base = bits(v, 63, 56);
+    int multiplier = bits(v, 55, 52);
+    const int *modifiers = eacModifiers[bits(v, 51, 48)];
+    for (int k = 0; k < 16; k++) {
+        int idx = bits(v, 47 - k * 3, 45 - k * 3);
+        out[(k & 3) * 4 + (k >> 2)][3] = clamp255(base + modifiers[idx] * multiplier);
+    }
+}
+
+// S3TC, little endian blocks, texels in row order
+
+static void decodeColor565(int c, int rgb[3]) {
+    rgb[0] = extend5((c >> 11) & 31);
+    rgb[1] = extend6((c >> 5) & 63);
+    rgb[2] = extend5(c & 31);
+}
+
+static void decodeBC1Block(const unsigned char *block, unsigned char out[16][4], bool alwaysFourColors) {
+    int c0 = block[0] | (block[1] << 8);
+    int c1 = block[2] | (block[3] << 8);
+    int palette[4][4];
+    decodeColor565(c0, palette[0]);
+    decodeColor565(c1, palette[1]);
+    palette[0][3] = palette[1][3] = palette[2][3] = palette[3][3] = 255;
+    for (int ch = 0; ch < 3; ch++) {
+        if (c0 > c1 || alwaysFourColors) {
+            palette[2][ch] = (2 * palette[0][ch] + palette[1][ch]) / 3;
+            palette[3][ch] = (palette[0][ch] + 2 * palette[1][ch]) / 3;
+        } else {
+            palette[2][ch] = (palette[0][ch] + palette[1][ch]) / 2;
+            palette[3][ch] = 0;
+        }
+    }
+    if (!(c0 > c1 || alwaysFourColors)) {
+        palette[3][3] = 0;
+    }
+    uint32_t indices = readU32(block + 4, false);
+    for (int k = 0; k < 16; k++) {
+        const int *color = palette[(indices >> (k * 2)) & 3];
+        for (int ch = 0; ch < 4; ch++) {
+            out[k][ch] = (unsigned char) color[ch];
+        }
+    }
+}
+
+static void decodeBC3Alpha(const unsigned char *block, unsigned char out[16][4]) {
+    int a[8] = {block[0], block[1]};
+    if (a[0] > a[1]) {
+        for (int i = 1; i <= 6; i++) a[i + 1] = ((7 - i) * a[0] + i * a[1]) / 7;
+    } else {
+        for (int i = 1; i <= 4; i++) a[i + 1] = ((5 - i) * a[0] + i * a[1]) / 5;
+        a[6] = 0;
+        a[7] = 255;
+    }
+    uint64_t indices = 0;
+    for (int i = 5; i >= 0; i--) {
+        indices = (indices << 8) | block[2 + i];
+    }
+    for (int k = 0; k < 16; k++) {
+        out[k][3] = (unsigned char) a[(indices >> (k * 3)) & 7];
+    }
+}
+
+bool CompressedTexture::transcode(const OpenGLImage &image, unsigned char *rgba) {
+    const BlockFormat *block = findBlockFormat(image.compressedFormat);
+    if (!block || !canTranscode(image.compressedFormat) || !image.pixels) {
+        return false;
+    }
+
+    int blocksX = (image.width + 3) / 4;
+    int blocksY = (image.height + 3) / 4;
+    const unsigned char *src = image.pixels;
+    unsigned char texels[16][4];
+    for (int by = 0; by < blocksY; by++) {
+        for (int bx = 0; bx < blocksX; bx++, src += block->blockBytes) {
+            switch (image.compressedFormat) {
+                case GL_ETC1_RGB8_OES:
+                case GL_COMPRESSED_RGB8_ETC2:
+                    decodeETC2Block(src, texels, false);
+                    break;
+                case GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2:
+                    decodeETC2Block(src, texels, true);
+                    break;
+                case GL_COMPRESSED_RGBA8_ETC2_EAC:
+                    decodeETC2Block(src + 8, texels, false);
+                    decodeEACAlpha(src, texels);
+                    break;
+                case GL_COMPRESSED_RGB_S3TC_DXT1_EXT:
+                    decodeBC1Block(src, texels, false);
+                    for (auto &texel : texels) texel[3] = 255;
+                    break;
+                case GL_COMPRESSED_RGBA_S3TC_DXT1_EXT:
+                    decodeBC1Block(src, texels, false);
+                    break;
+                case GL_COMPRESSED_RGBA_S3TC_DXT3_EXT:
+                    decodeBC1Block(src + 8, texels, true);
+                    for (int k = 0; k < 16; k++) {
+                        texels[k][3] = (unsigned char) extend4((src[k / 2] >> ((k & 1) * 4)) & 15);
+                    }
+                    break;
+                case GL_COMPRESSED_RGBA_S3TC_DXT5_EXT:
+                    decodeBC1Block(src + 8, texels, true);
+                    decodeBC3Alpha(src, texels);
+                    break;
+                default:
+                    return false;
+            }
+
+            // clip the edge blocks
+            for (int y = 0; y < 4 && by * 4 + y < image.height; y++) {
+                for (int x = 0; x < 4 && bx * 4 + x < image.width; x++) {
+                    memcpy(rgba + ((size_t) (by * 4 + y) * image.width + bx * 4 + x) * 4, texels[y * 4 + x], 4);
+                }
+            }
+        }
+    }
+    return true;
+}
+
+}
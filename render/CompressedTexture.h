@@ -0,0 +1,78 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#ifndef SPINE_RENDER_COMPRESSEDTEXTURE_H_
+#define SPINE_RENDER_COMPRESSEDTEXTURE_H_
+
+#include <cstddef>
+#include <string>
+
+#include "GLBatchRender.h"
+
+// not every gl header declares these
+#ifndef GL_ETC1_RGB8_OES
+#define GL_ETC1_RGB8_OES                            0x8D64
+#endif
+#ifndef GL_COMPRESSED_RGB8_ETC2
+#define GL_COMPRESSED_RGB8_ETC2                     0x9274
+#endif
+#ifndef GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2
+#define GL_COMPRESSED_RGB8_PUNCHTHROUGH_ALPHA1_ETC2 0x9276
+#endif
+#ifndef GL_COMPRESSED_RGBA8_ETC2_EAC
+#define GL_COMPRESSED_RGBA8_ETC2_EAC                0x9278
+#endif
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT             0x83F0
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT1_EXT            0x83F1
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT3_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT3_EXT            0x83F2
+#endif
+#ifndef GL_COMPRESSED_RGBA_S3TC_DXT5_EXT
+#define GL_COMPRESSED_RGBA_S3TC_DXT5_EXT            0x83F3
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_4x4_KHR
+#define GL_COMPRESSED_RGBA_ASTC_4x4_KHR             0x93B0
+#endif
+#ifndef GL_COMPRESSED_RGBA_ASTC_12x12_KHR
+#define GL_COMPRESSED_RGBA_ASTC_12x12_KHR           0x93BD
+#endif
+
+namespace SpineRender {
+
+// KTX, KTX2 and PKM containers of ETC1/ETC2, S3TC (DXT) and ASTC pages.
+// Parsing and transcoding don't touch GL, so they run on the loader threads.
+class CompressedTexture {
+public:
+    // true if data starts with a KTX, KTX2 or PKM identifier
+    static bool isContainer(const char *data, size_t length);
+
+    // reads the first mip level of the container, image->pixels points into data.
+    // fails with a message on malformed files and unknown or supercompressed formats
+    static bool parse(const char *data, size_t length, OpenGLImage *image, std::string *error);
+
+    // bytes of a width x height level in format, 0 for an unknown format
+    static size_t levelSize(unsigned int format, int width, int height);
+
+    // the CPU fallback for drivers without the format, ASTC has none
+    static bool canTranscode(unsigned int format);
+
+    // decodes image into width * height * 4 bytes of rgba, alpha is kept as stored.
+    // unlike decoded pngs the result is not premultiplied: drivers that take the format sample the
+    // blocks as stored, so the fallback matches them and a page looks the same on every device.
+    // export compressed pages premultiplied to draw them with usePMA
+    static bool transcode(const OpenGLImage &image, unsigned char *rgba);
+};
+
+}
+
+#endif //SPINE_RENDER_COMPRESSEDTEXTURE_H_
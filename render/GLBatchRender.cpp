@@ -8,7 +8,12 @@
  */
 
 #include "GLBatchRender.h"
+#include "TextureCache.h"
+#include "GLStateCache.h"
+#include "CompressedTexture.h"
 #include "utils/Logger.h"
+#include "utils/Premultiply.h"
+#include "utils/PixelConvert.h"
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "utils/stb_image.h"
@@ -16,6 +21,13 @@
 #include <spine/SpineString.h>
 #include <spine/Extension.h>
 
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <vector>
+
 namespace SpineRender {
 
 #define CHECK_GL_ERROR(tag)   {                         \
@@ -24,6 +36,43 @@ namespace SpineRender {
         LOG_ERROR("%s, glGetError: %d", tag, err);      \
     }}                                                  \
 
+// apple's CgBI pngs start with a CgBI chunk, their pixels are premultiplied
+static bool isIphonePng(const char *data, int length) {
+    return length > 16 && memcmp(data + 12, "CgBI", 4) == 0;
+}
+
+static std::mutex compressedFormatsMutex;
+static std::vector<GLint> compressedFormats;
+
+static void queryCompressedFormats() {
+    GLint count = 0;
+    glGetIntegerv(GL_NUM_COMPRESSED_TEXTURE_FORMATS, &count);
+    std::vector<GLint> formats((size_t) std::max(count, 0));
+    if (count > 0) {
+        glGetIntegerv(GL_COMPRESSED_TEXTURE_FORMATS, formats.data());
+    }
+
+    std::lock_guard<std::mutex> lock(compressedFormatsMutex);
+    compressedFormats = formats;
+}
+
+// ES2 only mipmaps power of two textures, glGenerateMipmap fails on the others
+static std::atomic<bool> npotMipmaps(false);
+
+static void queryNpotMipmaps() {
+    auto *version = (const char *) glGetString(GL_VERSION);
+    if (!version) {
+        return;
+    }
+    if (strncmp(version, "OpenGL ES 2.", 12) != 0) {
+        npotMipmaps = true;
+        return;
+    }
+    // only asked on ES2, core profiles of desktop GL reject GL_EXTENSIONS here
+    auto *extensions = (const char *) glGetString(GL_EXTENSIONS);
+    npotMipmaps = extensions && strstr(extensions, "GL_OES_texture_npot");
+}
+
 static void getShaderCompileError(GLuint shader) {
     GLint infoLen = 0;
     glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &infoLen);
@@ -46,42 +95,160 @@ static void getShaderLinkError(GLuint program) {
     }
 }
 
+// bound to the same locations in every program, so switching programs keeps the vertex attributes
+#define ATTRIB_POS 0
+#define ATTRIB_COLOR 1
+#define ATTRIB_TEXCOORD 2
+#define ATTRIB_PAGE 3
+#define ATTRIB_DARK 4
+
+// the effects run on the skeleton coordinates, before the projection. jitter hashes the
+// position, so vertices shared by two attachments move together and seams stay closed
+static const char *vertex_shader =
+    "attribute vec2 aPos;\n"
+    "attribute vec4 aColor;\n"
+    "attribute vec2 aTexCoord;\n"
+    "attribute float aPage;\n"
+    "varying vec4 ourColor;\n"
+    "varying vec2 vTexCoord;\n"
+    "varying float vPage;\n"
+    "uniform vec2 ourSize;\n"
+    "#ifdef TWO_COLOR\n"
+    "attribute vec4 aDark;\n"
+    "varying vec4 vDark;\n"
+    "#endif\n"
+    "#ifdef SWIRL\n"
+    "uniform vec4 swirl;\n"    // center, radius, angle
+    "uniform float swirlCurve[SWIRL_CURVE_SAMPLES];\n"
+    "#endif\n"
+    "#ifdef JITTER\n"
+    "uniform vec3 jitter;\n"   // x, y, seed
+    "float hash(vec2 p) {"
+    "  vec3 p3 = fract(p.xyx * 0.1031);"
+    "  p3 += dot(p3, p3.yzx + 33.33);"
+    "  return fract((p3.x + p3.y) * p3.z);"
+    "}\n"
+    "#endif\n"
+    "void main() {"
+    "  vec2 pos = aPos;\n"
+    "#ifdef SWIRL\n"
+    "  vec2 d = pos - swirl.xy;"
+    "  float dist = length(d);"
+    "  if (dist < swirl.z) {"
+    "    float f = (swirl.z - dist) / swirl.z * float(SWIRL_CURVE_SAMPLES - 1);"
+    "    int i = int(min(f, float(SWIRL_CURVE_SAMPLES - 2)));"
+    "    float theta = swirl.w * mix(swirlCurve[i], swirlCurve[i + 1], f - float(i));"
+    "    float c = cos(theta), s = sin(theta);"
+    "    pos = vec2(c * d.x - s * d.y, s * d.x + c * d.y) + swirl.xy;"
+    "  }\n"
+    "#endif\n"
+    "#ifdef JITTER\n"
+    "  vec2 p = aPos + jitter.z;"
+    "  vec4 r = vec4(hash(p), hash(p + 17.0), hash(p + 31.0), hash(p + 53.0));"
+    "  pos += (r.xz + r.yw - 1.0) * jitter.xy;\n"
+    "#endif\n"
+    "  gl_Position = vec4((pos.x-ourSize.x/2.0)/ourSize.x, (ourSize.y/2.0-pos.y)/ourSize.y, 0.0, 1.0);"
+    "  ourColor = aColor;"
+    "  vTexCoord = aTexCoord;"
+    "  vPage = aPage;\n"
+    "#ifdef TWO_COLOR\n"
+    "  vDark = aDark;\n"
+    "#endif\n"
+    "}";
+
+// GLSL ES 1.0 only indexes samplers with constants. vPage is the same on all vertices of a
+// triangle, so the branches don't diverge within a pixel quad and mip selection stays valid.
+// two color tinting maps texture black to the dark color and white to the light one
+static const char *fragment_shader =
+    "precision mediump float;\n"
+    "varying vec4 ourColor;\n"
+    "varying vec2 vTexCoord;\n"
+    "varying float vPage;\n"
+    "uniform sampler2D ourTexture[4];\n"
+    "uniform float lodBias;\n"
+    "#ifdef TWO_COLOR\n"
+    "varying vec4 vDark;\n"
+    "#endif\n"
+    "void main() {"
+    "  vec4 texColor;"
+    "  if (vPage < 0.5) texColor = texture2D(ourTexture[0], vTexCoord, lodBias);"
+    "  else if (vPage < 1.5) texColor = texture2D(ourTexture[1], vTexCoord, lodBias);"
+    "  else if (vPage < 2.5) texColor = texture2D(ourTexture[2], vTexCoord, lodBias);"
+    "  else texColor = texture2D(ourTexture[3], vTexCoord, lodBias);\n"
+    "#ifdef TWO_COLOR\n"
+    "  gl_FragColor.a = texColor.a * ourColor.a;"
+    "  gl_FragColor.rgb = ((texColor.a - 1.0) * vDark.a + 1.0 - texColor.rgb) * vDark.rgb + texColor.rgb * ourColor.rgb;\n"
+    "#else\n"
+    "  gl_FragColor = ourColor * texColor;\n"
+    "#endif\n"
+    "}";
+static_assert(MAX_BATCH_TEXTURES == 4, "the fragment shader samples 4 textures");
+
 bool GLBatchRender::initGL() {
     if (inited_) {
         return true;
     }
     inited_ = true;
+    // the renderer may come with a new context, whose state nothing has seen yet
+    GLStateCache::invalidate();
+
+    // effect variants are linked when first drawn
+    if (!createProgram(0, &programs_[0])) {
+        return false;
+    }
+
+    // fewer units than the shader declares are only found on pre ES2 hardware
+    GLint maxUnits = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_IMAGE_UNITS, &maxUnits);
+    setMaxTextures(maxUnits);
+
+    queryCompressedFormats();
+    queryNpotMipmaps();
+
+    // bound in place of textures whose upload hasn't finished yet, see TextureUploader::process
+    static unsigned char transparent[4] = {0, 0, 0, 0};
+    OpenGLImage placeholder;
+    placeholder.width = 1;
+    placeholder.height = 1;
+    placeholder.pixels = transparent;
+    placeholderTexture_ = createTexture(placeholder);
+
+#ifdef SPINE_MAC
+    glGenVertexArrays(1, &vao_);
+    GLStateCache::bindVertexArray(vao_);
+#endif
+
+    glGenBuffers(1, &darkVbo_);
+    glGenBuffers(1, &ibo_);
+    glGenBuffers(1, &vbo_);
+    GLStateCache::bindArrayBuffer(vbo_);
+    setVertexAttribs();
+
+    CHECK_GL_ERROR("create gl buffer")
 
-    const char *vertex_shader =
-        "#version 100\n"
-        "attribute vec2 aPos;\n"
-        "attribute vec4 aColor;\n"
-        "attribute vec2 aTexCoord;\n"
-        "varying vec4 ourColor;\n"
-        "varying vec2 vTexCoord;\n"
-        "uniform vec2 ourSize;\n"
-        "void main() {"
-        "  gl_Position = vec4((aPos.x-ourSize.x/2.0)/ourSize.x, (ourSize.y/2.0-aPos.y)/ourSize.y, 0.0, 1.0);"
-        "  ourColor = aColor;"
-        "  vTexCoord = aTexCoord;"
-        "}";
-
-    const char *fragment_shader =
-        "#version 100\n"
-        "precision mediump float;\n"
-        "varying vec4 ourColor;\n"
-        "varying vec2 vTexCoord;\n"
-        "uniform sampler2D ourTexture;\n"
-        "void main() {"
-        "  gl_FragColor = ourColor * texture2D(ourTexture, vTexCoord);"
-        "}";
+    return true;
+}
+
+bool GLBatchRender::createProgram(int variant, ShaderProgram *program) {
+    std::string defines = "#version 100\n#define SWIRL_CURVE_SAMPLES " + std::to_string(SWIRL_CURVE_SAMPLES) + "\n";
+    if (variant & SHADER_EFFECT_JITTER) {
+        defines += "#define JITTER\n";
+    }
+    if (variant & SHADER_EFFECT_SWIRL) {
+        defines += "#define SWIRL\n";
+    }
+    if (variant & SHADER_TWO_COLOR) {
+        defines += "#define TWO_COLOR\n";
+    }
+    const char *vertexSources[2] = {defines.c_str(), vertex_shader};
+    const char *fragmentSources[2] = {defines.c_str(), fragment_shader};
 
     GLuint vs = glCreateShader(GL_VERTEX_SHADER);
     if (!vs) {
         LOG_ERROR("create shader vs error");
         return false;
     }
-    glShaderSource(vs, 1, &vertex_shader, nullptr);
+    glShaderSource(vs, 2, vertexSources, nullptr);
     glCompileShader(vs);
 
     GLint compiled;
@@ -89,81 +256,112 @@ bool GLBatchRender::initGL() {
     if (!compiled) {
         LOG_ERROR("compile shader vs error");
         getShaderCompileError(vs);
+        glDeleteShader(vs);
         return false;
     }
 
     GLuint fs = glCreateShader(GL_FRAGMENT_SHADER);
     if (!fs) {
         LOG_ERROR("create shader fs error");
+        glDeleteShader(vs);
         return false;
     }
 
-    glShaderSource(fs, 1, &fragment_shader, nullptr);
+    glShaderSource(fs, 2, fragmentSources, nullptr);
     glCompileShader(fs);
 
     glGetShaderiv(fs, GL_COMPILE_STATUS, &compiled);
     if (!compiled) {
         LOG_ERROR("compile shader fs error");
         getShaderCompileError(fs);
+        glDeleteShader(vs);
+        glDeleteShader(fs);
         return false;
     }
 
-    shaderProgram_ = glCreateProgram();
-    if (!shaderProgram_) {
+    GLuint shaderProgram = glCreateProgram();
+    if (!shaderProgram) {
         LOG_ERROR("create shader program error");
+        glDeleteShader(vs);
+        glDeleteShader(fs);
         return false;
     }
 
-    glAttachShader(shaderProgram_, fs);
-    glAttachShader(shaderProgram_, vs);
-    glLinkProgram(shaderProgram_);
+    glAttachShader(shaderProgram, fs);
+    glAttachShader(shaderProgram, vs);
+    glBindAttribLocation(shaderProgram, ATTRIB_POS, "aPos");
+    glBindAttribLocation(shaderProgram, ATTRIB_COLOR, "aColor");
+    glBindAttribLocation(shaderProgram, ATTRIB_TEXCOORD, "aTexCoord");
+    glBindAttribLocation(shaderProgram, ATTRIB_PAGE, "aPage");
+    glBindAttribLocation(shaderProgram, ATTRIB_DARK, "aDark");
+    glLinkProgram(shaderProgram);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
 
     GLint linked;
-    glGetProgramiv(shaderProgram_, GL_LINK_STATUS, &linked);
+    glGetProgramiv(shaderProgram, GL_LINK_STATUS, &linked);
     if (!linked) {
         LOG_ERROR("link shader error: %d", linked);
-        getShaderLinkError(shaderProgram_);
+        getShaderLinkError(shaderProgram);
+        glDeleteProgram(shaderProgram);
         return false;
     }
 
     CHECK_GL_ERROR("link shader")
 
-    glUseProgram(shaderProgram_);
+    GLStateCache::useProgram(shaderProgram);
 
-    texLoc_ = glGetUniformLocation(shaderProgram_, "ourTexture");
-    glUniform1i(texLoc_, 0);
+    GLint units[MAX_BATCH_TEXTURES];
+    for (int i = 0; i < MAX_BATCH_TEXTURES; i++) {
+        units[i] = i;
+    }
+    glUniform1iv(glGetUniformLocation(shaderProgram, "ourTexture"), MAX_BATCH_TEXTURES, units);
+    glUniform2f(glGetUniformLocation(shaderProgram, "ourSize"), (GLfloat) width_, (GLfloat) height_);
 
-    GLuint sizeLoc = glGetUniformLocation(shaderProgram_, "ourSize");
-    glUniform2f(sizeLoc, (GLfloat) width_, (GLfloat) height_);
-
-    glDeleteShader(vs);
-    glDeleteShader(fs);
+    program->program = shaderProgram;
+    program->lodBiasLoc = glGetUniformLocation(shaderProgram, "lodBias");
+    program->lodBias = 0.0f;
+    glUniform1f(program->lodBiasLoc, 0.0f);
+    program->jitterLoc = glGetUniformLocation(shaderProgram, "jitter");
+    program->swirlLoc = glGetUniformLocation(shaderProgram, "swirl");
+    program->swirlCurveLoc = glGetUniformLocation(shaderProgram, "swirlCurve");
 
     CHECK_GL_ERROR("set shader uniform")
 
-#ifdef SPINE_MAC
-    glGenVertexArrays(1, &vao_);
-    glBindVertexArray(vao_);
-#endif
-
-    glGenBuffers(1, &vbo_);
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-
-    GLuint posSlot = glGetAttribLocation(shaderProgram_, "aPos");
-    GLuint colorSlot = glGetAttribLocation(shaderProgram_, "aColor");
-    GLuint texCoordSlot = glGetAttribLocation(shaderProgram_, "aTexCoord");
-
-    glEnableVertexAttribArray(posSlot);
-    glEnableVertexAttribArray(colorSlot);
-    glEnableVertexAttribArray(texCoordSlot);
+    return true;
+}
 
-    glVertexAttribPointer(posSlot, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) nullptr);
-    glVertexAttribPointer(colorSlot, 4, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) (2 * sizeof(float)));
-    glVertexAttribPointer(texCoordSlot, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *) (6 * sizeof(float)));
+GLBatchRender::ShaderProgram *GLBatchRender::useProgram(int variant) {
+    variant &= SHADER_VARIANTS - 1;
+    ShaderProgram *program = &programs_[variant];
+    if (program->program == 0 && !program->failed && !createProgram(variant, program)) {
+        // logged once, the batches draw without the effect
+        program->failed = true;
+    }
+    if (program->failed) {
+        program = &programs_[0];
+    }
+    GLStateCache::useProgram(program->program);
+    return program;
+}
 
-    CHECK_GL_ERROR("create gl buffer")
+// the pointers refer to the buffer bound when they are set. without a vertex array object they are
+// global state, set them again whenever another GLBatchRender's buffer was bound in between
+void GLBatchRender::setVertexAttribs() {
+    GLsizei stride = sizeof(OpenGLVertex);
+    glEnableVertexAttribArray(ATTRIB_POS);
+    glEnableVertexAttribArray(ATTRIB_COLOR);
+    glEnableVertexAttribArray(ATTRIB_TEXCOORD);
+    glEnableVertexAttribArray(ATTRIB_PAGE);
+
+    glVertexAttribPointer(ATTRIB_POS, 2, GL_FLOAT, GL_FALSE, stride, (void *) offsetof(OpenGLVertex, x));
+    glVertexAttribPointer(ATTRIB_COLOR, 4, GL_FLOAT, GL_FALSE, stride, (void *) offsetof(OpenGLVertex, r));
+    glVertexAttribPointer(ATTRIB_TEXCOORD, 2, GL_FLOAT, GL_FALSE, stride, (void *) offsetof(OpenGLVertex, u));
+    glVertexAttribPointer(ATTRIB_PAGE, 1, GL_FLOAT, GL_FALSE, stride, (void *) offsetof(OpenGLVertex, page));
+}
 
-    return true;
+void GLBatchRender::setMaxTextures(int count) {
+    maxTextures_ = std::max(1, std::min(count, MAX_BATCH_TEXTURES));
 }
 
 bool GLBatchRender::create(int width, int height) {
@@ -173,48 +371,137 @@ bool GLBatchRender::create(int width, int height) {
     return initGL();
 }
 
-void GLBatchRender::draw(OpenGLVertex *vertices, int vertexCnt, OpenGLRenderState *state) {
+void GLBatchRender::draw(OpenGLVertex *vertices, int vertexCnt, const unsigned short *indices, int indexCnt,
+                         OpenGLRenderState *state, const OpenGLDarkColor *darkColors) {
     if (!inited_) {
         return;
     }
-    if (vertices == nullptr || vertexCnt <= 0 || state == nullptr) {
+    if (vertices == nullptr || vertexCnt <= 0 || indices == nullptr || indexCnt <= 0 || state == nullptr) {
         return;
     }
 
     // draw
-    glUseProgram(shaderProgram_);
+    const OpenGLVertexEffect &effect = state->effect;
+    ShaderProgram *program = useProgram(effect.flags | (darkColors != nullptr ? SHADER_TWO_COLOR : 0));
+    GLStateCache::blendFunc(state->blendSrc, state->blendDst);
+    GLStateCache::stencilTest(state->stencilClip);
+
+    // uniforms belong to the program, every GLBatchRender has its own
+    if (program->lodBias != state->lodBias) {
+        glUniform1f(program->lodBiasLoc, state->lodBias);
+        program->lodBias = state->lodBias;
+    }
+    if (program->jitterLoc >= 0) {
+        glUniform3f(program->jitterLoc, effect.jitterX, effect.jitterY, effect.jitterSeed);
+    }
+    if (program->swirlLoc >= 0) {
+        glUniform4f(program->swirlLoc, effect.swirlX, effect.swirlY, effect.swirlRadius, effect.swirlAngle);
+        glUniform1fv(program->swirlCurveLoc, SWIRL_CURVE_SAMPLES, effect.swirlCurve);
+    }
+
+    for (int i = 0; i < state->textureCount && i < MAX_BATCH_TEXTURES; i++) {
+        // filters and wrapping were set on the texture object by finishTexture.
+        // a page still uploading draws transparent rather than with whatever the unit held
+        GLuint textureId = state->textures[i].textureId;
+        GLStateCache::bindTexture(i, textureId != 0 ? textureId : placeholderTexture_);
+    }
 
-    if (currState_.blendSrc != state->blendSrc || currState_.blendDst != state->blendDst) {
-        glEnable(GL_BLEND);
-        glBlendFunc(state->blendSrc, state->blendDst);
+    drawTriangles(vertices, vertexCnt, indices, indexCnt, darkColors);
 
-        currState_.blendSrc = state->blendSrc;
-        currState_.blendDst = state->blendDst;
+#if DEBUG
+    CHECK_GL_ERROR("draw");
+#endif
+}
+
+// the dark colors come from a buffer of their own, so batches without them upload no more than before.
+// their attribute is only enabled for the draw, the single color programs don't read it
+void GLBatchRender::drawTriangles(const OpenGLVertex *vertices, int vertexCnt, const unsigned short *indices, int indexCnt,
+                                  const OpenGLDarkColor *darkColors) {
+#ifdef SPINE_MAC
+    GLStateCache::bindVertexArray(vao_);
+#endif
+    if (darkColors != nullptr) {
+        GLStateCache::bindArrayBuffer(darkVbo_);
+        glBufferData(GL_ARRAY_BUFFER, vertexCnt * sizeof(OpenGLDarkColor), darkColors, GL_STATIC_DRAW);
+        glVertexAttribPointer(ATTRIB_DARK, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(OpenGLDarkColor), (void *) 0);
+        glEnableVertexAttribArray(ATTRIB_DARK);
     }
+#ifdef SPINE_MAC
+    GLStateCache::bindArrayBuffer(vbo_);
+#else
+    if (GLStateCache::bindArrayBuffer(vbo_)) {
+        setVertexAttribs();
+    }
+#endif
 
-    if (state->texture.textureId != 0 && currState_.texture.textureId != state->texture.textureId) {
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, state->texture.textureId);
+    glBufferData(GL_ARRAY_BUFFER, vertexCnt * sizeof(OpenGLVertex), vertices, GL_STATIC_DRAW);
 
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, state->texture.uWrap);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, state->texture.vWrap);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, state->texture.minFilter);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, state->texture.magFilter);
+    if (indices != nullptr) {
+        // the element binding is part of the vertex array object on the Mac and global on GLES2, where
+        // another renderer may have bound its own. binding it again is cheaper than tracking both
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ibo_);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCnt * sizeof(unsigned short), indices, GL_STATIC_DRAW);
+        glDrawElements(GL_TRIANGLES, indexCnt, GL_UNSIGNED_SHORT, (void *) 0);
+    } else {
+        glDrawArrays(GL_TRIANGLES, 0, vertexCnt);
+    }
+    drawCalls_++;
 
-        currState_.texture = state->texture;
+    if (darkColors != nullptr) {
+        glDisableVertexAttribArray(ATTRIB_DARK);
     }
+}
 
+// asked on the first draw, a view's framebuffer may not exist yet when the renderer is created
+bool GLBatchRender::hasStencil() {
+    if (stencilBits_ < 0) {
 #ifdef SPINE_MAC
-    glBindVertexArray(vao_);
+        glGetFramebufferAttachmentParameteriv(GL_DRAW_FRAMEBUFFER, GL_STENCIL, GL_FRAMEBUFFER_ATTACHMENT_STENCIL_SIZE, &stencilBits_);
+#else
+        glGetIntegerv(GL_STENCIL_BITS, &stencilBits_);
 #endif
+    }
+    return stencilBits_ > 0;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, vbo_);
-    glBufferData(GL_ARRAY_BUFFER, vertexCnt * sizeof(OpenGLVertex), vertices, GL_STATIC_DRAW);
+// bit 0 of the stencil buffer holds the mask. it is cleared first, then a fan from the first
+// vertex inverts it: pixels covered an odd number of times are inside, concave polygons included
+void GLBatchRender::drawClipMask(const float *polygon, int vertexCount) {
+    if (!inited_ || !hasStencil() || vertexCount < 3) {
+        return;
+    }
 
-    glDrawArrays(GL_TRIANGLES, 0, vertexCnt);
+    maskVertices_.clear();
+    for (int i = 1; i + 1 < vertexCount; i++) {
+        for (int j : {0, i, i + 1}) {
+            // only the position is drawn, the other attributes are zeroed rather than left
+            // uninitialized (the page index picks the sampler)
+            OpenGLVertex vertex = {};
+            vertex.x = polygon[j * 2];
+            vertex.y = polygon[j * 2 + 1];
+            maskVertices_.push_back(vertex);
+        }
+    }
+
+    useProgram(0);
+    GLStateCache::stencilTest(true);
+    glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    glStencilMask(0x01);
+    glClearStencil(0);
+    glClear(GL_STENCIL_BUFFER_BIT);
+
+    glStencilFunc(GL_ALWAYS, 0, 0x01);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_INVERT);
+    drawTriangles(maskVertices_.data(), (int) maskVertices_.size(), nullptr, 0, nullptr);
+
+    // what draws with stencilClip test against
+    glStencilMask(0xFF);
+    glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    glStencilFunc(GL_EQUAL, 1, 0x01);
+    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 
 #if DEBUG
-    CHECK_GL_ERROR("draw");
+    CHECK_GL_ERROR("draw clip mask");
 #endif
 }
 
@@ -223,54 +510,206 @@ void GLBatchRender::destroy() {
         inited_ = false;
 
 #ifdef SPINE_MAC
-        glDeleteVertexArrays(1, &vao_);
+        GLStateCache::deleteVertexArray(vao_);
 #endif
-        glDeleteBuffers(1, &vbo_);
-        glDeleteProgram(shaderProgram_);
+        GLStateCache::deleteBuffer(vbo_);
+        GLStateCache::deleteBuffer(ibo_);
+        GLStateCache::deleteBuffer(darkVbo_);
+        GLStateCache::deleteTexture(placeholderTexture_);
+        for (ShaderProgram &program : programs_) {
+            if (program.program != 0) {
+                GLStateCache::deleteProgram(program.program);
+            }
+            program = ShaderProgram();
+        }
     }
 }
 
 
-bool GLBatchRender::createTexture(const char *path, OpenGLTexture *texture) {
+// upload the compressed level as is when the driver takes it, otherwise transcode to RGBA8
+static bool decodeCompressedImage(const char *path, const char *data, int length, OpenGLImage *image) {
+    OpenGLImage level;
+    std::string error;
+    if (!CompressedTexture::parse(data, (size_t) length, &level, &error)) {
+        LOG_ERROR("Failed to load %s - %s", path, error.c_str());
+        return false;
+    }
+
+    if (GLBatchRender::isCompressedFormatSupported(level.compressedFormat)) {
+        // pixels point into the mapped file, keep a copy
+        auto *copy = new unsigned char[level.dataSize];
+        memcpy(copy, level.pixels, level.dataSize);
+        *image = level;
+        image->pixels = copy;
+        return true;
+    }
+
+    if (TextureCache::load(path, data, length, image)) {
+        return true;
+    }
+    if (!CompressedTexture::canTranscode(level.compressedFormat)) {
+        LOG_ERROR("Failed to load %s - format 0x%x is not supported by the driver", path, level.compressedFormat);
+        return false;
+    }
+    // not premultiplied, like the level the driver would have sampled (see CompressedTexture::transcode)
+    auto *rgba = (unsigned char *) STBI_MALLOC((size_t) level.width * level.height * 4);
+    if (!rgba || !CompressedTexture::transcode(level, rgba)) {
+        LOG_ERROR("Failed to transcode %s", path);
+        STBI_FREE(rgba);
+        return false;
+    }
+
+    image->width = level.width;
+    image->height = level.height;
+    image->pixels = rgba;
+    TextureCache::store(path, data, length, *image);
+    return true;
+}
+
+bool GLBatchRender::createTexture(const char *path, OpenGLTexture *texture,
+                                  unsigned int glFormat, unsigned int glType, bool dither) {
+    OpenGLImage image;
+    if (!decodeImage(path, &image)) {
+        return false;
+    }
+    convertImage(&image, glFormat, glType, dither);
+    uploadTexture(image, texture);
+
+    freeImage(&image);
+    return true;
+}
+
+bool GLBatchRender::decodeImage(const char *path, OpenGLImage *image) {
+    // stb_image keeps these flags in globals, set them once before any concurrent decode.
+    // iphone pngs are stored premultiplied, keep them that way instead of a round trip
+    static std::once_flag stbFlags;
+    std::call_once(stbFlags, [] {
+        stbi_set_unpremultiply_on_load(0);
+        stbi_convert_iphone_png_to_rgb(1);
+    });
+
     int w, h, n;
-    unsigned char *buffer;
-    stbi_set_unpremultiply_on_load(1);
-    stbi_convert_iphone_png_to_rgb(1);
+    unsigned char *buffer = nullptr;
+    bool premultiplied = false;
 
     // read file using spine extension
     const spine::String sPath(path);
     int fileLen = 0;
-    char *fileContent = spine::SpineExtension::readFile(sPath, &fileLen);
+    const char *fileContent = spine::SpineExtension::mapFile(sPath, &fileLen);
+    if (fileContent && CompressedTexture::isContainer(fileContent, (size_t) fileLen)) {
+        bool ok = decodeCompressedImage(path, fileContent, fileLen, image);
+        spine::SpineExtension::unmapFile(fileContent, fileLen);
+        return ok;
+    }
+
     if (fileContent) {
-        buffer = stbi_load_from_memory((stbi_uc *)fileContent, fileLen, &w, &h, &n, 4);
-        spine::SpineExtension::free(fileContent, __FILE__, __LINE__);
+        if (TextureCache::load(path, fileContent, fileLen, image)) {
+            spine::SpineExtension::unmapFile(fileContent, fileLen);
+            return true;
+        }
+        premultiplied = isIphonePng(fileContent, fileLen);
+        buffer = stbi_load_from_memory((const stbi_uc *)fileContent, fileLen, &w, &h, &n, 4);
     }
 
     if (buffer == nullptr) {
         LOG_ERROR("Failed to load - %s\n", stbi_failure_reason());
+        if (fileContent) {
+            spine::SpineExtension::unmapFile(fileContent, fileLen);
+        }
         return false;
     }
 
     // premultiply alpha
-    if (n == 4) {
-        for (int i = 0; i < w * h * 4; i += 4) {
-            float alpha = buffer[i + 3] / 255.0f;
-            buffer[i] *= alpha;
-            buffer[i + 1] *= alpha;
-            buffer[i + 2] *= alpha;
-        }
+    if (n == 4 && !premultiplied) {
+        premultiplyAlpha(buffer, (size_t) w * h);
     }
 
-    texture->textureId = createTexture(w, h, buffer);
-    texture->width = w;
-    texture->height = h;
+    image->width = w;
+    image->height = h;
+    image->pixels = buffer;
 
-    stbi_image_free(buffer);
+    TextureCache::store(path, fileContent, fileLen, *image);
+    spine::SpineExtension::unmapFile(fileContent, fileLen);
     return true;
 }
+
+bool GLBatchRender::convertImage(OpenGLImage *image, unsigned int glFormat, unsigned int glType, bool dither) {
+    if (glFormat == image->glFormat && glType == image->glType) {
+        return true;
+    }
+    // compressed pages keep their format
+    if (image->compressedFormat != 0 || image->glFormat != GL_RGBA || image->glType != GL_UNSIGNED_BYTE) {
+        return false;
+    }
+
+    int w = image->width;
+    int h = image->height;
+    unsigned char *converted;
+    if (glFormat == GL_RGBA && glType == GL_UNSIGNED_SHORT_4_4_4_4) {
+        converted = (unsigned char *) STBI_MALLOC((size_t) w * h * 2);
+        convertToRGBA4444(image->pixels, w, h, dither, (uint16_t *) converted);
+    } else if (glFormat == GL_RGB && glType == GL_UNSIGNED_SHORT_5_6_5) {
+        converted = (unsigned char *) STBI_MALLOC((size_t) w * h * 2);
+        convertToRGB565(image->pixels, w, h, dither, (uint16_t *) converted);
+    } else if (glFormat == GL_RGB && glType == GL_UNSIGNED_BYTE) {
+        converted = (unsigned char *) STBI_MALLOC((size_t) w * h * 3);
+        convertToRGB888(image->pixels, (size_t) w * h, converted);
+    } else {
+        LOG_ERROR("unsupported texture format 0x%x/0x%x", glFormat, glType);
+        return false;
+    }
+
+    freeImage(image);
+    image->pixels = converted;
+    image->glFormat = glFormat;
+    image->glType = glType;
+    return true;
+}
+
+size_t GLBatchRender::imageByteSize(const OpenGLImage &image) {
+    if (image.compressedFormat != 0) {
+        return image.dataSize;
+    }
+    size_t pixelBytes = image.glType != GL_UNSIGNED_BYTE ? 2 : (image.glFormat == GL_RGB ? 3 : 4);
+    return (size_t) image.width * image.height * pixelBytes;
+}
+
+bool GLBatchRender::readImageSize(const char *path, int *width, int *height) {
+    const spine::String sPath(path);
+    int fileLen = 0;
+    const char *fileContent = spine::SpineExtension::mapFile(sPath, &fileLen);
+    if (!fileContent) {
+        return false;
+    }
+    bool ok;
+    if (CompressedTexture::isContainer(fileContent, (size_t) fileLen)) {
+        OpenGLImage level;
+        ok = CompressedTexture::parse(fileContent, (size_t) fileLen, &level, nullptr);
+        *width = level.width;
+        *height = level.height;
+    } else {
+        int n;
+        ok = stbi_info_from_memory((const stbi_uc *)fileContent, fileLen, width, height, &n) != 0;
+    }
+    spine::SpineExtension::unmapFile(fileContent, fileLen);
+    return ok;
+}
+
+void GLBatchRender::freeImage(OpenGLImage *image) {
+    if (image && image->mapped) {
+        TextureCache::unmap(image);
+    } else if (image && image->compressedFormat != 0) {
+        SAFE_DELETE_ARRAY(image->pixels)
+    } else if (image && image->pixels) {
+        stbi_image_free(image->pixels);
+        image->pixels = nullptr;
+    }
+}
+
 void GLBatchRender::releaseTexture(OpenGLTexture *texture) {
-    if (texture) {
-        glDeleteTextures(1, &texture->textureId);
+    // textures abandoned with a lost context have no name left, don't call GL for them
+    if (texture && texture->textureId != 0) {
+        GLStateCache::deleteTexture(texture->textureId);
         texture->textureId = 0;
     }
 }
@@ -298,4 +737,129 @@ unsigned int GLBatchRender::createTexture(int width, int height, unsigned char *
     return 0;
 }
 
+// pixels may be null to only allocate the storage of image
+static GLuint genTexture(const OpenGLImage &image, const unsigned char *pixels) {
+    GLint currTextureId = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &currTextureId);
+
+    GLuint texId;
+    glGenTextures(1, &texId);
+    glBindTexture(GL_TEXTURE_2D, texId);
+    if (image.compressedFormat != 0) {
+        glCompressedTexImage2D(GL_TEXTURE_2D, 0, image.compressedFormat, image.width, image.height, 0,
+                               (GLsizei) image.dataSize, pixels);
+    } else if (image.glFormat == GL_RGB && image.glType == GL_UNSIGNED_BYTE) {
+        // rows of 3 byte pixels aren't 4 byte aligned
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, image.width, image.height, 0, GL_RGB, GL_UNSIGNED_BYTE, pixels);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    } else {
+        glTexImage2D(GL_TEXTURE_2D, 0, image.glFormat, image.width, image.height, 0, image.glFormat, image.glType, pixels);
+    }
+
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    glBindTexture(GL_TEXTURE_2D, currTextureId);
+#if DEBUG
+    CHECK_GL_ERROR("texture upload")
+#endif
+    return texId;
+}
+
+unsigned int GLBatchRender::createTexture(const OpenGLImage &image) {
+    if (image.width <= 0 || image.height <= 0 || image.pixels == nullptr) {
+        LOG_ERROR("createTexture failed");
+        return 0;
+    }
+    return genTexture(image, image.pixels);
+}
+
+static bool isMipmapFilter(unsigned int filter) {
+    return filter == GL_NEAREST_MIPMAP_NEAREST || filter == GL_LINEAR_MIPMAP_NEAREST
+           || filter == GL_NEAREST_MIPMAP_LINEAR || filter == GL_LINEAR_MIPMAP_LINEAR;
+}
+
+// on the bound texture
+static void generateMipmap(const OpenGLImage &image, OpenGLTexture *texture) {
+    // the pixels are premultiplied, so the box filter of glGenerateMipmap doesn't darken edges.
+    // compressed pages, and non power of two pages on ES2, fall back to sampling the base level.
+    // decided up front, checking glGetError would take the host's pending errors too
+    bool powerOfTwo = (image.width & (image.width - 1)) == 0 && (image.height & (image.height - 1)) == 0;
+    bool mipmapped = image.compressedFormat == 0 && (powerOfTwo || npotMipmaps);
+    if (mipmapped) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    if (mipmapped) {
+        texture->byteSize += texture->byteSize / 3;
+    } else {
+        bool nearest = texture->minFilter == GL_NEAREST_MIPMAP_NEAREST || texture->minFilter == GL_NEAREST_MIPMAP_LINEAR;
+        texture->minFilter = nearest ? GL_NEAREST : GL_LINEAR;
+        LOG_WARNING("no mipmaps for a %dx%d texture, using filter 0x%x", image.width, image.height, texture->minFilter);
+    }
+}
+
+unsigned int GLBatchRender::allocTexture(const OpenGLImage &image) {
+    // compressed images have no sub image upload on ES2
+    if (image.width <= 0 || image.height <= 0 || image.compressedFormat != 0) {
+        LOG_ERROR("allocTexture failed");
+        return 0;
+    }
+    return genTexture(image, nullptr);
+}
+
+void GLBatchRender::uploadTextureRows(unsigned int textureId, const OpenGLImage &image, int y, int rows) {
+    size_t rowBytes = imageByteSize(image) / image.height;
+
+    GLint currTextureId = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &currTextureId);
+    glBindTexture(GL_TEXTURE_2D, textureId);
+    if (rowBytes % 4 != 0) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    }
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, y, image.width, rows, image.glFormat, image.glType,
+                    image.pixels + rowBytes * y);
+    if (rowBytes % 4 != 0) {
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    }
+    glBindTexture(GL_TEXTURE_2D, currTextureId);
+}
+
+bool GLBatchRender::uploadTexture(const OpenGLImage &image, OpenGLTexture *texture) {
+    return finishTexture(image, createTexture(image), texture);
+}
+
+bool GLBatchRender::finishTexture(const OpenGLImage &image, unsigned int textureId, OpenGLTexture *texture) {
+    texture->textureId = textureId;
+    texture->width = image.width;
+    texture->height = image.height;
+    texture->byteSize = imageByteSize(image);
+    if (texture->textureId == 0) {
+        return false;
+    }
+
+    GLint currTextureId = 0;
+    glGetIntegerv(GL_TEXTURE_BINDING_2D, &currTextureId);
+    glBindTexture(GL_TEXTURE_2D, texture->textureId);
+    if (isMipmapFilter(texture->minFilter)) {
+        generateMipmap(image, texture);
+    }
+
+    // parameters are state of the texture object, draws only bind it
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texture->uWrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texture->vWrap);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texture->minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texture->magFilter);
+    glBindTexture(GL_TEXTURE_2D, currTextureId);
+    return true;
+}
+
+bool GLBatchRender::isCompressedFormatSupported(unsigned int format) {
+    std::lock_guard<std::mutex> lock(compressedFormatsMutex);
+    return std::find(compressedFormats.begin(), compressedFormats.end(), (GLint) format) != compressedFormats.end();
+}
+
 }
@@ -24,9 +24,25 @@
     #include <GLES2/gl2.h>
 #endif
 
+#include <cstddef>
+#include <vector>
+
 #define SAFE_DELETE(p)       { if(p) { delete (p);     (p)=NULL; } }
 #define SAFE_DELETE_ARRAY(p) { if(p) { delete[] (p);   (p)=NULL; } }
 
+// atlas pages a single draw call may sample, on texture units 0 to MAX_BATCH_TEXTURES - 1
+#define MAX_BATCH_TEXTURES 4
+
+// vertex effects the vertex shader applies, OpenGLVertexEffect::flags. each combination, with or
+// without two color tinting, links its own program
+#define SHADER_EFFECT_JITTER 1
+#define SHADER_EFFECT_SWIRL 2
+#define SHADER_TWO_COLOR 4
+#define SHADER_VARIANTS 8
+
+// samples of the swirl interpolation over [0, 1], the shader interpolates linearly between them
+#define SWIRL_CURVE_SAMPLES 17
+
 namespace SpineRender {
 
 struct OpenGLTexture {
@@ -37,14 +53,46 @@ struct OpenGLTexture {
     unsigned int magFilter = 0;
     unsigned int uWrap = 0;
     unsigned int vWrap = 0;
+    size_t byteSize = 0;    // GPU memory of the uploaded level
+};
+
+// decoded, premultiplied pixels of a texture, or a compressed level, ready to be uploaded
+struct OpenGLImage {
+    int width = 0;
+    int height = 0;
+    unsigned char *pixels = nullptr;
+    unsigned int glFormat = GL_RGBA;        // GL_RGBA or GL_RGB
+    unsigned int glType = GL_UNSIGNED_BYTE; // or a packed 16 bit type
+    void *mapped = nullptr;         // set when pixels point into a TextureCache entry
+    size_t mappedLength = 0;
+    unsigned int compressedFormat = 0;  // 0 for RGBA8
+    size_t dataSize = 0;                // bytes of a compressed level
+};
+
+// parameters of the vertex effects, in the coordinates of OpenGLVertex::x and y. swirl is applied before jitter
+struct OpenGLVertexEffect {
+    int flags = 0;
+    float jitterX = 0.0f;
+    float jitterY = 0.0f;
+    float jitterSeed = 0.0f;    // change it every frame for the vertices to move
+    float swirlX = 0.0f;
+    float swirlY = 0.0f;
+    float swirlRadius = 0.0f;
+    float swirlAngle = 0.0f;    // radians
+    float swirlCurve[SWIRL_CURVE_SAMPLES] = {};
 };
 
 struct OpenGLRenderState {
     unsigned int blendSrc = 0;
     unsigned int blendDst = 0;
-    OpenGLTexture texture;
+    float lodBias = 0.0f;   // added to the mip level the GPU picks, > 0 samples coarser levels
+    OpenGLTexture textures[MAX_BATCH_TEXTURES];     // OpenGLVertex::page indexes these
+    int textureCount = 0;
+    bool stencilClip = false;   // draw only inside the polygon of the last drawClipMask
+    OpenGLVertexEffect effect;
 };
 
+// SkeletonDrawable computes x and y in place, as a float array with a stride of OPENGL_VERTEX_FLOATS
 struct OpenGLVertex {
     float x;
     float y;
@@ -54,6 +102,17 @@ struct OpenGLVertex {
     float a;
     float u;
     float v;
+    float page;     // index into OpenGLRenderState::textures
+};
+#define OPENGL_VERTEX_FLOATS 9
+static_assert(sizeof(OpenGLVertex) == OPENGL_VERTEX_FLOATS * sizeof(float), "OpenGLVertex holds floats only");
+
+// the dark color of two color tinting, normalized. a is 1 when the texture is premultiplied
+struct OpenGLDarkColor {
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
 };
 
 class GLBatchRender {
@@ -61,25 +120,90 @@ public:
     GLBatchRender() : inited_(false), width_(1), height_(1) {};
 
     bool create(int width, int height);
-    void draw(OpenGLVertex *vertices, int vertexCnt, OpenGLRenderState *state);
+    // triangles of indexCnt indices into vertices, at most 65536 of them. darkColors, one per vertex,
+    // tints the dark parts of the texture. batches without them use the cheaper single color shader
+    void draw(OpenGLVertex *vertices, int vertexCnt, const unsigned short *indices, int indexCnt,
+              OpenGLRenderState *state, const OpenGLDarkColor *darkColors = nullptr);
+    // writes the polygon (x, y pairs, convex or not) to the stencil buffer as the area draws with
+    // state->stencilClip keep to. needs a stencil buffer, see hasStencil
+    void drawClipMask(const float *polygon, int vertexCount);
+    // whether the bound framebuffer has one, clipping falls back to the CPU otherwise
+    bool hasStencil();
     void destroy();
 
-    static bool createTexture(const char *path, OpenGLTexture *texture);
+    // pages one draw call may use, 1 binds a single texture like a plain sprite batch
+    int getMaxTextures() const {
+        return maxTextures_;
+    }
+    void setMaxTextures(int count);
+
+    // draw calls issued since the last reset
+    int getDrawCallCount() const {
+        return drawCalls_;
+    }
+    void resetDrawCallCount() {
+        drawCalls_ = 0;
+    }
+
+    static bool createTexture(const char *path, OpenGLTexture *texture,
+                              unsigned int glFormat = GL_RGBA, unsigned int glType = GL_UNSIGNED_BYTE, bool dither = true);
     static void releaseTexture(OpenGLTexture *texture);
 
+    // these don't touch GL, they may be called from any thread
+    static bool decodeImage(const char *path, OpenGLImage *image);
+    static void freeImage(OpenGLImage *image);
+    // converts RGBA8 pixels to GL_RGBA/GL_UNSIGNED_SHORT_4_4_4_4, GL_RGB/GL_UNSIGNED_SHORT_5_6_5 or GL_RGB
+    static bool convertImage(OpenGLImage *image, unsigned int glFormat, unsigned int glType, bool dither);
+    static size_t imageByteSize(const OpenGLImage &image);
+    static bool readImageSize(const char *path, int *width, int *height);
+
     static unsigned int createTexture(int width, int height, unsigned char *buffer);
+    static unsigned int createTexture(const OpenGLImage &image);
+    // uploads image into texture, with a mip chain when texture->minFilter is a mipmap filter
+    static bool uploadTexture(const OpenGLImage &image, OpenGLTexture *texture);
+
+    // the same upload in steps, so a large page can be spread over frames: the storage of an
+    // uncompressed image, strips of its rows, then finishTexture publishes textureId to texture
+    static unsigned int allocTexture(const OpenGLImage &image);
+    static void uploadTextureRows(unsigned int textureId, const OpenGLImage &image, int y, int rows);
+    static bool finishTexture(const OpenGLImage &image, unsigned int textureId, OpenGLTexture *texture);
+
+    // compressed formats reported by the driver, known once a GLBatchRender was created
+    static bool isCompressedFormatSupported(unsigned int format);
 
 private:
+    // a linked shader with the uniforms of one variant, SHADER_EFFECT_* and SHADER_TWO_COLOR flags
+    struct ShaderProgram {
+        GLuint program = 0;
+        GLint lodBiasLoc = -1;
+        GLint jitterLoc = -1;
+        GLint swirlLoc = -1;
+        GLint swirlCurveLoc = -1;
+        float lodBias = 0.0f;
+        bool failed = false;
+    };
+
     bool initGL();
+    // links the program of the variant on first use, the plain one if that fails
+    ShaderProgram *useProgram(int variant);
+    bool createProgram(int variant, ShaderProgram *program);
+    void setVertexAttribs();
+    // indexed when indices isn't null, a plain triangle list otherwise
+    void drawTriangles(const OpenGLVertex *vertices, int vertexCnt, const unsigned short *indices, int indexCnt,
+                       const OpenGLDarkColor *darkColors);
     
 private:
     bool inited_;
     int width_, height_;
-    GLuint shaderProgram_;
+    ShaderProgram programs_[SHADER_VARIANTS];
     GLuint vbo_;
-    GLuint texLoc_;
-
-    OpenGLRenderState currState_;
+    GLuint ibo_;
+    GLuint darkVbo_;
+    GLuint placeholderTexture_ = 0;
+    int maxTextures_ = MAX_BATCH_TEXTURES;
+    int drawCalls_ = 0;
+    GLint stencilBits_ = -1;   // not asked yet
+    std::vector<OpenGLVertex> maskVertices_;
     
 #ifdef SPINE_MAC
     GLuint vao_;
@@ -0,0 +1,155 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include "GLStateCache.h"
+
+namespace SpineRender {
+
+// no GL object has this name, bindings in this state are always issued
+#define UNKNOWN_BINDING 0xFFFFFFFFu
+
+static GLuint currProgram = UNKNOWN_BINDING;
+static GLuint currArrayBuffer = UNKNOWN_BINDING;
+#ifdef SPINE_MAC
+static GLuint currVertexArray = UNKNOWN_BINDING;
+#endif
+static GLuint currTextures[MAX_BATCH_TEXTURES] = {UNKNOWN_BINDING, UNKNOWN_BINDING, UNKNOWN_BINDING, UNKNOWN_BINDING};
+static GLuint currActiveUnit = UNKNOWN_BINDING;
+static GLenum currBlendSrc = UNKNOWN_BINDING;
+static GLenum currBlendDst = UNKNOWN_BINDING;
+static GLuint currStencilTest = UNKNOWN_BINDING;
+static GLStateCache::Stats counters;
+
+static bool changes(GLuint &curr, GLuint value, GLStateCache::Counter &counter) {
+    if (curr == value) {
+        counter.skipped++;
+        return false;
+    }
+    curr = value;
+    counter.issued++;
+    return true;
+}
+
+void GLStateCache::useProgram(GLuint program) {
+    if (changes(currProgram, program, counters.program)) {
+        glUseProgram(program);
+    }
+}
+
+bool GLStateCache::bindArrayBuffer(GLuint buffer) {
+    if (changes(currArrayBuffer, buffer, counters.arrayBuffer)) {
+        glBindBuffer(GL_ARRAY_BUFFER, buffer);
+        return true;
+    }
+    return false;
+}
+
+#ifdef SPINE_MAC
+void GLStateCache::bindVertexArray(GLuint vertexArray) {
+    if (changes(currVertexArray, vertexArray, counters.vertexArray)) {
+        glBindVertexArray(vertexArray);
+    }
+}
+#endif
+
+void GLStateCache::bindTexture(int unit, GLuint texture) {
+    static_assert(MAX_BATCH_TEXTURES == 4, "currTextures initializes 4 units");
+    if (!changes(currTextures[unit], texture, counters.texture)) {
+        return;
+    }
+    // the active unit only matters to the bind, it isn't counted on its own
+    if (currActiveUnit != (GLuint) unit) {
+        glActiveTexture(GL_TEXTURE0 + unit);
+        currActiveUnit = (GLuint) unit;
+    }
+    glBindTexture(GL_TEXTURE_2D, texture);
+}
+
+void GLStateCache::blendFunc(GLenum src, GLenum dst) {
+    if (currBlendSrc == src && currBlendDst == dst) {
+        counters.blend.skipped++;
+        return;
+    }
+    if (currBlendSrc == UNKNOWN_BINDING) {
+        glEnable(GL_BLEND);
+    }
+    glBlendFunc(src, dst);
+    currBlendSrc = src;
+    currBlendDst = dst;
+    counters.blend.issued++;
+}
+
+void GLStateCache::stencilTest(bool enable) {
+    if (changes(currStencilTest, enable ? 1 : 0, counters.stencil)) {
+        if (enable) {
+            glEnable(GL_STENCIL_TEST);
+        } else {
+            glDisable(GL_STENCIL_TEST);
+        }
+    }
+}
+
+void GLStateCache::deleteProgram(GLuint program) {
+    glDeleteProgram(program);
+    // a deleted program stays in use until another one is, bind the next one for sure
+    if (currProgram == program) {
+        currProgram = UNKNOWN_BINDING;
+    }
+}
+
+void GLStateCache::deleteBuffer(GLuint buffer) {
+    glDeleteBuffers(1, &buffer);
+    if (currArrayBuffer == buffer) {
+        currArrayBuffer = 0;
+    }
+}
+
+#ifdef SPINE_MAC
+void GLStateCache::deleteVertexArray(GLuint vertexArray) {
+    glDeleteVertexArrays(1, &vertexArray);
+    if (currVertexArray == vertexArray) {
+        currVertexArray = 0;
+    }
+}
+#endif
+
+void GLStateCache::deleteTexture(GLuint texture) {
+    glDeleteTextures(1, &texture);
+    // GL unbinds a deleted texture from the units of the current context
+    for (GLuint &curr : currTextures) {
+        if (curr == texture) {
+            curr = 0;
+        }
+    }
+}
+
+void GLStateCache::invalidate() {
+    currProgram = UNKNOWN_BINDING;
+    currArrayBuffer = UNKNOWN_BINDING;
+#ifdef SPINE_MAC
+    currVertexArray = UNKNOWN_BINDING;
+#endif
+    for (GLuint &curr : currTextures) {
+        curr = UNKNOWN_BINDING;
+    }
+    currActiveUnit = UNKNOWN_BINDING;
+    currBlendSrc = UNKNOWN_BINDING;
+    currBlendDst = UNKNOWN_BINDING;
+    currStencilTest = UNKNOWN_BINDING;
+}
+
+GLStateCache::Stats GLStateCache::stats() {
+    return counters;
+}
+
+void GLStateCache::resetStats() {
+    counters = Stats();
+}
+
+}
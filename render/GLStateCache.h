@@ -0,0 +1,65 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#ifndef SPINE_RENDER_GLSTATECACHE_H_
+#define SPINE_RENDER_GLSTATECACHE_H_
+
+#include "GLBatchRender.h"
+
+namespace SpineRender {
+
+// Mirrors the bindings and blend state of the GL context all GLBatchRenders draw into, so a
+// draw only issues the calls that change something. GL thread only. Code outside the renderer
+// that binds programs, buffers or textures, or changes blending, calls invalidate() afterwards.
+class GLStateCache {
+public:
+    struct Counter {
+        size_t issued = 0;      // calls passed on to GL
+        size_t skipped = 0;     // calls dropped because GL was in that state already
+    };
+
+    struct Stats {
+        Counter program;
+        Counter arrayBuffer;
+        Counter vertexArray;
+        Counter texture;
+        Counter blend;
+        Counter stencil;
+    };
+
+    static void useProgram(GLuint program);
+    // returns true if the binding changed, vertex attribute pointers refer to the buffer bound then
+    static bool bindArrayBuffer(GLuint buffer);
+#ifdef SPINE_MAC
+    static void bindVertexArray(GLuint vertexArray);
+#endif
+    static void bindTexture(int unit, GLuint texture);
+    // enables blending too
+    static void blendFunc(GLenum src, GLenum dst);
+    // the stencil function and operations are left to GLBatchRender::drawClipMask
+    static void stencilTest(bool enable);
+
+    // delete through the cache, GL hands the names out again
+    static void deleteProgram(GLuint program);
+    static void deleteBuffer(GLuint buffer);
+#ifdef SPINE_MAC
+    static void deleteVertexArray(GLuint vertexArray);
+#endif
+    static void deleteTexture(GLuint texture);
+
+    // forget everything, the next call of each kind is issued
+    static void invalidate();
+
+    static Stats stats();
+    static void resetStats();
+};
+
+}
+
+#endif //SPINE_RENDER_GLSTATECACHE_H_
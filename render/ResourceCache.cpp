@@ -0,0 +1,361 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include "ResourceCache.h"
+#include "SkeletonDrawable.h"
+#include "SkeletonLoader.h"
+#include "utils/Logger.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace SpineRender {
+
+struct AtlasEntry {
+    std::string key;
+    spine::Atlas *atlas = nullptr;
+    spine::AsyncTextureLoader *loader = nullptr;
+    int refCount = 0;
+    bool loading = true;
+    unsigned long long lastUsed = 0;
+    std::vector<bool> evicted;
+};
+
+struct SkeletonEntry {
+    std::string key;
+    float scale = 1.0f;
+    AtlasEntry *atlas = nullptr;
+    spine::SkeletonData *skeletonData = nullptr;
+    int refCount = 0;
+    bool loading = true;
+};
+
+// loading entries are in the tables already, later acquires of the same key wait on resourceCond
+static std::mutex resourceMutex;
+static std::condition_variable resourceCond;
+static std::unordered_map<std::string, AtlasEntry *> atlasEntries;
+static std::vector<SkeletonEntry *> skeletonEntries;
+static size_t budgetBytes = 64 << 20;
+static unsigned long long releaseTick = 0;
+static ResourceCache::Stats counters;
+
+static std::string canonicalPath(const char *path) {
+#ifdef _WIN32
+    char *resolved = _fullpath(nullptr, path, 0);
+#else
+    char *resolved = realpath(path, nullptr);
+#endif
+    if (!resolved) {
+        return path;
+    }
+    std::string result(resolved);
+    free(resolved);
+    return result;
+}
+
+static AtlasEntry *findAtlas(spine::Atlas *atlas) {
+    for (auto &it : atlasEntries) {
+        if (it.second->atlas == atlas) {
+            return it.second;
+        }
+    }
+    return nullptr;
+}
+
+// the key tells dithered from plain pages of the same file
+static std::string atlasKey(const std::string &path, bool dither) {
+    return path + (dither ? "#dither" : "#plain");
+}
+
+static size_t pageBytes(spine::AtlasPage *page) {
+    auto *texture = (OpenGLTexture *) page->getRendererObject();
+    return texture ? texture->byteSize : 0;
+}
+
+static size_t atlasBytes(AtlasEntry *entry) {
+    size_t bytes = 0;
+    if (!entry->loading) {
+        spine::Vector<spine::AtlasPage *> &pages = entry->atlas->getPages();
+        for (size_t i = 0; i < pages.size(); i++) {
+            bytes += pageBytes(pages[i]);
+        }
+    }
+    return bytes;
+}
+
+// pages evicted while unreferenced are decoded again, the atlas regions stay valid
+static void reloadEvicted(AtlasEntry *entry) {
+    spine::Vector<spine::AtlasPage *> &pages = entry->atlas->getPages();
+    for (size_t i = 0; i < pages.size(); i++) {
+        if (entry->evicted[i]) {
+            entry->loader->load(*pages[i], pages[i]->texturePath);
+            entry->evicted[i] = false;
+        }
+    }
+}
+
+// skeleton data references the regions of its atlas, delete it first
+static void dropAtlas(AtlasEntry *entry) {
+    for (auto it = skeletonEntries.begin(); it != skeletonEntries.end();) {
+        if ((*it)->atlas == entry) {
+            delete (*it)->skeletonData;
+            delete *it;
+            it = skeletonEntries.erase(it);
+        } else {
+            ++it;
+        }
+    }
+    atlasEntries.erase(entry->key);
+    delete entry->atlas;
+    delete entry->loader;
+    delete entry;
+}
+
+static void trimLocked(size_t maxBytes) {
+    size_t resident = 0;
+    std::vector<AtlasEntry *> unreferenced;
+    for (auto &it : atlasEntries) {
+        resident += atlasBytes(it.second);
+        if (it.second->refCount == 0 && !it.second->loading) {
+            unreferenced.push_back(it.second);
+        }
+    }
+    if (resident <= maxBytes) {
+        return;
+    }
+
+    std::sort(unreferenced.begin(), unreferenced.end(), [](AtlasEntry *a, AtlasEntry *b) {
+        return a->lastUsed < b->lastUsed;
+    });
+    for (AtlasEntry *entry : unreferenced) {
+        spine::Vector<spine::AtlasPage *> &pages = entry->atlas->getPages();
+        bool partly = false;
+        for (size_t i = 0; i < pages.size(); i++) {
+            if (entry->evicted[i]) {
+                continue;
+            }
+            if (resident <= maxBytes) {
+                partly = true;
+                break;
+            }
+            resident -= std::min(resident, pageBytes(pages[i]));
+            entry->loader->unload(pages[i]->getRendererObject());
+            pages[i]->setRendererObject(nullptr);
+            entry->evicted[i] = true;
+            counters.evictedPages++;
+        }
+        // nothing left on the GPU, forget the atlas and its skeletons
+        if (!partly) {
+            dropAtlas(entry);
+        }
+        if (resident <= maxBytes) {
+            break;
+        }
+    }
+}
+
+static void unrefAtlas(AtlasEntry *entry) {
+    if (--entry->refCount == 0) {
+        entry->lastUsed = ++releaseTick;
+        trimLocked(budgetBytes);
+    }
+}
+
+spine::Atlas *ResourceCache::acquireAtlas(const char *path, TextureUploader *uploader, bool dither) {
+    std::string atlasPath = canonicalPath(path);
+    std::string key = atlasKey(atlasPath, dither);
+    std::unique_lock<std::mutex> lock(resourceMutex);
+    while (true) {
+        auto it = atlasEntries.find(key);
+        if (it == atlasEntries.end()) {
+            break;
+        }
+        AtlasEntry *entry = it->second;
+        if (entry->loading) {
+            resourceCond.wait(lock);
+            continue;
+        }
+        entry->refCount++;
+        counters.atlasHits++;
+        reloadEvicted(entry);
+        return entry->atlas;
+    }
+
+    auto *entry = new AtlasEntry();
+    entry->key = key;
+    entry->loader = new spine::AsyncTextureLoader(uploader, dither);
+    atlasEntries[key] = entry;
+    counters.atlasMisses++;
+
+    lock.unlock();
+    auto *atlas = new spine::Atlas(atlasPath.c_str(), entry->loader);
+    lock.lock();
+
+    entry->loading = false;
+    resourceCond.notify_all();
+    if (atlas->getPages().size() == 0) {
+        atlasEntries.erase(key);
+        delete atlas;
+        delete entry->loader;
+        delete entry;
+        return nullptr;
+    }
+    entry->atlas = atlas;
+    entry->evicted.assign(atlas->getPages().size(), false);
+    entry->refCount = 1;
+    return atlas;
+}
+
+spine::SkeletonData *ResourceCache::acquireSkeletonData(const char *path, spine::Atlas *atlas, float scale) {
+    std::string key = canonicalPath(path);
+    std::unique_lock<std::mutex> lock(resourceMutex);
+    AtlasEntry *atlasEntry = findAtlas(atlas);
+    if (!atlasEntry) {
+        LOG_ERROR("atlas not acquired from the resource cache");
+        return nullptr;
+    }
+
+    while (true) {
+        auto it = std::find_if(skeletonEntries.begin(), skeletonEntries.end(), [&](SkeletonEntry *e) {
+            return e->key == key && e->scale == scale && e->atlas == atlasEntry;
+        });
+        if (it == skeletonEntries.end()) {
+            break;
+        }
+        SkeletonEntry *entry = *it;
+        if (entry->loading) {
+            resourceCond.wait(lock);
+            continue;
+        }
+        entry->refCount++;
+        atlasEntry->refCount++;
+        counters.skeletonHits++;
+        return entry->skeletonData;
+    }
+
+    auto *entry = new SkeletonEntry();
+    entry->key = key;
+    entry->scale = scale;
+    entry->atlas = atlasEntry;
+    skeletonEntries.push_back(entry);
+    // skeleton data keeps a reference on its atlas
+    atlasEntry->refCount++;
+    counters.skeletonMisses++;
+
+    lock.unlock();
+    spine::SkeletonData *skeletonData = SkeletonLoader::readSkeletonData(key.c_str(), atlas, scale);
+    lock.lock();
+
+    entry->loading = false;
+    resourceCond.notify_all();
+    if (!skeletonData) {
+        skeletonEntries.erase(std::find(skeletonEntries.begin(), skeletonEntries.end(), entry));
+        delete entry;
+        unrefAtlas(atlasEntry);
+        return nullptr;
+    }
+    entry->skeletonData = skeletonData;
+    entry->refCount = 1;
+    return skeletonData;
+}
+
+void ResourceCache::releaseAtlas(spine::Atlas *atlas) {
+    if (!atlas) return;
+    std::lock_guard<std::mutex> lock(resourceMutex);
+    AtlasEntry *entry = findAtlas(atlas);
+    if (entry) {
+        unrefAtlas(entry);
+    }
+}
+
+void ResourceCache::releaseSkeletonData(spine::SkeletonData *skeletonData) {
+    if (!skeletonData) return;
+    std::lock_guard<std::mutex> lock(resourceMutex);
+    for (SkeletonEntry *entry : skeletonEntries) {
+        if (entry->skeletonData == skeletonData) {
+            if (--entry->refCount == 0) {
+                // lazily read animations are read again on the next use
+                skeletonData->unloadUnusedAnimations();
+            }
+            unrefAtlas(entry->atlas);
+            return;
+        }
+    }
+}
+
+spine::TextureLoader *ResourceCache::textureLoader(spine::Atlas *atlas) {
+    std::lock_guard<std::mutex> lock(resourceMutex);
+    AtlasEntry *entry = findAtlas(atlas);
+    return entry ? entry->loader : nullptr;
+}
+
+void ResourceCache::setBudget(size_t maxBytes) {
+    std::lock_guard<std::mutex> lock(resourceMutex);
+    budgetBytes = maxBytes;
+    trimLocked(budgetBytes);
+}
+
+void ResourceCache::trim(size_t maxBytes) {
+    std::lock_guard<std::mutex> lock(resourceMutex);
+    trimLocked(maxBytes);
+}
+
+void ResourceCache::contextLost() {
+    std::lock_guard<std::mutex> lock(resourceMutex);
+    std::vector<AtlasEntry *> entries;
+    for (auto &it : atlasEntries) {
+        // atlases still loading only queued their uploads
+        if (!it.second->loading) {
+            entries.push_back(it.second);
+        }
+    }
+    for (AtlasEntry *entry : entries) {
+        spine::Vector<spine::AtlasPage *> &pages = entry->atlas->getPages();
+        for (size_t i = 0; i < pages.size(); i++) {
+            auto *texture = (OpenGLTexture *) pages[i]->getRendererObject();
+            if (texture) {
+                texture->textureId = 0;
+            }
+        }
+        if (entry->refCount == 0) {
+            dropAtlas(entry);
+            continue;
+        }
+        for (size_t i = 0; i < pages.size(); i++) {
+            if (!entry->evicted[i]) {
+                entry->loader->unload(pages[i]->getRendererObject());
+                pages[i]->setRendererObject(nullptr);
+                entry->evicted[i] = true;
+            }
+        }
+        reloadEvicted(entry);
+    }
+}
+
+ResourceCache::Stats ResourceCache::stats() {
+    std::lock_guard<std::mutex> lock(resourceMutex);
+    Stats result = counters;
+    result.atlasCount = atlasEntries.size();
+    result.skeletonCount = skeletonEntries.size();
+    for (auto &it : atlasEntries) {
+        size_t bytes = atlasBytes(it.second);
+        result.residentBytes += bytes;
+        if (it.second->refCount == 0) {
+            result.unreferencedBytes += bytes;
+        }
+    }
+    return result;
+}
+
+}
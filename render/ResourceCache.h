@@ -0,0 +1,68 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#ifndef SPINE_RENDER_RESOURCECACHE_H_
+#define SPINE_RENDER_RESOURCECACHE_H_
+
+#include <spine/spine.h>
+
+#include "TextureUploader.h"
+
+namespace SpineRender {
+
+// Process wide cache of atlases and skeleton data, keyed by canonical path, so controllers
+// showing the same character share one set of pages on the GPU. Entries are reference counted.
+// Unreferenced atlases stay resident until the pages of all atlases exceed the budget, then the
+// pages of the least recently released ones are deleted, and loaded again on the next acquire.
+class ResourceCache {
+public:
+    struct Stats {
+        size_t atlasHits = 0;
+        size_t atlasMisses = 0;
+        size_t skeletonHits = 0;
+        size_t skeletonMisses = 0;
+        size_t evictedPages = 0;
+        size_t atlasCount = 0;
+        size_t skeletonCount = 0;
+        size_t residentBytes = 0;       // GPU memory of all uploaded pages
+        size_t unreferencedBytes = 0;   // the part of it that may be evicted
+    };
+
+    // acquire may run on any thread, the pages are decoded on the uploader's pool and are
+    // valid once uploader->pendingCount(textureLoader(atlas)) reaches 0.
+    // returns nullptr if the atlas has no pages. the same file acquired with and without dither
+    // gives two atlases
+    static spine::Atlas *acquireAtlas(const char *path, TextureUploader *uploader, bool dither);
+    // atlas must be acquired, the skeleton data keeps it referenced until released
+    static spine::SkeletonData *acquireSkeletonData(const char *path, spine::Atlas *atlas, float scale);
+
+    // release, trim and setBudget may run on any thread, the textures they evict are deleted on the
+    // GL thread in the next TextureUploader::process or flush
+    static void releaseAtlas(spine::Atlas *atlas);
+    static void releaseSkeletonData(spine::SkeletonData *skeletonData);
+
+    // the owner of the atlas' pending uploads in the TextureUploader
+    static spine::TextureLoader *textureLoader(spine::Atlas *atlas);
+
+    // bytes of textures kept before unreferenced pages are evicted, 64 MB by default
+    static void setBudget(size_t maxBytes);
+    // evict unreferenced pages until the resident pages fit in maxBytes
+    static void trim(size_t maxBytes);
+
+    // GL thread, the context the pages were uploaded in is gone or about to be destroyed with its
+    // textures: forget them without calling GL. unreferenced atlases and their skeleton data are
+    // deleted, the pages of referenced ones are loaded again into the next context
+    static void contextLost();
+
+    static Stats stats();
+};
+
+}
+
+#endif //SPINE_RENDER_RESOURCECACHE_H_
@@ -10,12 +10,25 @@
 #include "SkeletonDrawable.h"
 #include "utils/Logger.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
 namespace spine {
 
 #ifndef SPINE_MESH_VERTEX_COUNT_MAX
 #define SPINE_MESH_VERTEX_COUNT_MAX 1000
 #endif
 
+// vertices a batch may index with unsigned shorts
+#define SPINE_BATCH_VERTEX_COUNT_MAX 65536
+
+// vertices inside a clip from which ClippingMode_Auto takes the stencil buffer. below it, cutting
+// the few triangles costs less than the two batch breaks and the mask draw
+#ifndef SPINE_STENCIL_CLIP_VERTICES
+#define SPINE_STENCIL_CLIP_VERTICES 64
+#endif
+
 GLBlendMode blend_normal = GLBlendMode(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
 GLBlendMode blend_additive = GLBlendMode(GL_SRC_ALPHA, GL_ONE);
 GLBlendMode blend_multiply = GLBlendMode(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA);
@@ -27,11 +40,24 @@ GLBlendMode blend_multiplyPma = GLBlendMode(GL_DST_COLOR, GL_ONE_MINUS_SRC_ALPHA
 GLBlendMode blend_screenPma = GLBlendMode(GL_ONE, GL_ONE_MINUS_SRC_COLOR);
 
 SkeletonDrawable::SkeletonDrawable(SpineRender::GLBatchRender *render, SkeletonData *skeletonData, AnimationStateData *stateData) :
-    _render(render),
+    worldVertices(),
+    clipper(),
     timeScale(1),
+    textureLodBias(0),
+    autoLodFullDetailScale(1),
+    autoLodMaxBias(0),
+    autoLodBias(0),
+    screenScale(0),
+    clippingMode(ClippingMode_Auto),
+    useShaderEffects(true),
+    twoColorTint(false),
+    useVertexCache(false),
+    cachedSkeleton(nullptr),
+    stencilClip(nullptr),
     vertexArray(),
+    vertexEffect(nullptr),
     _blendMode(blend_normal),
-    vertexEffect(nullptr), worldVertices(), clipper() {
+    _render(render) {
     vertexArray.setSize(skeletonData->getBones().size() * 4, SpineRender::OpenGLVertex());
 
     Bone::setYDown(true);
@@ -69,14 +95,30 @@ void SkeletonDrawable::update(float deltaTime) {
 
 void SkeletonDrawable::draw() {
     vertexArray.clear();
+    indexArray.clear();
+    darkColors.clear();
+    _states.textureCount = 0;
 
     // Early out if skeleton is invisible
     if (skeleton->getColor().a == 0) return;
 
     if (vertexEffect != nullptr) vertexEffect->begin(*skeleton);
+    bool shaderEffect = setShaderEffect();
+    twoColorTint = hasDarkColors();
+
+    // the cached bones and attachments belong to the skeleton they were computed for
+    vertexCacheStats = VertexCacheStats();
+    if (cachedSkeleton != skeleton) {
+        slotVertices.clear();
+        cachedSkeleton = skeleton;
+    }
+    slotVertices.resize(skeleton->getSlots().size());
 
     SpineRender::OpenGLVertex vertex;
     SpineRender::OpenGLTexture *texture = nullptr;
+    // twice the triangle areas drawn, for the auto lod bias
+    float area = 0;
+    float texelArea = 0;
     for (unsigned i = 0; i < skeleton->getSlots().size(); ++i) {
         Slot &slot = *skeleton->getDrawOrder()[i];
         Attachment *attachment = slot.getAttachment();
@@ -84,7 +126,7 @@ void SkeletonDrawable::draw() {
 
         // Early out if the slot color is 0 or the bone is not active
         if (slot.getColor().a == 0 || !slot.getBone().isActive()) {
-            clipper.clipEnd(slot);
+            clipEnd(slot);
             continue;
         }
 
@@ -94,19 +136,19 @@ void SkeletonDrawable::draw() {
         Vector<unsigned short> *indices = nullptr;
         int indicesCount = 0;
         Color *attachmentColor;
+        RegionAttachment *regionAttachment = nullptr;
+        MeshAttachment *mesh = nullptr;
 
         if (attachment->getRTTI().isExactly(RegionAttachment::rtti)) {
-            auto *regionAttachment = (RegionAttachment *) attachment;
+            regionAttachment = (RegionAttachment *) attachment;
             attachmentColor = &regionAttachment->getColor();
 
             // Early out if the slot color is 0
             if (attachmentColor->a == 0) {
-                clipper.clipEnd(slot);
+                clipEnd(slot);
                 continue;
             }
 
-            worldVertices.setSize(8, 0);
-            regionAttachment->computeWorldVertices(slot.getBone(), worldVertices, 0, 2);
             verticesCount = 4;
             uvs = &regionAttachment->getUVs();
             indices = &quadIndices;
@@ -115,18 +157,16 @@ void SkeletonDrawable::draw() {
                 (SpineRender::OpenGLTexture *) ((AtlasRegion *) regionAttachment->getRendererObject())->page->getRendererObject();
 
         } else if (attachment->getRTTI().isExactly(MeshAttachment::rtti)) {
-            auto *mesh = (MeshAttachment *) attachment;
+            mesh = (MeshAttachment *) attachment;
             attachmentColor = &mesh->getColor();
 
             // Early out if the slot color is 0
             if (attachmentColor->a == 0) {
-                clipper.clipEnd(slot);
+                clipEnd(slot);
                 continue;
             }
 
-            worldVertices.setSize(mesh->getWorldVerticesLength(), 0);
             texture = (SpineRender::OpenGLTexture *) ((AtlasRegion *) mesh->getRendererObject())->page->getRendererObject();
-            mesh->computeWorldVertices(slot, 0, mesh->getWorldVerticesLength(), worldVertices, 0, 2);
             verticesCount = mesh->getWorldVerticesLength() >> 1;
             uvs = &mesh->getUVs();
             indices = &mesh->getTriangles();
@@ -134,10 +174,36 @@ void SkeletonDrawable::draw() {
 
         } else if (attachment->getRTTI().isExactly(ClippingAttachment::rtti)) {
             auto *clip = (ClippingAttachment *) slot.getAttachment();
-            clipper.clipStart(slot, clip);
+            clipStart(i, slot, clip);
             continue;
         } else continue;
 
+        // without clipping or an effect on the CPU, the positions are computed straight into the batch.
+        // the clipper and the effect read and write them as x, y pairs in worldVertices
+        bool cpuEffect = vertexEffect != nullptr && !shaderEffect;
+        bool direct = !clipper.isClipping() && !cpuEffect;
+        if (!direct) {
+            if (regionAttachment != nullptr) {
+                worldVertices.setSize(8, 0);
+                regionAttachment->computeWorldVertices(slot.getBone(), worldVertices, 0, 2);
+            } else {
+                worldVertices.setSize(mesh->getWorldVerticesLength(), 0);
+                mesh->computeWorldVertices(slot, 0, mesh->getWorldVerticesLength(), worldVertices, 0, 2);
+            }
+        }
+        if (clipper.isClipping()) {
+            clipper.clipTriangles(worldVertices, *indices, *uvs, 2);
+            vertices = &clipper.getClippedVertices();
+            verticesCount = clipper.getClippedVertices().size() >> 1;
+            uvs = &clipper.getClippedUVs();
+            indices = &clipper.getClippedTriangles();
+            indicesCount = clipper.getClippedTriangles().size();
+        }
+        if (verticesCount == 0) {
+            clipEnd(slot);
+            continue;
+        }
+
         float r = skeleton->getColor().r * slot.getColor().r * attachmentColor->r;
         float g = skeleton->getColor().g * slot.getColor().g * attachmentColor->g;
         float b = skeleton->getColor().b * slot.getColor().b * attachmentColor->b;
@@ -153,6 +219,14 @@ void SkeletonDrawable::draw() {
         light.b = b;
         light.a = a;
 
+        // not scaled by the alpha, like the light color
+        SpineRender::OpenGLDarkColor dark = {0, 0, 0, (unsigned char) (usePremultipliedAlpha ? 255 : 0)};
+        if (slot.hasDarkColor()) {
+            dark.r = (unsigned char) (slot.getDarkColor().r * 255);
+            dark.g = (unsigned char) (slot.getDarkColor().g * 255);
+            dark.b = (unsigned char) (slot.getDarkColor().b * 255);
+        }
+
         if (!usePremultipliedAlpha) {
             switch (slot.getData().getBlendMode()) {
                 case BlendMode_Normal:
@@ -189,55 +263,71 @@ void SkeletonDrawable::draw() {
             }
         }
 
-        _states.texture = *texture;
+        // a blend change ends the batch, a page change only when all texture units are taken,
+        // and so does running out of 16 bit indices
+        if (_states.blendSrc != _blendMode.src || _states.blendDst != _blendMode.dst ||
+            vertexArray.size() + verticesCount > SPINE_BATCH_VERTEX_COUNT_MAX) {
+            drawOpengl();
+        }
         _states.blendSrc = _blendMode.src;
         _states.blendDst = _blendMode.dst;
-
-        if (clipper.isClipping()) {
-            clipper.clipTriangles(worldVertices, *indices, *uvs, 2);
-            vertices = &clipper.getClippedVertices();
-            verticesCount = clipper.getClippedVertices().size() >> 1;
-            uvs = &clipper.getClippedUVs();
-            indices = &clipper.getClippedTriangles();
-            indicesCount = clipper.getClippedTriangles().size();
-        }
-
-        if (vertexEffect != 0) {
-            tempUvs.clear();
-            tempColors.clear();
+        _states.lodBias = textureLodBias + autoLodBias;
+        vertex.page = (float) batchTexture(*texture);
+
+        size_t firstVertex = vertexArray.size();
+        SlotVertices *cache = direct && useVertexCache ? &slotVertices[slot.getData().getIndex()] : nullptr;
+        if (cache != nullptr && isCurrent(*cache, slot, attachment)) {
+            const float *positions = cache->positions.data();
+            for (int ii = 0; ii < verticesCount; ++ii) {
+                vertex.x = positions[ii << 1];
+                vertex.y = positions[(ii << 1) + 1];
+                vertex.u = (*uvs)[ii << 1];
+                vertex.v = (*uvs)[(ii << 1) + 1];
+                vertexArray.add(vertex);
+            }
+            vertexCacheStats.hits++;
+        } else if (direct) {
+            // color, uvs and page in one pass, then the positions over them
+            for (int ii = 0; ii < verticesCount; ++ii) {
+                vertex.u = (*uvs)[ii << 1];
+                vertex.v = (*uvs)[(ii << 1) + 1];
+                vertexArray.add(vertex);
+            }
+            float *positions = &vertexArray[firstVertex].x;
+            if (regionAttachment != nullptr) {
+                regionAttachment->computeWorldVertices(slot.getBone(), positions, 0, OPENGL_VERTEX_FLOATS);
+            } else {
+                mesh->computeWorldVertices(slot, 0, mesh->getWorldVerticesLength(), positions, 0, OPENGL_VERTEX_FLOATS);
+            }
+            if (cache != nullptr) {
+                storePositions(*cache, slot, attachment, firstVertex, verticesCount);
+                vertexCacheStats.misses++;
+            }
+        } else if (cpuEffect) {
+            // one call for the attachment, the effect may move the uvs and colors too so it gets copies
+            tempUvs.clearAndAddAll(*uvs);
+            tempColors.setSize(verticesCount, light);
+            Color *colors = tempColors.buffer();
             for (int ii = 0; ii < verticesCount; ii++) {
-                Color vertexColor = light;
-                Color dark;
-                dark.r = dark.g = dark.b = dark.a = 0;
-                int index = ii << 1;
-                float x = (*vertices)[index];
-                float y = (*vertices)[index + 1];
-                float u = (*uvs)[index];
-                float v = (*uvs)[index + 1];
-                vertexEffect->transform(x, y, u, v, vertexColor, dark);
-                (*vertices)[index] = x;
-                (*vertices)[index + 1] = y;
-                tempUvs.add(u);
-                tempUvs.add(v);
-                tempColors.add(vertexColor);
+                colors[ii] = light;
             }
+            vertexEffect->transformBatch(vertices->buffer(), tempUvs.buffer(), colors, verticesCount);
 
-            for (int ii = 0; ii < indicesCount; ++ii) {
-                int index = (*indices)[ii] << 1;
+            for (int ii = 0; ii < verticesCount; ++ii) {
+                int index = ii << 1;
                 vertex.x = (*vertices)[index];
                 vertex.y = (*vertices)[index + 1];
-                vertex.u = (*uvs)[index];
-                vertex.v = (*uvs)[index + 1];
-                Color vertexColor = tempColors[index >> 1];
-                vertex.r = vertexColor.r;
-                vertex.g = vertexColor.g;
-                vertex.b = vertexColor.b;
-                vertex.a = vertexColor.a;
+                vertex.u = tempUvs[index];
+                vertex.v = tempUvs[index + 1];
+                vertex.r = colors[ii].r;
+                vertex.g = colors[ii].g;
+                vertex.b = colors[ii].b;
+                vertex.a = colors[ii].a;
                 vertexArray.add(vertex);
             }
         } else {
-            for (int ii = 0; ii < indicesCount; ++ii) {
-                int index = (*indices)[ii] << 1;
+            for (int ii = 0; ii < verticesCount; ++ii) {
+                int index = ii << 1;
                 vertex.x = (*vertices)[index];
                 vertex.y = (*vertices)[index + 1];
                 vertex.u = (*uvs)[index];
@@ -245,15 +335,219 @@ void SkeletonDrawable::draw() {
                 vertexArray.add(vertex);
             }
         }
-        clipper.clipEnd(slot);
+        size_t firstIndex = indexArray.size();
+        for (int ii = 0; ii < indicesCount; ++ii) {
+            indexArray.add((unsigned short) (firstVertex + (*indices)[ii]));
+        }
+        if (autoLodMaxBias > 0) {
+            addTriangleAreas(firstIndex, *texture, area, texelArea);
+        }
+        if (twoColorTint) {
+            darkColors.setSize(vertexArray.size(), dark);
+        }
+        clipEnd(slot);
     }
+    clipEnd();
     drawOpengl();
-    clipper.clipEnd();
 
     if (vertexEffect != nullptr) vertexEffect->end();
+
+    // the mip level the GPU picks is log2 of the texels per pixel, the bias goes on from there
+    if (autoLodMaxBias > 0 && area > 0 && texelArea > 0) {
+        screenScale = sqrtf(area / texelArea);
+        autoLodBias = std::min(std::max(log2f(autoLodFullDetailScale / screenScale), 0.0f), autoLodMaxBias);
+    }
+}
+
+void SkeletonDrawable::addTriangleAreas(size_t firstIndex, const SpineRender::OpenGLTexture &texture,
+                                        float &area, float &texelArea) {
+    // pages still uploading have no size yet
+    float textureArea = (float) texture.width * texture.height;
+    if (textureArea == 0) {
+        return;
+    }
+    for (size_t i = firstIndex; i + 2 < indexArray.size(); i += 3) {
+        const SpineRender::OpenGLVertex &a = vertexArray[indexArray[i]];
+        const SpineRender::OpenGLVertex &b = vertexArray[indexArray[i + 1]];
+        const SpineRender::OpenGLVertex &c = vertexArray[indexArray[i + 2]];
+        area += fabsf((b.x - a.x) * (c.y - a.y) - (c.x - a.x) * (b.y - a.y));
+        texelArea += fabsf((b.u - a.u) * (c.v - a.v) - (c.u - a.u) * (b.v - a.v)) * textureArea;
+    }
+}
+// the two color shader costs a second vertex stream, skeletons without a dark slot skip it
+bool SkeletonDrawable::hasDarkColors() {
+    Vector<Slot *> &slots = skeleton->getSlots();
+    for (size_t i = 0; i < slots.size(); i++) {
+        if (slots[i]->hasDarkColor()) {
+            return true;
+        }
+    }
+    return false;
 }
+
+// colors and uvs are written every frame, they cost less than comparing them
+bool SkeletonDrawable::isCurrent(const SlotVertices &cache, Slot &slot, Attachment *attachment) {
+    if (cache.attachment != attachment || cache.geometryVersion != attachment->getGeometryVersion()
+        || cache.deformVersion != slot.getDeformVersion()) {
+        return false;
+    }
+    for (size_t i = 0; i < cache.bones.size(); i++) {
+        if (cache.bones[i]->getWorldVersion() != cache.boneVersions[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void SkeletonDrawable::storePositions(SlotVertices &cache, Slot &slot, Attachment *attachment, size_t firstVertex, int count) {
+    // the bones the positions depend on: the slot's, or the weights' of a weighted mesh
+    if (cache.attachment != attachment || cache.geometryVersion != attachment->getGeometryVersion()) {
+        cache.attachment = attachment;
+        cache.geometryVersion = attachment->getGeometryVersion();
+        cache.bones.clear();
+        Vector<size_t> *weights = nullptr;
+        if (attachment->getRTTI().isExactly(MeshAttachment::rtti)) {
+            weights = &((MeshAttachment *) attachment)->getBones();
+        }
+        if (weights == nullptr || weights->size() == 0) {
+            cache.bones.push_back(&slot.getBone());
+        } else {
+            Vector<Bone *> &bones = skeleton->getBones();
+            for (size_t i = 0; i < weights->size(); i += (*weights)[i] + 1) {
+                for (size_t j = i + 1; j <= i + (*weights)[i]; j++) {
+                    Bone *bone = bones[(*weights)[j]];
+                    if (std::find(cache.bones.begin(), cache.bones.end(), bone) == cache.bones.end()) {
+                        cache.bones.push_back(bone);
+                    }
+                }
+            }
+        }
+    }
+    cache.deformVersion = slot.getDeformVersion();
+    cache.boneVersions.resize(cache.bones.size());
+    for (size_t i = 0; i < cache.bones.size(); i++) {
+        cache.boneVersions[i] = cache.bones[i]->getWorldVersion();
+    }
+    cache.positions.resize((size_t) count * 2);
+    for (int i = 0; i < count; i++) {
+        cache.positions[i * 2] = vertexArray[firstVertex + i].x;
+        cache.positions[i * 2 + 1] = vertexArray[firstVertex + i].y;
+    }
+}
+
+// the stock jitter and swirl run in the vertex shader, subclasses may have changed what transform does
+bool SkeletonDrawable::setShaderEffect() {
+    SpineRender::OpenGLVertexEffect &effect = _states.effect;
+    effect.flags = 0;
+    if (!useShaderEffects || vertexEffect == nullptr) {
+        return false;
+    }
+
+    const RTTI &rtti = vertexEffect->getRTTI();
+    if (rtti.isExactly(JitterVertexEffect::rtti)) {
+        auto *jitter = static_cast<JitterVertexEffect *>(vertexEffect);
+        effect.flags = SHADER_EFFECT_JITTER;
+        effect.jitterX = jitter->getJitterX();
+        effect.jitterY = jitter->getJitterY();
+        effect.jitterSeed = (float) (rand() % 1024);
+    } else if (rtti.isExactly(SwirlVertexEffect::rtti)) {
+        auto *swirl = static_cast<SwirlVertexEffect *>(vertexEffect);
+        effect.flags = SHADER_EFFECT_SWIRL;
+        effect.swirlX = swirl->getWorldX();
+        effect.swirlY = swirl->getWorldY();
+        effect.swirlRadius = swirl->getRadius();
+        effect.swirlAngle = swirl->getAngle();
+        Interpolation &interpolation = swirl->getInterpolation();
+        for (int i = 0; i < SWIRL_CURVE_SAMPLES; i++) {
+            effect.swirlCurve[i] = interpolation.apply((float) i / (SWIRL_CURVE_SAMPLES - 1));
+        }
+    }
+    return effect.flags != 0;
+}
+
 void SkeletonDrawable::drawOpengl() {
-    _render->draw(vertexArray.buffer(), vertexArray.size(), &_states);
+    if (vertexArray.size() > 0) {
+        _render->draw(vertexArray.buffer(), vertexArray.size(), indexArray.buffer(), indexArray.size(), &_states,
+                      twoColorTint ? darkColors.buffer() : nullptr);
+    }
+    vertexArray.clear();
+    indexArray.clear();
+    darkColors.clear();
+    _states.textureCount = 0;
+}
+
+void SkeletonDrawable::clipStart(unsigned slotIndex, Slot &slot, ClippingAttachment *clip) {
+    // clips don't nest, one inside another is ignored
+    if (stencilClip != nullptr || clipper.isClipping()) {
+        return;
+    }
+    if (!useStencilClip(slotIndex, clip)) {
+        clipper.clipStart(slot, clip);
+        return;
+    }
+
+    int n = (int) clip->getWorldVerticesLength();
+    clipPolygon.setSize(n, 0);
+    clip->computeWorldVertices(slot, 0, n, clipPolygon, 0, 2);
+    drawOpengl();
+    _render->drawClipMask(clipPolygon.buffer(), n >> 1);
+    _states.stencilClip = true;
+    stencilClip = clip;
+}
+
+void SkeletonDrawable::clipEnd(Slot &slot) {
+    if (stencilClip != nullptr && stencilClip->getEndSlot() == &slot.getData()) {
+        clipEnd();
+    }
+    clipper.clipEnd(slot);
+}
+
+void SkeletonDrawable::clipEnd() {
+    if (stencilClip != nullptr) {
+        drawOpengl();
+        _states.stencilClip = false;
+        stencilClip = nullptr;
+    }
+    clipper.clipEnd();
+}
+
+bool SkeletonDrawable::useStencilClip(unsigned slotIndex, ClippingAttachment *clip) {
+    if (clippingMode == ClippingMode_Cpu || vertexEffect != nullptr || !_render->hasStencil()) {
+        return false;
+    }
+    if (clippingMode == ClippingMode_Stencil) {
+        return true;
+    }
+
+    // the vertices of the slots up to the clip's end slot, as drawn
+    Vector<Slot *> &drawOrder = skeleton->getDrawOrder();
+    int vertexCount = 0;
+    for (size_t i = slotIndex + 1; i < drawOrder.size(); i++) {
+        Slot &slot = *drawOrder[i];
+        Attachment *attachment = slot.getAttachment();
+        if (attachment && attachment->getRTTI().isExactly(RegionAttachment::rtti)) {
+            vertexCount += 4;
+        } else if (attachment && attachment->getRTTI().isExactly(MeshAttachment::rtti)) {
+            vertexCount += (int) ((MeshAttachment *) attachment)->getWorldVerticesLength() >> 1;
+        }
+        if (&slot.getData() == clip->getEndSlot() || vertexCount >= SPINE_STENCIL_CLIP_VERTICES) {
+            break;
+        }
+    }
+    return vertexCount >= SPINE_STENCIL_CLIP_VERTICES;
+}
+
+int SkeletonDrawable::batchTexture(const SpineRender::OpenGLTexture &texture) {
+    for (int i = 0; i < _states.textureCount; i++) {
+        if (_states.textures[i].textureId == texture.textureId) {
+            return i;
+        }
+    }
+    if (_states.textureCount >= _render->getMaxTextures()) {
+        drawOpengl();
+    }
+    _states.textures[_states.textureCount] = texture;
+    return _states.textureCount++;
 }
 
 static unsigned int cvtTextureFilter(TextureFilter filter) {
@@ -280,17 +574,29 @@ static unsigned int cvtTextureWrap(TextureWrap wrap) {
     return GL_REPEAT;
 }
 
+// the formats without a gl equivalent on every target (alpha, intensity, luminance alpha) stay RGBA8
+static void cvtTextureFormat(Format format, unsigned int *glFormat, unsigned int *glType) {
+    switch (format) {
+        case Format_RGBA4444: *glFormat = GL_RGBA; *glType = GL_UNSIGNED_SHORT_4_4_4_4; break;
+        case Format_RGB565: *glFormat = GL_RGB; *glType = GL_UNSIGNED_SHORT_5_6_5; break;
+        case Format_RGB888: *glFormat = GL_RGB; *glType = GL_UNSIGNED_BYTE; break;
+        default: *glFormat = GL_RGBA; *glType = GL_UNSIGNED_BYTE; break;
+    }
+}
+
 void OpenGLTextureLoader::load(AtlasPage &page, const String &path) {
-    auto *texture = new SpineRender::OpenGLTexture();
-    bool createOk = SpineRender::GLBatchRender::createTexture(path.buffer(), texture);
-    if (createOk) {
-        texture->textureId = texture->textureId;
+    unsigned int glFormat, glType;
+    cvtTextureFormat(page.format, &glFormat, &glType);
 
-        texture->minFilter = cvtTextureFilter(page.minFilter);
-        texture->magFilter = cvtTextureFilter(page.magFilter);
-        texture->uWrap = cvtTextureWrap(page.uWrap);
-        texture->vWrap = cvtTextureWrap(page.vWrap);
+    // the filter decides whether a mip chain is built
+    auto *texture = new SpineRender::OpenGLTexture();
+    texture->minFilter = cvtTextureFilter(page.minFilter);
+    texture->magFilter = cvtTextureFilter(page.magFilter);
+    texture->uWrap = cvtTextureWrap(page.uWrap);
+    texture->vWrap = cvtTextureWrap(page.vWrap);
 
+    bool createOk = SpineRender::GLBatchRender::createTexture(path.buffer(), texture, glFormat, glType);
+    if (createOk) {
         page.width = texture->width;
         page.height = texture->height;
         page.setRendererObject(texture);
@@ -306,6 +612,42 @@ void OpenGLTextureLoader::unload(void *texture) {
     SAFE_DELETE(tex)
 }
 
+bool OpenGLTextureLoader::reload(AtlasPage &page, bool dither) {
+    auto *texture = (SpineRender::OpenGLTexture *) page.getRendererObject();
+    if (!texture) return false;
+    unsigned int glFormat, glType;
+    cvtTextureFormat(page.format, &glFormat, &glType);
+    return SpineRender::GLBatchRender::createTexture(page.texturePath.buffer(), texture, glFormat, glType, dither);
+}
+
+void AsyncTextureLoader::load(AtlasPage &page, const String &path) {
+    int width, height;
+    if (!SpineRender::GLBatchRender::readImageSize(path.buffer(), &width, &height)) {
+        LOG_ERROR("load texture failed: %s", path.buffer());
+        return;
+    }
+
+    auto *texture = new SpineRender::OpenGLTexture();
+    texture->minFilter = cvtTextureFilter(page.minFilter);
+    texture->magFilter = cvtTextureFilter(page.magFilter);
+    texture->uWrap = cvtTextureWrap(page.uWrap);
+    texture->vWrap = cvtTextureWrap(page.vWrap);
+
+    page.width = width;
+    page.height = height;
+    page.setRendererObject(texture);
+
+    unsigned int glFormat, glType;
+    cvtTextureFormat(page.format, &glFormat, &glType);
+    _uploader->load(this, texture, path.buffer(), glFormat, glType, _dither);
+}
+
+void AsyncTextureLoader::unload(void *texture) {
+    if (!texture) return;
+    // the atlas may be released on a loader thread, the GL texture goes on the GL thread
+    _uploader->release((SpineRender::OpenGLTexture *)texture);
+}
+
 #ifndef __ANDROID__
 SpineExtension *getDefaultExtension() {
     return new DefaultSpineExtension();
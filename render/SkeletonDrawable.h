@@ -12,6 +12,9 @@
 
 #include <spine/spine.h>
 #include "GLBatchRender.h"
+#include "TextureUploader.h"
+
+#include <vector>
 
 namespace spine {
 
@@ -23,6 +26,18 @@ struct GLBlendMode {
     unsigned int dst;
 };
 
+// slots of the last draw whose world positions were reused or computed again
+struct VertexCacheStats {
+    int hits = 0;
+    int misses = 0;
+};
+
+enum ClippingMode {
+    ClippingMode_Auto,      // stencil for clips around more than SPINE_STENCIL_CLIP_VERTICES vertices
+    ClippingMode_Cpu,       // SkeletonClipping cuts the triangles
+    ClippingMode_Stencil    // the clip polygon is written to the stencil buffer, the geometry is drawn as is
+};
+
 class SkeletonDrawable {
 public:
     SkeletonDrawable(SpineRender::GLBatchRender *render, SkeletonData *skeleton, AnimationStateData *stateData = nullptr);
@@ -51,6 +66,83 @@ public:
         timeScale = scale;
     }
 
+    // bias added to the mip level of every texture lookup, e.g. 1 for crowds of small skeletons
+    // to sample one level coarser than their on-screen size asks for. needs mipmapped pages
+    float getTextureLodBias() const {
+        return textureLodBias;
+    }
+    void setTextureLodBias(float bias) {
+        textureLodBias = bias;
+    }
+
+    // adds a bias derived from the on-screen scale to the one above: once the textures are drawn at less than
+    // fullDetailScale pixels per texel, each halving of the scale adds 1, up to maxBias. the scale is measured
+    // from the triangles of a draw and used from the next one. a maxBias of 0 turns it off, the default
+    void setAutoTextureLodBias(float fullDetailScale, float maxBias) {
+        autoLodFullDetailScale = fullDetailScale;
+        autoLodMaxBias = maxBias;
+        autoLodBias = 0;
+        screenScale = 0;
+    }
+    float getAutoTextureLodBias() const {
+        return autoLodBias;
+    }
+    // pixels per texel, in the renderer's coordinates, measured by the last draw with the auto bias on. 0 before
+    float getScreenScale() const {
+        return screenScale;
+    }
+
+    // stencil clipping needs a stencil buffer, without one clips are always cut on the CPU.
+    // a vertex effect moves the clipped geometry, so clips under one are cut on the CPU too
+    ClippingMode getClippingMode() const {
+        return clippingMode;
+    }
+    void setClippingMode(ClippingMode mode) {
+        clippingMode = mode;
+    }
+
+    // applied to each attachment with one transformBatch call, not owned
+    VertexEffect *getVertexEffect() const {
+        return vertexEffect;
+    }
+    void setVertexEffect(VertexEffect *effect) {
+        vertexEffect = effect;
+    }
+
+    // JitterVertexEffect and SwirlVertexEffect are evaluated by the vertex shader, not on the CPU.
+    // the shader jitters vertices at the same position alike, so attachments don't tear apart
+    bool getUseShaderEffects() const {
+        return useShaderEffects;
+    }
+    void setUseShaderEffects(bool use) {
+        useShaderEffects = use;
+    }
+
+    // updateWorldTransform skips bones whose transform inputs are unchanged, see Skeleton::setSkipUnchangedBones.
+    // pays off for paused or partly keyed skeletons, off by default
+    bool getSkipUnchangedBones() const {
+        return skeleton->getSkipUnchangedBones();
+    }
+    void setSkipUnchangedBones(bool skip) {
+        skeleton->setSkipUnchangedBones(skip);
+    }
+
+    // world positions of a slot are kept and reused while its attachment, the attachment's geometry
+    // version, its deform and the world transforms of its bones stay the same, e.g. for props or idle
+    // parts. clipped slots and CPU effects skip it. off by default, since it trusts the caller to report
+    // direct edits: Attachment::geometryChanged after changing mesh vertices or bones in place,
+    // Slot::deformChanged after writing Slot::getDeform. region attachments count their updateOffset
+    // calls themselves, animations and setAttachment are tracked. an unreported edit draws stale geometry
+    bool getUseVertexCache() const {
+        return useVertexCache;
+    }
+    void setUseVertexCache(bool use) {
+        useVertexCache = use;
+    }
+    const VertexCacheStats &getVertexCacheStats() const {
+        return vertexCacheStats;
+    }
+
     AnimationState *getState() const {
         return state;
     }
@@ -59,7 +151,30 @@ public:
     }
 
 private:
+    // the positions of a slot's attachment as last computed, and what they were computed from
+    struct SlotVertices {
+        Attachment *attachment = nullptr;
+        unsigned int geometryVersion = 0;
+        unsigned int deformVersion = 0;
+        std::vector<Bone *> bones;
+        std::vector<unsigned int> boneVersions;
+        std::vector<float> positions;   // x, y pairs
+    };
+
     void drawOpengl();
+    // slot of texture in the current batch, draws the batch first if all slots are taken
+    int batchTexture(const SpineRender::OpenGLTexture &texture);
+    void clipStart(unsigned slotIndex, Slot &slot, ClippingAttachment *clip);
+    void clipEnd(Slot &slot);
+    void clipEnd();
+    bool useStencilClip(unsigned slotIndex, ClippingAttachment *clip);
+    // fills _states.effect from vertexEffect, false when the CPU has to apply it
+    bool setShaderEffect();
+    bool hasDarkColors();
+    bool isCurrent(const SlotVertices &cache, Slot &slot, Attachment *attachment);
+    void storePositions(SlotVertices &cache, Slot &slot, Attachment *attachment, size_t firstVertex, int count);
+    // adds the areas of the triangles from firstIndex on, in the renderer's coordinates and in texels
+    void addTriangleAreas(size_t firstIndex, const SpineRender::OpenGLTexture &texture, float &area, float &texelArea);
 
 private:
     mutable bool ownsAnimationStateData;
@@ -73,7 +188,23 @@ private:
     Skeleton *skeleton;
     AnimationState *state;
     float timeScale;
+    float textureLodBias;
+    float autoLodFullDetailScale;
+    float autoLodMaxBias;
+    float autoLodBias;
+    float screenScale;
+    ClippingMode clippingMode;
+    bool useShaderEffects;
+    bool twoColorTint;
+    bool useVertexCache;
+    VertexCacheStats vertexCacheStats;
+    std::vector<SlotVertices> slotVertices;    // by slot index
+    Skeleton *cachedSkeleton;
+    ClippingAttachment *stencilClip;
+    Vector<float> clipPolygon;
     Vector<SpineRender::OpenGLVertex> vertexArray;
+    Vector<unsigned short> indexArray;
+    Vector<SpineRender::OpenGLDarkColor> darkColors;   // one per vertex of vertexArray when twoColorTint
     VertexEffect *vertexEffect;
 
     SpineRender::OpenGLRenderState _states;
@@ -86,6 +217,24 @@ public:
     OpenGLTextureLoader() = default;
     void load(AtlasPage &page, const String &path) override;
     void unload(void *texture) override;
+
+    // uploads path again into the texture of a page whose texture was released
+    static bool reload(AtlasPage &page, bool dither = true);
+};
+
+// decodes the pages concurrently on the uploader's pool and queues their GL upload,
+// the textures are valid once uploader->pendingCount(this) reaches 0 or after uploader->flush(this)
+class AsyncTextureLoader : public TextureLoader {
+public:
+    // dither smooths the gradients of pages the atlas stores as RGBA4444 or RGB565
+    explicit AsyncTextureLoader(SpineRender::TextureUploader *uploader, bool dither = true)
+        : _uploader(uploader), _dither(dither) {}
+    void load(AtlasPage &page, const String &path) override;
+    void unload(void *texture) override;
+
+private:
+    SpineRender::TextureUploader *_uploader;
+    bool _dither;
 };
 
 }
@@ -0,0 +1,72 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include "SkeletonLoader.h"
+#include "utils/Logger.h"
+
+#include <cstring>
+
+namespace SpineRender {
+
+spine::SkeletonData *SkeletonLoader::readSkeletonData(const char *path, spine::Atlas *atlas, float scale) {
+    size_t pathLen = strlen(path);
+    if (pathLen > 5 && strcmp(path + pathLen - 5, ".skel") == 0) {
+        spine::SkeletonBinary binary(atlas);
+        binary.setScale(scale);
+        binary.setLazyAnimations(true);
+        auto skeletonData = binary.readSkeletonDataFile(path);
+        if (!skeletonData) {
+            LOG_ERROR("readSkeletonDataFile failed: %s\n", binary.getError().buffer());
+        }
+        return skeletonData;
+    }
+
+    spine::SkeletonJson json(atlas);
+    json.setScale(scale);
+    json.setLazyAnimations(true);
+    auto skeletonData = json.readSkeletonDataFile(path);
+    if (!skeletonData) {
+        LOG_ERROR("readSkeletonDataFile failed: %s\n", json.getError().buffer());
+    }
+    return skeletonData;
+}
+
+void SkeletonLoader::prefetchAnimations(const std::vector<spine::SkeletonData *> &skeletons, ThreadPool *pool) {
+    std::vector<spine::Animation *> animations;
+    for (auto *skeletonData : skeletons) {
+        if (!skeletonData) {
+            continue;
+        }
+        spine::Vector<spine::Animation *> &items = skeletonData->getAnimations();
+        for (size_t i = 0; i < items.size(); i++) {
+            animations.push_back(items[i]);
+        }
+    }
+
+    pool->parallelFor(animations.size(), [&animations](size_t i) {
+        if (!animations[i]->load()) {
+            LOG_ERROR("load animation failed: %s", animations[i]->getName().buffer());
+        }
+    });
+}
+
+void SkeletonLoader::readSkeletonDataAll(std::vector<Request> &requests, ThreadPool *pool) {
+    pool->parallelFor(requests.size(), [&requests](size_t i) {
+        Request &request = requests[i];
+        request.skeletonData = readSkeletonData(request.path, request.atlas, request.scale);
+    });
+
+    std::vector<spine::SkeletonData *> skeletons;
+    for (auto &request : requests) {
+        skeletons.push_back(request.skeletonData);
+    }
+    prefetchAnimations(skeletons, pool);
+}
+
+}
@@ -0,0 +1,43 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#ifndef SPINE_RENDER_SKELETONLOADER_H_
+#define SPINE_RENDER_SKELETONLOADER_H_
+
+#include <spine/spine.h>
+#include <vector>
+
+#include "utils/ThreadPool.h"
+
+namespace SpineRender {
+
+// Reads skeleton data, from an exported .json or a .skel binary, off the GL thread.
+// The atlases must be loaded before, their textures are created on the GL thread.
+class SkeletonLoader {
+public:
+    struct Request {
+        const char *path = nullptr;
+        spine::Atlas *atlas = nullptr;
+        float scale = 1.0f;
+        spine::SkeletonData *skeletonData = nullptr;   // result, nullptr on failure
+    };
+
+    // animations are read lazily, on first use or by prefetchAnimations
+    static spine::SkeletonData *readSkeletonData(const char *path, spine::Atlas *atlas, float scale);
+
+    // read the animations of all skeletons in parallel, one task per animation
+    static void prefetchAnimations(const std::vector<spine::SkeletonData *> &skeletons, ThreadPool *pool);
+
+    // read the files concurrently, then prefetch all their animations
+    static void readSkeletonDataAll(std::vector<Request> &requests, ThreadPool *pool);
+};
+
+}
+
+#endif //SPINE_RENDER_SKELETONLOADER_H_
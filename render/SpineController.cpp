@@ -8,58 +8,212 @@
  */
 
 #include "SpineController.h"
+#include "ResourceCache.h"
+#include "SkeletonLoader.h"
+#include "TextureCache.h"
 #include "utils/Logger.h"
 
-char SpineRender::Logger::buf[MAX_LOG_LENGTH] = {};
+#include <atomic>
+#include <mutex>
+#include <string>
+
 void *SpineRender::Logger::logContext = nullptr;
 SpineRender::LogFunc SpineRender::Logger::logFunc = nullptr;
 
-spine::SkeletonData *SpineController::spineReadSkeletonJsonData(const spine::String &filename,
-                                                                spine::Atlas *atlas,
-                                                                float scale) {
-    spine::SkeletonJson json(atlas);
-    json.setScale(scale);
-    auto skeletonData = json.readSkeletonDataFile(filename);
-    if (!skeletonData) {
-        LOG_ERROR("readSkeletonDataFile failed: %s\n", json.getError().buffer());
-        return nullptr;
+static std::atomic<bool> textureDither(true);
+
+struct SpineController::AsyncLoad {
+    std::mutex mutex;
+    bool done = false;
+    // set by spineDestroy while loading, the loader thread then releases the results itself
+    bool canceled = false;
+
+    // results, written by the loader thread before done
+    spine::Atlas *atlas = nullptr;
+    spine::SkeletonData *skeletonData = nullptr;
+    spine::TextureLoader *textureLoader = nullptr;
+
+    std::string atlasPath;
+    std::string skin;
+    float posX = 0.0f;
+    float posY = 0.0f;
+    bool usePMA = true;
+    float timeScale = 1.0f;
+    CreateCallback callback;
+};
+
+// compressed pages only take their block size on the GPU
+static void logTextureMemory(const char *atlasPath, spine::Atlas *atlas) {
+    size_t gpuBytes = 0;
+    size_t rgbaBytes = 0;
+    spine::Vector<spine::AtlasPage *> &pages = atlas->getPages();
+    for (size_t i = 0; i < pages.size(); i++) {
+        auto *texture = (SpineRender::OpenGLTexture *) pages[i]->getRendererObject();
+        if (texture) {
+            gpuBytes += texture->byteSize;
+            rgbaBytes += (size_t) texture->width * texture->height * 4;
+        }
     }
-    return skeletonData;
+    LOG_INFO("%s: %d pages, %.1f MB of textures, %.1f MB as RGBA8",
+             atlasPath, (int) pages.size(), gpuBytes / 1048576.0, rgbaBytes / 1048576.0);
 }
 
 bool SpineController::spineCreate(const char *atlasPath,
-                                  const char *jsonPath,
+                                  const char *skeletonPath,
                                   const char *skin,
                                   float posX,
                                   float posY,
                                   float scale,
                                   bool usePMA,
                                   float timeScale) {
-    _textureLoader = new spine::OpenGLTextureLoader();
-    _atlas = new spine::Atlas(atlasPath, _textureLoader);
-    if (_atlas->getPages().size() == 0) {
+    // the pages are decoded concurrently on the loader pool, or shared with other controllers
+    _atlas = SpineRender::ResourceCache::acquireAtlas(atlasPath, textureUploader(), textureDither);
+    if (_atlas == nullptr) {
         LOG_ERROR("Failed to load atlas");
         return false;
     }
+    _textureLoader = SpineRender::ResourceCache::textureLoader(_atlas);
+    textureUploader()->flush(_textureLoader);
+    logTextureMemory(atlasPath, _atlas);
 
-    _skeletonData = spineReadSkeletonJsonData(jsonPath, _atlas, scale);
+    _skeletonData = SpineRender::ResourceCache::acquireSkeletonData(skeletonPath, _atlas, scale);
     if (_skeletonData == nullptr) {
         return false;
     }
 
+    createDrawable(skin, posX, posY, usePMA, timeScale);
+    return true;
+}
+
+bool SpineController::spineCreateAsync(const char *atlasPath,
+                                       const char *skeletonPath,
+                                       const CreateCallback &callback,
+                                       const char *skin,
+                                       float posX,
+                                       float posY,
+                                       float scale,
+                                       bool usePMA,
+                                       float timeScale) {
+    if (_asyncLoad) {
+        LOG_ERROR("spine resources are already loading");
+        return false;
+    }
+
+    auto load = std::make_shared<AsyncLoad>();
+    load->atlasPath = atlasPath;
+    load->skin = skin;
+    load->posX = posX;
+    load->posY = posY;
+    load->usePMA = usePMA;
+    load->timeScale = timeScale;
+    load->callback = callback;
+    _asyncLoad = load;
+
+    std::string atlasFile(atlasPath);
+    std::string skeletonFile(skeletonPath);
+    bool dither = textureDither;
+
+    loaderPool()->post([load, atlasFile, skeletonFile, scale, dither] {
+        auto *atlas = SpineRender::ResourceCache::acquireAtlas(atlasFile.c_str(), textureUploader(), dither);
+        spine::TextureLoader *textureLoader = nullptr;
+        spine::SkeletonData *skeletonData = nullptr;
+        if (atlas == nullptr) {
+            LOG_ERROR("Failed to load atlas");
+        } else {
+            textureLoader = SpineRender::ResourceCache::textureLoader(atlas);
+            skeletonData = SpineRender::ResourceCache::acquireSkeletonData(skeletonFile.c_str(), atlas, scale);
+            if (skeletonData) {
+                SpineRender::SkeletonLoader::prefetchAnimations({skeletonData}, loaderPool());
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(load->mutex);
+            if (!load->canceled) {
+                load->atlas = atlas;
+                load->skeletonData = skeletonData;
+                load->textureLoader = textureLoader;
+                load->done = true;
+                return;
+            }
+        }
+        // nobody takes the results any more, the textures they evict are deleted on the GL thread
+        SpineRender::ResourceCache::releaseSkeletonData(skeletonData);
+        SpineRender::ResourceCache::releaseAtlas(atlas);
+    });
+
+    return true;
+}
+
+void SpineController::createDrawable(const char *skin, float posX, float posY, bool usePMA, float timeScale) {
     _drawable = new spine::SkeletonDrawable(_batchRender, _skeletonData);
     _drawable->setTimeScale(timeScale);
     _drawable->setUsePremultipliedAlpha(usePMA);
+    _drawable->setTextureLodBias(_textureLodBias);
+    _drawable->setAutoTextureLodBias(_autoLodFullDetailScale, _autoLodMaxBias);
+    _drawable->setSkipUnchangedBones(_skipUnchangedBones);
 
     spine::Skeleton *skeleton = _drawable->getSkeleton();
     skeleton->setPosition(posX, posY);
     skeleton->setSkin(skin);
     skeleton->updateWorldTransform();
+}
 
-    return true;
+void SpineController::checkAsyncLoad() {
+    if (!_asyncLoad) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(_asyncLoad->mutex);
+        if (!_asyncLoad->done) {
+            return;
+        }
+    }
+    // the skeleton may only be drawn once all its pages are on the GPU
+    if (_asyncLoad->skeletonData && textureUploader()->pendingCount(_asyncLoad->textureLoader) > 0) {
+        return;
+    }
+
+    std::shared_ptr<AsyncLoad> load = std::move(_asyncLoad);
+    _atlas = load->atlas;
+    _skeletonData = load->skeletonData;
+    _textureLoader = load->textureLoader;
+    if (_skeletonData) {
+        logTextureMemory(load->atlasPath.c_str(), _atlas);
+        createDrawable(load->skin.c_str(), load->posX, load->posY, load->usePMA, load->timeScale);
+    }
+    if (load->callback) {
+        load->callback(_skeletonData != nullptr);
+    }
+}
+
+void SpineController::spineSetTextureLodBias(float bias) {
+    _textureLodBias = bias;
+    if (_drawable) {
+        _drawable->setTextureLodBias(bias);
+    }
+}
+
+void SpineController::spineSetAutoTextureLodBias(float fullDetailScale, float maxBias) {
+    _autoLodFullDetailScale = fullDetailScale;
+    _autoLodMaxBias = maxBias;
+    if (_drawable) {
+        _drawable->setAutoTextureLodBias(fullDetailScale, maxBias);
+    }
+}
+
+void SpineController::spineSetSkipUnchangedBones(bool skip) {
+    _skipUnchangedBones = skip;
+    if (_drawable) {
+        _drawable->setSkipUnchangedBones(skip);
+    }
 }
 
 bool SpineController::spineSetAnimation(const char *animationName, int trackIndex, bool loop) {
+    if (_drawable == nullptr) {
+        LOG_ERROR("spine resources not loaded");
+        return false;
+    }
     spine::Animation *animation = _skeletonData->findAnimation(animationName);
     if (animation == nullptr) {
         LOG_ERROR("Failed to find animation: %s", animationName);
@@ -71,6 +225,7 @@ bool SpineController::spineSetAnimation(const char *animationName, int trackInde
 }
 
 void SpineController::spineDraw(float dt) {
+    checkAsyncLoad();
     if (_drawable) {
         _drawable->update(dt);
         _drawable->draw();
@@ -78,8 +233,59 @@ void SpineController::spineDraw(float dt) {
 }
 
 void SpineController::spineDestroy() {
-    SAFE_DELETE(_skeletonData)
-    SAFE_DELETE(_atlas)
+    // a load still in progress is handed off to the loader thread instead of waited for
+    if (_asyncLoad) {
+        std::lock_guard<std::mutex> lock(_asyncLoad->mutex);
+        if (_asyncLoad->done) {
+            _atlas = _asyncLoad->atlas;
+            _skeletonData = _asyncLoad->skeletonData;
+            _textureLoader = _asyncLoad->textureLoader;
+        } else {
+            _asyncLoad->canceled = true;
+        }
+    }
+    _asyncLoad.reset();
+
+    // the animation state releases its animations, delete it before the skeleton data
     SAFE_DELETE(_drawable)
-    SAFE_DELETE(_textureLoader)
+    SpineRender::ResourceCache::releaseSkeletonData(_skeletonData);
+    SpineRender::ResourceCache::releaseAtlas(_atlas);
+    _skeletonData = nullptr;
+    _atlas = nullptr;
+    _textureLoader = nullptr;
+}
+
+void SpineController::spineProcessUploads(float budgetMs) {
+    textureUploader()->process(budgetMs);
+}
+
+void SpineController::spineSetTextureCache(const char *dir, size_t maxBytes) {
+    SpineRender::TextureCache::setDirectory(dir ? dir : "", maxBytes);
+}
+
+void SpineController::spineSetResourceBudget(size_t maxBytes) {
+    SpineRender::ResourceCache::setBudget(maxBytes);
+}
+
+SpineRender::ResourceCache::Stats SpineController::spineResourceStats() {
+    return SpineRender::ResourceCache::stats();
+}
+
+void SpineController::spineContextLost() {
+    textureUploader()->contextLost();
+    SpineRender::ResourceCache::contextLost();
+}
+
+void SpineController::spineSetTextureDither(bool dither) {
+    textureDither = dither;
+}
+
+SpineRender::ThreadPool *SpineController::loaderPool() {
+    static SpineRender::ThreadPool pool;
+    return &pool;
+}
+
+SpineRender::TextureUploader *SpineController::textureUploader() {
+    static SpineRender::TextureUploader uploader(loaderPool());
+    return &uploader;
 }
@@ -10,11 +10,20 @@
 #ifndef SPINE_RENDER_SPINECONTROLLER_H_
 #define SPINE_RENDER_SPINECONTROLLER_H_
 
+#include <functional>
+#include <memory>
+
 #include "SkeletonDrawable.h"
 #include "GLBatchRender.h"
+#include "ResourceCache.h"
+#include "TextureUploader.h"
+#include "utils/ThreadPool.h"
 
 class SpineController {
 public:
+    // called on the GL thread, from spineDraw, once the skeleton can be drawn or failed to load
+    typedef std::function<void(bool success)> CreateCallback;
+
     SpineController(int width, int height) : _batchRender(new SpineRender::GLBatchRender()) {
         _batchRender->create(width, height);
     }
@@ -25,28 +34,78 @@ public:
         _batchRender = nullptr;
     }
 
+    // skeletonPath may be an exported .json or a .skel binary (see Converter)
     bool spineCreate(const char *atlasPath,
-                     const char *jsonPath,
+                     const char *skeletonPath,
                      const char *skin = "default",
                      float posX = 0.0f,
                      float posY = 0.0f,
                      float scale = 1.0f,
                      bool usePMA = true,
                      float timeScale = 1.0f);
+    // same as spineCreate, but the files are parsed and the pages decoded on the loader threads,
+    // only the texture uploads happen on the GL thread, in spineProcessUploads.
+    // returns false if a load is already in progress
+    bool spineCreateAsync(const char *atlasPath,
+                          const char *skeletonPath,
+                          const CreateCallback &callback,
+                          const char *skin = "default",
+                          float posX = 0.0f,
+                          float posY = 0.0f,
+                          float scale = 1.0f,
+                          bool usePMA = true,
+                          float timeScale = 1.0f);
     bool spineSetAnimation(const char *animationName, int trackIndex = 0, bool loop = true);
+    // mip level bias of this skeleton's textures, positive values sample blurrier levels.
+    // only has an effect on atlas pages with a MipMap min filter
+    void spineSetTextureLodBias(float bias);
+    // derive a further bias from the on-screen scale, see SkeletonDrawable::setAutoTextureLodBias,
+    // e.g. (0.5, 2) for crowds: from half a pixel per texel on, smaller skeletons sample up to 2 levels coarser
+    void spineSetAutoTextureLodBias(float fullDetailScale, float maxBias);
+    // skip the bones an animation leaves unchanged, see SkeletonDrawable::setSkipUnchangedBones
+    void spineSetSkipUnchangedBones(bool skip);
     void spineDraw(float dt);
+    // doesn't wait for a spineCreateAsync in progress, its loader thread releases what it loaded
     void spineDestroy();
 
+    // call once per frame on the GL thread, uploads the textures decoded by spineCreateAsync
+    // for at most budgetMs (at least one texture), shared by all controllers
+    static void spineProcessUploads(float budgetMs = 2.0f);
+
+    // keep decoded atlas pages in dir, up to maxBytes, so later launches skip the png decode.
+    // disabled by default, pass a writable cache directory (not the app bundle)
+    static void spineSetTextureCache(const char *dir, size_t maxBytes = 256 << 20);
+
+    // atlases and skeleton data are shared by all controllers loading the same files, pages of
+    // atlases no controller uses stay on the GPU until all pages take more than maxBytes
+    static void spineSetResourceBudget(size_t maxBytes);
+    static SpineRender::ResourceCache::Stats spineResourceStats();
+    // GL thread, when the context is destroyed or lost (e.g. a new EGL context per surface):
+    // cached pages are forgotten without calling GL, those still in use load again into the next context
+    static void spineContextLost();
+
+    // ordered dithering of the pages an atlas stores as RGBA4444 or RGB565, on by default
+    static void spineSetTextureDither(bool dither);
+
+    static SpineRender::ThreadPool *loaderPool();
+    static SpineRender::TextureUploader *textureUploader();
+
 private:
-    static spine::SkeletonData *spineReadSkeletonJsonData(const spine::String &filename,
-                                                          spine::Atlas *atlas,
-                                                          float scale);
+    struct AsyncLoad;
+
+    void createDrawable(const char *skin, float posX, float posY, bool usePMA, float timeScale);
+    void checkAsyncLoad();
 
 private:
-    spine::OpenGLTextureLoader *_textureLoader = nullptr;
+    spine::TextureLoader *_textureLoader = nullptr;     // owned by the ResourceCache
     spine::SkeletonData *_skeletonData = nullptr;
     spine::Atlas *_atlas = nullptr;
     spine::SkeletonDrawable *_drawable = nullptr;
+    std::shared_ptr<AsyncLoad> _asyncLoad;
+    float _textureLodBias = 0.0f;
+    float _autoLodFullDetailScale = 1.0f;
+    float _autoLodMaxBias = 0.0f;
+    bool _skipUnchangedBones = false;
 
     SpineRender::GLBatchRender *_batchRender = nullptr;
 };
@@ -0,0 +1,231 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include "TextureCache.h"
+#include "utils/Logger.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <mutex>
+#include <vector>
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+namespace SpineRender {
+
+#define CACHE_MAGIC     0x43545053  // "SPTC"
+#define CACHE_VERSION   1
+#define CACHE_EXTENSION ".sptc"
+
+struct CacheHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t width;
+    uint32_t height;
+    uint64_t pathHash;
+    uint64_t sourceLength;
+    uint64_t sourceHash;
+};
+
+static std::mutex cacheMutex;
+static std::string cacheDir;
+static size_t cacheMaxBytes = 0;
+
+// FNV-1a
+static uint64_t hashBytes(const char *data, size_t length) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char) data[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+static std::string entryPath(const std::string &dir, uint64_t pathHash) {
+    char name[32];
+    snprintf(name, sizeof(name), "/%016llx", (unsigned long long) pathHash);
+    return dir + name + CACHE_EXTENSION;
+}
+
+static std::string directory() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return cacheDir;
+}
+
+static bool writeAll(int fd, const void *data, size_t length) {
+    const char *p = (const char *) data;
+    while (length > 0) {
+        ssize_t n = write(fd, p, length);
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        length -= (size_t) n;
+    }
+    return true;
+}
+
+// drop the least recently used entries until the directory fits in cacheMaxBytes
+static void evict(const std::string &dir) {
+    struct Entry {
+        std::string path;
+        size_t size;
+        time_t lastUse;
+    };
+    std::vector<Entry> entries;
+    size_t total = 0;
+
+    DIR *d = opendir(dir.c_str());
+    if (!d) {
+        return;
+    }
+    size_t extLen = strlen(CACHE_EXTENSION);
+    while (struct dirent *e = readdir(d)) {
+        size_t len = strlen(e->d_name);
+        if (len <= extLen || strcmp(e->d_name + len - extLen, CACHE_EXTENSION) != 0) {
+            continue;
+        }
+        std::string path = dir + "/" + e->d_name;
+        struct stat st;
+        if (stat(path.c_str(), &st) == 0) {
+            entries.push_back({path, (size_t) st.st_size, st.st_mtime});
+            total += (size_t) st.st_size;
+        }
+    }
+    closedir(d);
+
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    if (total <= cacheMaxBytes) {
+        return;
+    }
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+        return a.lastUse < b.lastUse;
+    });
+    for (auto &entry : entries) {
+        if (total <= cacheMaxBytes) {
+            break;
+        }
+        if (unlink(entry.path.c_str()) == 0) {
+            total -= entry.size;
+        }
+    }
+}
+
+void TextureCache::setDirectory(const std::string &dir, size_t maxBytes) {
+    if (!dir.empty()) {
+        mkdir(dir.c_str(), 0755);
+    }
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    cacheDir = dir;
+    cacheMaxBytes = maxBytes;
+}
+
+bool TextureCache::enabled() {
+    std::lock_guard<std::mutex> lock(cacheMutex);
+    return !cacheDir.empty();
+}
+
+bool TextureCache::load(const char *path, const char *data, int length, OpenGLImage *image) {
+    std::string dir = directory();
+    if (dir.empty()) {
+        return false;
+    }
+
+    uint64_t pathHash = hashBytes(path, strlen(path));
+    std::string file = entryPath(dir, pathHash);
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0 || (size_t) st.st_size < sizeof(CacheHeader)) {
+        close(fd);
+        return false;
+    }
+    void *mapped = mmap(nullptr, (size_t) st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapped == MAP_FAILED) {
+        return false;
+    }
+
+    CacheHeader header;
+    memcpy(&header, mapped, sizeof(header));
+    bool valid = header.magic == CACHE_MAGIC
+                 && header.version == CACHE_VERSION
+                 && header.pathHash == pathHash
+                 && header.sourceLength == (uint64_t) length
+                 && (size_t) st.st_size == sizeof(CacheHeader) + (size_t) header.width * header.height * 4
+                 && header.sourceHash == hashBytes(data, (size_t) length);
+    if (!valid) {
+        munmap(mapped, (size_t) st.st_size);
+        return false;
+    }
+
+    // the modification time orders entries for eviction
+    utimes(file.c_str(), nullptr);
+
+    image->width = (int) header.width;
+    image->height = (int) header.height;
+    image->pixels = (unsigned char *) mapped + sizeof(CacheHeader);
+    image->mapped = mapped;
+    image->mappedLength = (size_t) st.st_size;
+    return true;
+}
+
+void TextureCache::store(const char *path, const char *data, int length, const OpenGLImage &image) {
+    std::string dir = directory();
+    if (dir.empty() || image.pixels == nullptr) {
+        return;
+    }
+
+    CacheHeader header;
+    header.magic = CACHE_MAGIC;
+    header.version = CACHE_VERSION;
+    header.width = (uint32_t) image.width;
+    header.height = (uint32_t) image.height;
+    header.pathHash = hashBytes(path, strlen(path));
+    header.sourceLength = (uint64_t) length;
+    header.sourceHash = hashBytes(data, (size_t) length);
+
+    // write a temporary file and rename it, readers never see a partial entry
+    std::string file = entryPath(dir, header.pathHash);
+    std::string tmpFile = file + ".XXXXXX";
+    std::vector<char> tmpName(tmpFile.begin(), tmpFile.end());
+    tmpName.push_back('\0');
+    int fd = mkstemp(tmpName.data());
+    if (fd < 0) {
+        LOG_ERROR("texture cache: failed to create %s", tmpName.data());
+        return;
+    }
+    bool ok = writeAll(fd, &header, sizeof(header))
+              && writeAll(fd, image.pixels, (size_t) image.width * image.height * 4);
+    close(fd);
+    if (!ok || rename(tmpName.data(), file.c_str()) != 0) {
+        LOG_ERROR("texture cache: failed to write %s", file.c_str());
+        unlink(tmpName.data());
+        return;
+    }
+
+    evict(dir);
+}
+
+void TextureCache::unmap(OpenGLImage *image) {
+    munmap(image->mapped, image->mappedLength);
+    image->mapped = nullptr;
+    image->mappedLength = 0;
+    image->pixels = nullptr;
+}
+
+}
@@ -0,0 +1,38 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#ifndef SPINE_RENDER_TEXTURECACHE_H_
+#define SPINE_RENDER_TEXTURECACHE_H_
+
+#include <string>
+
+#include "GLBatchRender.h"
+
+namespace SpineRender {
+
+// Keeps decoded, premultiplied RGBA pages on disk, so later launches map them straight into
+// glTexImage2D instead of decoding the png again. Entries are keyed by the page path and
+// validated against the length and hash of the source file, the least recently used entries
+// are evicted once the directory grows past its size cap. Safe to use from any thread.
+class TextureCache {
+public:
+    // an empty dir disables the cache, which is the default
+    static void setDirectory(const std::string &dir, size_t maxBytes);
+    static bool enabled();
+
+    // maps the cached pixels of the source file content into image, release with freeImage
+    static bool load(const char *path, const char *data, int length, OpenGLImage *image);
+    static void store(const char *path, const char *data, int length, const OpenGLImage &image);
+
+    static void unmap(OpenGLImage *image);
+};
+
+}
+
+#endif //SPINE_RENDER_TEXTURECACHE_H_
@@ -0,0 +1,258 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#include "TextureUploader.h"
+#include "utils/Logger.h"
+
+#include <algorithm>
+#include <chrono>
+
+namespace SpineRender {
+
+TextureUploader::~TextureUploader() {
+    // decode tasks still reference this
+    std::unique_lock<std::mutex> lock(mutex_);
+    cond_.wait(lock, [this] { return decoding_ == 0; });
+    for (auto &upload : uploads_) {
+        GLBatchRender::freeImage(&upload.image);
+    }
+    uploads_.clear();
+    // the GL context may be gone already, a partial texture is left to it
+    if (hasActive_) {
+        GLBatchRender::freeImage(&active_.image);
+    }
+    for (OpenGLTexture *texture : released_) {
+        delete texture;
+    }
+}
+
+void TextureUploader::load(const void *owner, OpenGLTexture *texture, const std::string &path,
+                           unsigned int glFormat, unsigned int glType, bool dither) {
+    unsigned long long id;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        id = nextId_++;
+        uploads_.push_back({id, owner, texture, OpenGLImage(), false});
+        decoding_++;
+    }
+
+    pool_->post([this, id, path, glFormat, glType, dither] {
+        OpenGLImage image;
+        if (!GLBatchRender::decodeImage(path.c_str(), &image)) {
+            LOG_ERROR("decode texture failed: %s", path.c_str());
+        } else {
+            GLBatchRender::convertImage(&image, glFormat, glType, dither);
+        }
+        decoded(id, image);
+    });
+}
+
+void TextureUploader::decoded(unsigned long long id, const OpenGLImage &image) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    bool found = false;
+    for (auto &upload : uploads_) {
+        if (upload.id == id) {
+            upload.image = image;
+            upload.decoded = true;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        // cancelled while decoding
+        OpenGLImage unused = image;
+        GLBatchRender::freeImage(&unused);
+    }
+    decoding_--;
+    cond_.notify_all();
+}
+
+void TextureUploader::upload(Upload &upload) {
+    // a failed decode leaves the texture empty, as OpenGLTextureLoader does
+    if (upload.image.pixels) {
+        GLBatchRender::uploadTexture(upload.image, upload.texture);
+    }
+    GLBatchRender::freeImage(&upload.image);
+}
+
+bool TextureUploader::uploadStrip(bool all) {
+    const OpenGLImage &image = active_.image;
+    size_t rowBytes = GLBatchRender::imageByteSize(image) / image.height;
+    int rows = image.height - activeRows_;
+    if (!all) {
+        rows = std::min(rows, std::max(1, (int) (UPLOAD_STRIP_BYTES / rowBytes)));
+    }
+    GLBatchRender::uploadTextureRows(activeTextureId_, image, activeRows_, rows);
+    activeRows_ += rows;
+    return activeRows_ == image.height;
+}
+
+void TextureUploader::finishActive() {
+    GLBatchRender::finishTexture(active_.image, activeTextureId_, active_.texture);
+    GLBatchRender::freeImage(&active_.image);
+    activeTextureId_ = 0;
+    std::lock_guard<std::mutex> lock(mutex_);
+    hasActive_ = false;
+}
+
+size_t TextureUploader::process(float budgetMs) {
+    auto start = std::chrono::steady_clock::now();
+    deleteReleased();
+    while (true) {
+        if (!hasActive_) {
+            Upload next;
+            {
+                std::lock_guard<std::mutex> lock(mutex_);
+                auto it = uploads_.begin();
+                while (it != uploads_.end() && !it->decoded) {
+                    ++it;
+                }
+                if (it == uploads_.end()) {
+                    return uploads_.size();
+                }
+                next = *it;
+                uploads_.erase(it);
+            }
+
+            // decoding and uploading don't block each other, cancel() is only called on this thread
+            const OpenGLImage &image = next.image;
+            if (!image.pixels || image.compressedFormat != 0
+                || GLBatchRender::imageByteSize(image) <= UPLOAD_STRIP_BYTES) {
+                upload(next);
+            } else {
+                activeTextureId_ = GLBatchRender::allocTexture(image);
+                activeRows_ = 0;
+                std::lock_guard<std::mutex> lock(mutex_);
+                active_ = next;
+                hasActive_ = true;
+            }
+        }
+
+        if (hasActive_ && uploadStrip(false)) {
+            finishActive();
+        }
+
+        std::chrono::duration<float, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        if (elapsed.count() >= budgetMs) {
+            break;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    return uploads_.size() + (hasActive_ ? 1 : 0);
+}
+
+void TextureUploader::flush(const void *owner) {
+    deleteReleased();
+    if (hasActive_ && active_.owner == owner) {
+        uploadStrip(true);
+        finishActive();
+    }
+
+    std::deque<Upload> ready;
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cond_.wait(lock, [this, owner] {
+            for (auto &upload : uploads_) {
+                if (upload.owner == owner && !upload.decoded) {
+                    return false;
+                }
+            }
+            return true;
+        });
+        for (auto it = uploads_.begin(); it != uploads_.end();) {
+            if (it->owner == owner) {
+                ready.push_back(*it);
+                it = uploads_.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    for (auto &next : ready) {
+        upload(next);
+    }
+}
+
+size_t TextureUploader::pendingCount(const void *owner) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    size_t count = 0;
+    for (auto &upload : uploads_) {
+        if (upload.owner == owner) {
+            count++;
+        }
+    }
+    if (hasActive_ && active_.owner == owner) {
+        count++;
+    }
+    return count;
+}
+
+void TextureUploader::cancel(const OpenGLTexture *texture) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (hasActive_ && active_.texture == texture) {
+        // the partial texture was never published to texture
+        OpenGLTexture partial;
+        partial.textureId = activeTextureId_;
+        GLBatchRender::releaseTexture(&partial);
+        GLBatchRender::freeImage(&active_.image);
+        activeTextureId_ = 0;
+        hasActive_ = false;
+        return;
+    }
+    dropQueued(texture);
+}
+
+bool TextureUploader::dropQueued(const OpenGLTexture *texture) {
+    for (auto it = uploads_.begin(); it != uploads_.end(); ++it) {
+        if (it->texture == texture) {
+            GLBatchRender::freeImage(&it->image);
+            uploads_.erase(it);
+            return true;
+        }
+    }
+    return false;
+}
+
+void TextureUploader::release(OpenGLTexture *texture) {
+    if (!texture) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    dropQueued(texture);
+    released_.push_back(texture);
+}
+
+void TextureUploader::deleteReleased() {
+    std::vector<OpenGLTexture *> released;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        released.swap(released_);
+    }
+    for (OpenGLTexture *texture : released) {
+        // a texture streamed in strips is still active
+        cancel(texture);
+        GLBatchRender::releaseTexture(texture);
+        delete texture;
+    }
+}
+
+void TextureUploader::contextLost() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (hasActive_) {
+        // its partial texture was a name of the lost context, nothing to delete
+        uploads_.push_front(active_);
+        activeTextureId_ = 0;
+        hasActive_ = false;
+    }
+    for (OpenGLTexture *texture : released_) {
+        texture->textureId = 0;
+    }
+}
+
+}
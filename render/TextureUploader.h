@@ -0,0 +1,98 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#ifndef SPINE_RENDER_TEXTUREUPLOADER_H_
+#define SPINE_RENDER_TEXTUREUPLOADER_H_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "GLBatchRender.h"
+#include "utils/ThreadPool.h"
+
+// bytes uploaded per glTexSubImage2D by TextureUploader::process, around half a millisecond of
+// transfer on mobile GPUs
+#define UPLOAD_STRIP_BYTES (512 * 1024)
+
+namespace SpineRender {
+
+// Decodes textures on the pool, concurrently, then holds them until the GL thread uploads them.
+class TextureUploader {
+public:
+    explicit TextureUploader(ThreadPool *pool) : pool_(pool) {}
+    ~TextureUploader();
+
+    // any thread, decodes path on the pool, converts it to glFormat/glType (see GLBatchRender::convertImage)
+    // and queues its upload into texture
+    void load(const void *owner, OpenGLTexture *texture, const std::string &path,
+              unsigned int glFormat = GL_RGBA, unsigned int glType = GL_UNSIGNED_BYTE, bool dither = true);
+
+    // GL thread, uploads decoded textures until budgetMs is spent. large pages go up in strips of
+    // UPLOAD_STRIP_BYTES over several calls, at least one strip per call, and are published to
+    // their texture once complete, the renderer samples a transparent placeholder until then.
+    // returns the number of textures still queued
+    size_t process(float budgetMs);
+
+    // GL thread, waits for the decodes of owner and uploads all of its textures
+    void flush(const void *owner);
+
+    // number of textures loaded by owner and not uploaded yet
+    size_t pendingCount(const void *owner);
+
+    // drop the decode and upload of texture, if still queued
+    void cancel(const OpenGLTexture *texture);
+
+    // any thread, drops the upload of texture and deletes it with its GL texture on the GL thread,
+    // in the next process or flush
+    void release(OpenGLTexture *texture);
+
+    // GL thread, the context went away: a texture streamed in strips starts over in the next one
+    void contextLost();
+
+private:
+    struct Upload {
+        unsigned long long id;
+        const void *owner;
+        OpenGLTexture *texture;
+        OpenGLImage image;
+        bool decoded;
+    };
+
+    void decoded(unsigned long long id, const OpenGLImage &image);
+    static void upload(Upload &upload);
+    // mutex_ held, frees the queued upload of texture, returns false if it has none
+    bool dropQueued(const OpenGLTexture *texture);
+    // GL thread, deletes the textures handed to release
+    void deleteReleased();
+    // uploads the next strip of active_, returns true once it is complete
+    bool uploadStrip(bool all);
+    void finishActive();
+
+private:
+    ThreadPool *pool_;
+    std::deque<Upload> uploads_;
+    std::vector<OpenGLTexture *> released_;
+    // the upload streamed in strips, only touched on the GL thread. hasActive_ is guarded by
+    // mutex_ so pendingCount still counts it
+    Upload active_;
+    unsigned int activeTextureId_ = 0;
+    int activeRows_ = 0;
+    bool hasActive_ = false;
+    unsigned long long nextId_ = 0;
+    size_t decoding_ = 0;
+    std::mutex mutex_;
+    std::condition_variable cond_;
+};
+
+}
+
+#endif //SPINE_RENDER_TEXTUREUPLOADER_H_
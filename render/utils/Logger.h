@@ -43,6 +43,8 @@ public:
     }
 
     static void log(LogLevel level, const char *file, int line, const char *message, ...) {
+        // on the stack, loading threads log too
+        char buf[MAX_LOG_LENGTH];
         va_list argPtr;
         va_start(argPtr, message);
         vsnprintf(buf, MAX_LOG_LENGTH - 1, message, argPtr);
@@ -72,8 +74,6 @@ public:
 private:
     static void *logContext;
     static LogFunc logFunc;
-
-    static char buf[MAX_LOG_LENGTH];
 };
 
 }
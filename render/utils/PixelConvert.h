@@ -0,0 +1,71 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#ifndef SPINE_RENDER_PIXELCONVERT_H
+#define SPINE_RENDER_PIXELCONVERT_H
+
+#include <cstddef>
+#include <cstdint>
+
+namespace SpineRender {
+
+// 4x4 bayer matrix, thresholds of an ordered dither
+static const unsigned char bayer4x4[4][4] = {
+    {0, 8, 2, 10},
+    {12, 4, 14, 6},
+    {3, 11, 1, 9},
+    {15, 7, 13, 5}
+};
+
+// 8 bit value to `levels` + 1 steps, rounded or offset by the dither threshold at (x, y)
+inline unsigned int quantize(unsigned int v, unsigned int levels, int x, int y, bool dither) {
+    unsigned int bias = dither ? (bayer4x4[y & 3][x & 3] * 2 + 1) * 255 / 32 : 127;
+    return (v * levels + bias) / 255;
+}
+
+// premultiplied RGBA8 to 16 bit RGBA4444, color is kept at or below alpha
+inline void convertToRGBA4444(const unsigned char *rgba, int width, int height, bool dither, uint16_t *out) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++, rgba += 4) {
+            unsigned int a = quantize(rgba[3], 15, x, y, dither);
+            unsigned int r = quantize(rgba[0], 15, x, y, dither);
+            unsigned int g = quantize(rgba[1], 15, x, y, dither);
+            unsigned int b = quantize(rgba[2], 15, x, y, dither);
+            r = r > a ? a : r;
+            g = g > a ? a : g;
+            b = b > a ? a : b;
+            *out++ = (uint16_t) ((r << 12) | (g << 8) | (b << 4) | a);
+        }
+    }
+}
+
+// RGBA8 to 16 bit RGB565, alpha is dropped
+inline void convertToRGB565(const unsigned char *rgba, int width, int height, bool dither, uint16_t *out) {
+    for (int y = 0; y < height; y++) {
+        for (int x = 0; x < width; x++, rgba += 4) {
+            unsigned int r = quantize(rgba[0], 31, x, y, dither);
+            unsigned int g = quantize(rgba[1], 63, x, y, dither);
+            unsigned int b = quantize(rgba[2], 31, x, y, dither);
+            *out++ = (uint16_t) ((r << 11) | (g << 5) | b);
+        }
+    }
+}
+
+// RGBA8 to RGB888, alpha is dropped
+inline void convertToRGB888(const unsigned char *rgba, size_t pixelCount, unsigned char *out) {
+    for (size_t i = 0; i < pixelCount; i++, rgba += 4, out += 3) {
+        out[0] = rgba[0];
+        out[1] = rgba[1];
+        out[2] = rgba[2];
+    }
+}
+
+}
+
+#endif //SPINE_RENDER_PIXELCONVERT_H
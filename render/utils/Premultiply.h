@@ -0,0 +1,75 @@
+/*
+ *
+ * Spine OpenGL
+ *
+ * @author 	: keith@robot9.me
+ * @date	: 2021/03/30
+ *
+ */
+
+#ifndef SPINE_RENDER_PREMULTIPLY_H
+#define SPINE_RENDER_PREMULTIPLY_H
+
+#include <cstddef>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define SPINE_PREMULTIPLY_SSE2
+    #include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #define SPINE_PREMULTIPLY_NEON
+    #include <arm_neon.h>
+#endif
+
+namespace SpineRender {
+
+// c * a / 255 rounded to nearest, exact for all 8 bit inputs
+inline unsigned char mulDiv255(unsigned int c, unsigned int a) {
+    unsigned int t = c * a + 128;
+    return (unsigned char) ((t + (t >> 8)) >> 8);
+}
+
+// premultiply RGBA8 pixels in place, alpha is left unchanged
+inline void premultiplyAlpha(unsigned char *rgba, size_t pixelCount) {
+    size_t i = 0;
+
+#if defined(SPINE_PREMULTIPLY_SSE2)
+    // 4 pixels per iteration, each 16 bit lane holds c * a + 128
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(128);
+    const __m128i alphaMask = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    const __m128i alphaOne = _mm_set_epi16(255, 0, 0, 0, 255, 0, 0, 0);
+    for (; i + 4 <= pixelCount; i += 4) {
+        __m128i px = _mm_loadu_si128((const __m128i *) (rgba + i * 4));
+        __m128i halves[2] = {_mm_unpacklo_epi8(px, zero), _mm_unpackhi_epi8(px, zero)};
+        for (auto &c : halves) {
+            __m128i a = _mm_shufflehi_epi16(_mm_shufflelo_epi16(c, 0xFF), 0xFF);
+            a = _mm_or_si128(_mm_andnot_si128(alphaMask, a), alphaOne);
+            __m128i t = _mm_add_epi16(_mm_mullo_epi16(c, a), bias);
+            c = _mm_srli_epi16(_mm_add_epi16(t, _mm_srli_epi16(t, 8)), 8);
+        }
+        _mm_storeu_si128((__m128i *) (rgba + i * 4), _mm_packus_epi16(halves[0], halves[1]));
+    }
+#elif defined(SPINE_PREMULTIPLY_NEON)
+    // 8 pixels per iteration, (t + ((t + 128) >> 8) + 128) >> 8 with t = c * a
+    for (; i + 8 <= pixelCount; i += 8) {
+        uint8x8x4_t px = vld4_u8(rgba + i * 4);
+        for (int ch = 0; ch < 3; ch++) {
+            uint16x8_t t = vmull_u8(px.val[ch], px.val[3]);
+            px.val[ch] = vrshrn_n_u16(vrsraq_n_u16(t, t, 8), 8);
+        }
+        vst4_u8(rgba + i * 4, px);
+    }
+#endif
+
+    for (; i < pixelCount; i++) {
+        unsigned char *p = rgba + i * 4;
+        unsigned int a = p[3];
+        p[0] = mulDiv255(p[0], a);
+        p[1] = mulDiv255(p[1], a);
+        p[2] = mulDiv255(p[2], a);
+    }
+}
+
+}
+
+#endif //SPINE_RENDER_PREMULTIPLY_H
@@ -0,0 +1,138 @@
+#include <stdio.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+#include <spine/spine.h>
+#include <spine/Json.h>
+#include <spine/SkeletonBinaryWriter.h>
+
+using namespace spine;
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+/// Time to parse the document into a Json tree and free it again.
+void benchmarkJsonParse(const char *path, int iterations) {
+	int length = 0;
+	char *text = SpineExtension::readFile(path, &length);
+	if (!text) {
+		printf("Couldn't read %s\n", path);
+		return;
+	}
+	/* readFile doesn't terminate the text */
+	char *json = SpineExtension::alloc<char>(length + 1, __FILE__, __LINE__);
+	memcpy(json, text, length);
+	json[length] = '\0';
+	SpineExtension::free(text, __FILE__, __LINE__);
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		Json *root = new(__FILE__, __LINE__) Json(json);
+		delete root;
+	}
+	double ms = elapsedMs(start) / iterations;
+	SpineExtension::free(json, __FILE__, __LINE__);
+	printf("json parse     %-40s %8.3f ms  %7.1f MB/s\n", path, ms, length / ms / 1000);
+}
+
+/// Time to read SkeletonData from a json file, parsing included.
+void benchmarkJsonLoad(const char *path, const char *atlasPath, int iterations) {
+	Atlas atlas(atlasPath, NULL);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		SkeletonJson json(&atlas);
+		SkeletonData *data = json.readSkeletonDataFile(path);
+		delete data;
+	}
+	printf("json load      %-40s %8.3f ms\n", path, elapsedMs(start) / iterations);
+}
+
+/// Time to read SkeletonData from the .skel the json converts to.
+void benchmarkBinaryLoad(const char *jsonPath, const char *atlasPath, int iterations) {
+	String binaryPath(jsonPath);
+	binaryPath.append(".skel");
+	SkeletonBinaryWriter writer;
+	if (!writer.writeSkeletonDataFile(jsonPath, binaryPath)) {
+		printf("Couldn't convert %s: %s\n", jsonPath, writer.getError().buffer());
+		return;
+	}
+
+	Atlas atlas(atlasPath, NULL);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < iterations; i++) {
+		SkeletonBinary binary(&atlas);
+		SkeletonData *data = binary.readSkeletonDataFile(binaryPath);
+		delete data;
+	}
+	printf("binary load    %-40s %8.3f ms\n", binaryPath.buffer(), elapsedMs(start) / iterations);
+	remove(binaryPath.buffer());
+}
+
+/// Runs task(0 .. count - 1) on threadCount threads.
+template<typename Task>
+static void parallelFor(size_t count, int threadCount, Task task) {
+	std::atomic<size_t> next(0);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < threadCount; t++) {
+		threads.push_back(std::thread([&next, count, &task]() {
+			for (size_t i = next++; i < count; i = next++)
+				task(i);
+		}));
+	}
+	for (size_t t = 0; t < threads.size(); t++)
+		threads[t].join();
+}
+
+/// Total time to read copies of the skeleton on 1, 2, 4, ... threads, the way render/SkeletonLoader does: the files
+/// concurrently with lazy animations, then all their animations concurrently.
+void benchmarkParallelLoad(const char *path, const char *atlasPath, int iterations) {
+	const size_t copies = 16;
+	int maxThreads = (int) std::thread::hardware_concurrency();
+	if (maxThreads < 4) maxThreads = 4;
+	Atlas atlas(atlasPath, NULL);
+	for (int threadCount = 1; threadCount <= maxThreads; threadCount *= 2) {
+		std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+		for (int i = 0; i < iterations; i++) {
+			std::vector<SkeletonData *> skeletons(copies);
+			parallelFor(copies, threadCount, [&skeletons, &atlas, path](size_t j) {
+				SkeletonJson json(&atlas);
+				json.setLazyAnimations(true);
+				skeletons[j] = json.readSkeletonDataFile(path);
+			});
+			std::vector<Animation *> animations;
+			for (size_t j = 0; j < copies; j++) {
+				Vector<Animation *> &items = skeletons[j]->getAnimations();
+				for (size_t k = 0; k < items.size(); k++)
+					animations.push_back(items[k]);
+			}
+			parallelFor(animations.size(), threadCount, [&animations](size_t j) {
+				animations[j]->load();
+			});
+			for (size_t j = 0; j < copies; j++)
+				delete skeletons[j];
+		}
+		printf("parallel load  %d x %-36s %8.3f ms on %d threads\n", (int) copies, path,
+			   elapsedMs(start) / iterations, threadCount);
+	}
+}
+
+namespace spine {
+	SpineExtension *getDefaultExtension() {
+		return new DefaultSpineExtension();
+	}
+}
+
+/// usage: spine_cpp_benchmark [skeleton.json atlas iterations]
+int main(int argc, char **argv) {
+	const char *jsonPath = argc > 1 ? argv[1] : "testdata/spineboy/spineboy-ess.json";
+	const char *atlasPath = argc > 2 ? argv[2] : "testdata/spineboy/spineboy.atlas";
+	int iterations = argc > 3 ? atoi(argv[3]) : 500;
+
+	benchmarkJsonParse(jsonPath, iterations);
+	benchmarkJsonLoad(jsonPath, atlasPath, iterations);
+	benchmarkBinaryLoad(jsonPath, atlasPath, iterations);
+	benchmarkParallelLoad(jsonPath, atlasPath, iterations / 16 > 0 ? iterations / 16 : 1);
+}
@@ -1,11 +1,29 @@
+#include <math.h>
 #include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include <spine/spine.h>
 #include <spine/Debug.h>
+#include <spine/SkeletonBinaryWriter.h>
 
 #pragma warning ( disable : 4710 )
 
 using namespace spine;
 
+/* assert is compiled out of release builds, checks count failures for the exit code instead */
+static int failures = 0;
+#define CHECK(condition) \
+	do { \
+		if (!(condition)) { \
+			printf("%s:%d: check failed: %s\n", __FILE__, __LINE__, #condition); \
+			failures++; \
+		} \
+	} while (0)
+
 void loadBinary(const String &binaryFile, const String &atlasFile, Atlas *&atlas, SkeletonData *&skeletonData,
 				AnimationStateData *&stateData, Skeleton *&skeleton, AnimationState *&state) {
 	atlas = new(__FILE__, __LINE__) Atlas(atlasFile, NULL);
@@ -64,8 +82,9 @@ struct TestData {
 
 void testLoading() {
 	Vector<TestData> testData;
-	testData.add(TestData("testdata/coin/coin-pro.json", "testdata/coin/coin-pro.skel", "testdata/coin/coin.atlas"));
-/*testData.add(TestData("testdata/goblins/goblins-pro.json", "testdata/goblins/goblins-pro.skel",
+	testData.add(TestData("testdata/spineboy/spineboy-ess.json", "", "testdata/spineboy/spineboy.atlas"));
+/*testData.add(TestData("testdata/coin/coin-pro.json", "testdata/coin/coin-pro.skel", "testdata/coin/coin.atlas"));
+	testData.add(TestData("testdata/goblins/goblins-pro.json", "testdata/goblins/goblins-pro.skel",
 						  "testdata/goblins/goblins.atlas"));
 	testData.add(TestData("testdata/raptor/raptor-pro.json", "testdata/raptor/raptor-pro.skel",
 						  "testdata/raptor/raptor.atlas"));
@@ -87,12 +106,400 @@ void testLoading() {
 		loadJson(data._jsonSkeleton, data._atlas, atlas, skeletonData, stateData, skeleton, state);
 		dispose(atlas, skeletonData, stateData, skeleton, state);
 
+		if (data._binarySkeleton.length() == 0) continue;
 		printf("Loading %s\n", data._binarySkeleton.buffer());
 		loadBinary(data._binarySkeleton, data._atlas, atlas, skeletonData, stateData, skeleton, state);
 		dispose(atlas, skeletonData, stateData, skeleton, state);
 	}
 }
 
+void checkSamePose(Skeleton &a, Skeleton &b, const String &animation, float time) {
+	for (size_t i = 0; i < a.getBones().size(); i++) {
+		Bone *boneA = a.getBones()[i], *boneB = b.getBones()[i];
+		bool same = boneA->getA() == boneB->getA() && boneA->getB() == boneB->getB() && boneA->getC() == boneB->getC() &&
+					boneA->getD() == boneB->getD() && boneA->getWorldX() == boneB->getWorldX() &&
+					boneA->getWorldY() == boneB->getWorldY();
+		if (!same) printf("%s at %g: bone %s differs\n", animation.buffer(), time, boneA->getData().getName().buffer());
+		CHECK(same);
+	}
+	for (size_t i = 0; i < a.getSlots().size(); i++) {
+		Slot *slotA = a.getDrawOrder()[i], *slotB = b.getDrawOrder()[i];
+		CHECK(slotA->getData().getName() == slotB->getData().getName());
+		Attachment *attachmentA = slotA->getAttachment(), *attachmentB = slotB->getAttachment();
+		CHECK((attachmentA == NULL) == (attachmentB == NULL));
+		if (attachmentA && attachmentB) CHECK(attachmentA->getName() == attachmentB->getName());
+		Color &colorA = slotA->getColor(), &colorB = slotB->getColor();
+		CHECK(colorA.r == colorB.r && colorA.g == colorB.g && colorA.b == colorB.b && colorA.a == colorB.a);
+	}
+}
+
+/* Every animation of actual has the same duration and timelines as in expected and poses the skeleton the same. */
+void checkSameAnimations(SkeletonData &expected, SkeletonData &actual) {
+	CHECK(expected.getAnimations().size() == actual.getAnimations().size());
+	for (size_t i = 0; i < expected.getAnimations().size(); i++) {
+		Animation *animation = expected.getAnimations()[i];
+		Animation *actualAnimation = actual.findAnimation(animation->getName());
+		CHECK(actualAnimation != NULL);
+		if (!actualAnimation) continue;
+		CHECK(animation->getDuration() == actualAnimation->getDuration());
+		CHECK(animation->getTimelines().size() == actualAnimation->getTimelines().size());
+
+		Skeleton skeletonA(&expected), skeletonB(&actual);
+		skeletonA.setSkin("default");
+		skeletonB.setSkin("default");
+		skeletonA.setSlotsToSetupPose();
+		skeletonB.setSlotsToSetupPose();
+		for (int frame = 0; frame <= 10; frame++) {
+			float time = animation->getDuration() * frame / 10;
+			animation->apply(skeletonA, 0, time, false, NULL, 1, MixBlend_Setup, MixDirection_In);
+			actualAnimation->apply(skeletonB, 0, time, false, NULL, 1, MixBlend_Setup, MixDirection_In);
+			skeletonA.updateWorldTransform();
+			skeletonB.updateWorldTransform();
+			checkSamePose(skeletonA, skeletonB, animation->getName(), time);
+		}
+	}
+}
+
+/* A .skel converted from json loads the same skeleton and poses it the same in every animation. */
+void testBinaryRoundTrip(const char *jsonFile, const char *atlasFile) {
+	printf("Converting %s\n", jsonFile);
+	int length = 0;
+	char *json = SpineExtension::readFile(jsonFile, &length);
+	CHECK(json != NULL);
+	if (!json) return;
+	Vector<unsigned char> binary;
+	SkeletonBinaryWriter writer;
+	bool written = writer.writeSkeletonData(json, length, binary);
+	SpineExtension::free(json, __FILE__, __LINE__);
+	if (!written) printf("%s\n", writer.getError().buffer());
+	CHECK(written);
+	if (!written) return;
+
+	Atlas atlas(atlasFile, NULL);
+	SkeletonJson jsonReader(&atlas);
+	SkeletonBinary binaryReader(&atlas);
+	SkeletonData *jsonData = jsonReader.readSkeletonDataFile(jsonFile);
+	SkeletonData *binaryData = binaryReader.readSkeletonData(binary.buffer(), (int) binary.size());
+	CHECK(jsonData && binaryData);
+	if (!jsonData || !binaryData) {
+		delete jsonData;
+		delete binaryData;
+		return;
+	}
+
+	CHECK(jsonData->getBones().size() == binaryData->getBones().size());
+	CHECK(jsonData->getSlots().size() == binaryData->getSlots().size());
+	CHECK(jsonData->getSkins().size() == binaryData->getSkins().size());
+	CHECK(jsonData->getEvents().size() == binaryData->getEvents().size());
+	CHECK(jsonData->getAnimations().size() == binaryData->getAnimations().size());
+	for (size_t i = 0; i < jsonData->getSkins().size(); i++) {
+		Skin::AttachmentMap::Entries a = jsonData->getSkins()[i]->getAttachments();
+		Skin::AttachmentMap::Entries b = binaryData->getSkins()[i]->getAttachments();
+		size_t countA = 0, countB = 0;
+		while (a.hasNext()) { a.next(); countA++; }
+		while (b.hasNext()) { b.next(); countB++; }
+		CHECK(countA == countB);
+	}
+
+	checkSameAnimations(*jsonData, *binaryData);
+
+	delete jsonData;
+	delete binaryData;
+}
+
+/* Lazily read animations decode to the same timelines as an eager load, also after being unloaded. Lazy json keeps
+ * only the animation text, less than the eagerly decoded timelines. */
+void testLazyAnimations(DebugExtension &debug, const char *jsonFile, const char *atlasFile) {
+	printf("Reading animations of %s on demand\n", jsonFile);
+	int length = 0;
+	char *json = SpineExtension::readFile(jsonFile, &length);
+	CHECK(json != NULL);
+	if (!json) return;
+	Vector<unsigned char> binary;
+	SkeletonBinaryWriter writer;
+	CHECK(writer.writeSkeletonData(json, length, binary));
+
+	Atlas atlas(atlasFile, NULL);
+	SkeletonJson eagerJson(&atlas), lazyJson(&atlas);
+	SkeletonBinary lazyBinary(&atlas);
+	lazyJson.setLazyAnimations(true);
+	lazyBinary.setLazyAnimations(true);
+
+	size_t used = debug.getUsedMemory();
+	SkeletonData *eagerData = eagerJson.readSkeletonData(json, length);
+	size_t eagerBytes = debug.getUsedMemory() - used;
+	used = debug.getUsedMemory();
+	SkeletonData *lazyData = lazyJson.readSkeletonData(json, length);
+	size_t lazyBytes = debug.getUsedMemory() - used;
+	SkeletonData *lazyBinaryData = lazyBinary.readSkeletonData(binary.buffer(), (int) binary.size());
+	SpineExtension::free(json, __FILE__, __LINE__);
+	if (!lazyData) printf("%s\n", lazyJson.getError().buffer());
+	if (!lazyBinaryData) printf("%s\n", lazyBinary.getError().buffer());
+	CHECK(eagerData && lazyData && lazyBinaryData);
+	if (eagerData && lazyData && lazyBinaryData) {
+		printf("eager json %d bytes, lazy json %d bytes\n", (int) eagerBytes, (int) lazyBytes);
+		CHECK(lazyBytes < eagerBytes);
+
+		checkSameAnimations(*eagerData, *lazyData);
+		checkSameAnimations(*eagerData, *lazyBinaryData);
+		lazyData->unloadUnusedAnimations();
+		lazyBinaryData->unloadUnusedAnimations();
+		checkSameAnimations(*eagerData, *lazyData);
+		checkSameAnimations(*eagerData, *lazyBinaryData);
+	}
+
+	delete eagerData;
+	delete lazyData;
+	delete lazyBinaryData;
+}
+
+/// Loads the lazily read animations of one skeleton from several threads at once, each starting at a different
+/// animation so that threads race on the same animations.
+void testParallelAnimations(const char *jsonFile, const char *atlasFile) {
+	printf("Reading animations of %s on several threads\n", jsonFile);
+	int length = 0;
+	char *json = SpineExtension::readFile(jsonFile, &length);
+	CHECK(json != NULL);
+	if (!json) return;
+	Vector<unsigned char> binary;
+	SkeletonBinaryWriter writer;
+	CHECK(writer.writeSkeletonData(json, length, binary));
+
+	Atlas atlas(atlasFile, NULL);
+	SkeletonJson eagerJson(&atlas), lazyJson(&atlas);
+	SkeletonBinary lazyBinary(&atlas);
+	lazyJson.setLazyAnimations(true);
+	lazyBinary.setLazyAnimations(true);
+	SkeletonData *eagerData = eagerJson.readSkeletonData(json, length);
+	SkeletonData *lazyData[] = {lazyJson.readSkeletonData(json, length),
+								lazyBinary.readSkeletonData(binary.buffer(), (int) binary.size())};
+	SpineExtension::free(json, __FILE__, __LINE__);
+	CHECK(eagerData && lazyData[0] && lazyData[1]);
+
+	for (int i = 0; i < 2; i++) {
+		if (!eagerData || !lazyData[i]) break;
+		Vector<Animation *> &animations = lazyData[i]->getAnimations();
+		std::atomic<int> failedLoads(0);
+		std::vector<std::thread> threads;
+		for (size_t t = 0; t < 8; t++) {
+			threads.push_back(std::thread([&animations, &failedLoads, t]() {
+				for (size_t j = 0, n = animations.size(); j < n; j++) {
+					if (!animations[(j + t) % n]->load()) failedLoads++;
+				}
+			}));
+		}
+		for (size_t t = 0; t < threads.size(); t++)
+			threads[t].join();
+		CHECK(failedLoads == 0);
+		checkSameAnimations(*eagerData, *lazyData[i]);
+	}
+
+	delete eagerData;
+	delete lazyData[0];
+	delete lazyData[1];
+}
+
+/// Null terminates the files it reads, so even an empty file gives a buffer.
+class TerminatingExtension : public SpineExtension {
+public:
+	explicit TerminatingExtension(SpineExtension *extension) : _extension(extension) {
+	}
+
+	virtual void *_alloc(size_t size, const char *file, int line) {
+		return _extension->_alloc(size, file, line);
+	}
+
+	virtual void *_calloc(size_t size, const char *file, int line) {
+		return _extension->_calloc(size, file, line);
+	}
+
+	virtual void *_realloc(void *ptr, size_t size, const char *file, int line) {
+		return _extension->_realloc(ptr, size, file, line);
+	}
+
+	virtual void _free(void *mem, const char *file, int line) {
+		_extension->_free(mem, file, line);
+	}
+
+	virtual char *_readFile(const String &path, int *length) {
+		FILE *file = fopen(path.buffer(), "rb");
+		if (!file) return NULL;
+		fseek(file, 0, SEEK_END);
+		*length = (int) ftell(file);
+		fseek(file, 0, SEEK_SET);
+		char *data = SpineExtension::calloc<char>(*length + 1, __FILE__, __LINE__);
+		fread(data, 1, *length, file);
+		fclose(file);
+		return data;
+	}
+
+private:
+	SpineExtension *_extension;
+};
+
+/// Maps a file that ends inside a page and one that ends on a page boundary, which is read into a buffer, then reads
+/// an empty skeleton file, whose buffer must still be released.
+void testMappedFiles(DebugExtension &debug) {
+	printf("Mapping files\n");
+	DefaultSpineExtension extension;
+	SpineExtension &files = extension;
+	const char *path = "mapped.tmp";
+	size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+	size_t sizes[] = {pageSize + 1, pageSize * 2, 0};
+	for (size_t i = 0; i < 3; i++) {
+		std::vector<char> content(sizes[i]);
+		for (size_t j = 0; j < content.size(); j++)
+			content[j] = (char) (j * 7 + i);
+		FILE *file = fopen(path, "wb");
+		CHECK(file != NULL);
+		if (!file) return;
+		if (!content.empty()) fwrite(&content[0], 1, content.size(), file);
+		fclose(file);
+
+		int length = -1;
+		const char *data = files._mapFile(path, &length);
+		CHECK(length == (int) content.size());
+		CHECK(content.empty() ? data == NULL : data != NULL && memcmp(data, &content[0], content.size()) == 0);
+		files._unmapFile(data, length);
+	}
+
+	Atlas atlas("testdata/spineboy/spineboy.atlas", NULL);
+	SkeletonBinary binary(&atlas);
+	SkeletonJson json(&atlas);
+	SpineExtension *previous = SpineExtension::getInstance();
+	TerminatingExtension terminating(previous);
+	SpineExtension::setInstance(&terminating);
+	/* The first reads set the errors, the second ones only replace them. */
+	size_t used = 0;
+	for (int i = 0; i < 2; i++) {
+		if (i == 1) used = debug.getUsedMemory();
+		CHECK(binary.readSkeletonDataFile(path) == NULL);
+		CHECK(json.readSkeletonDataFile(path) == NULL);
+	}
+	CHECK(debug.getUsedMemory() == used);
+	SpineExtension::setInstance(previous);
+	remove(path);
+}
+
+/// Unloads the animations of a skeleton while another thread keeps setting and applying them, then deletes the
+/// SkeletonData before the AnimationState still holding entries for its animations.
+void testUnloadWhileUsed(const char *jsonFile, const char *atlasFile) {
+	printf("Unloading animations of %s while they are used\n", jsonFile);
+	Atlas atlas(atlasFile, NULL);
+	SkeletonJson json(&atlas);
+	json.setLazyAnimations(true);
+	SkeletonData *skeletonData = json.readSkeletonDataFile(jsonFile);
+	CHECK(skeletonData != NULL);
+	if (!skeletonData) return;
+
+	Skeleton *skeleton = new(__FILE__, __LINE__) Skeleton(skeletonData);
+	AnimationStateData *stateData = new(__FILE__, __LINE__) AnimationStateData(skeletonData);
+	AnimationState *state = new(__FILE__, __LINE__) AnimationState(stateData);
+	Vector<Animation *> &animations = skeletonData->getAnimations();
+	std::atomic<bool> done(false);
+	std::thread unloader([skeletonData, &done]() {
+		while (!done)
+			skeletonData->unloadUnusedAnimations();
+	});
+	for (size_t i = 0; i < 2000; i++) {
+		Animation *animation = animations[i % animations.size()];
+		state->setAnimation(0, animation, true);
+		state->update(1 / 60.0f);
+		state->apply(*skeleton);
+	}
+	done = true;
+	unloader.join();
+
+	Animation *current = state->getCurrent(0)->getAnimation();
+	skeletonData->unloadUnusedAnimations();
+	CHECK(current->isLoaded() && current->getUseCount() == 1);
+	delete skeleton;
+	delete skeletonData;
+	delete state;
+	delete stateData;
+}
+
+/// The batched swirl moves exactly the vertices transform moves, those on the edge of the radius included.
+/// Turns every vertex inside the radius by the whole angle, so the vertices on the edge move too.
+class ConstantInterpolation : public Interpolation {
+public:
+	virtual float apply(float a) {
+		SP_UNUSED(a);
+		return 1;
+	}
+};
+
+void testSwirlBatch() {
+	ConstantInterpolation interpolation;
+	SwirlVertexEffect swirl(10, interpolation);
+	swirl.setAngle(90);
+	const size_t count = 4096;
+	std::vector<float> positions(count * 2), uvs(count * 2, 0), expected(count * 2);
+	std::vector<Color> colors(count);
+	for (size_t i = 0; i < count; i++) {
+		/* up to 2 ulps off the edge, where the squared and the rooted distance round differently */
+		float x = 10 * MathUtil::cos(i * MathUtil::Pi_2 / count);
+		float y = (float)MathUtil::sqrt(100 - x * x);
+		for (int step = (int)(i % 5) - 2; step != 0; step += step < 0 ? 1 : -1)
+			y = nextafterf(y, step < 0 ? 0.0f : 20.0f);
+		positions[i * 2] = x;
+		positions[i * 2 + 1] = y;
+	}
+	for (size_t i = 0; i < count; i++) {
+		float u = 0, v = 0;
+		Color light, dark;
+		expected[i * 2] = positions[i * 2];
+		expected[i * 2 + 1] = positions[i * 2 + 1];
+		swirl.transform(expected[i * 2], expected[i * 2 + 1], u, v, light, dark);
+	}
+	std::vector<float> input(positions);
+	swirl.transformBatch(&positions[0], &uvs[0], &colors[0], count);
+
+	int different = 0, moved = 0;
+	for (size_t i = 0; i < count; i++) {
+		different += positions[i * 2] != expected[i * 2] || positions[i * 2 + 1] != expected[i * 2 + 1];
+		moved += expected[i * 2] != input[i * 2] || expected[i * 2 + 1] != input[i * 2 + 1];
+	}
+	CHECK(different == 0);
+	CHECK(moved > 0 && moved < (int)count);
+}
+
+/// DebugExtension keeps its allocations in maps, this serializes the calls for the threaded tests.
+class LockedExtension : public SpineExtension {
+public:
+	explicit LockedExtension(SpineExtension *extension) : _extension(extension) {
+	}
+
+	virtual void *_alloc(size_t size, const char *file, int line) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _extension->_alloc(size, file, line);
+	}
+
+	virtual void *_calloc(size_t size, const char *file, int line) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _extension->_calloc(size, file, line);
+	}
+
+	virtual void *_realloc(void *ptr, size_t size, const char *file, int line) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		return _extension->_realloc(ptr, size, file, line);
+	}
+
+	virtual void _free(void *mem, const char *file, int line) {
+		std::lock_guard<std::mutex> lock(_mutex);
+		_extension->_free(mem, file, line);
+	}
+
+	/* Reading allocates through SpineExtension::getInstance(), which takes the lock. */
+	virtual char *_readFile(const String &path, int *length) {
+		return _extension->_readFile(path, length);
+	}
+
+private:
+	SpineExtension *_extension;
+	std::mutex _mutex;
+};
+
 namespace spine {
 	SpineExtension* getDefaultExtension() {
 		return new DefaultSpineExtension();
@@ -101,9 +508,18 @@ namespace spine {
 
 int main(int argc, char **argv) {
 	DebugExtension debug(SpineExtension::getInstance());
-	SpineExtension::setInstance(&debug);
+	LockedExtension locked(&debug);
+	SpineExtension::setInstance(&locked);
 
 	testLoading();
+	testBinaryRoundTrip("testdata/spineboy/spineboy-ess.json", "testdata/spineboy/spineboy.atlas");
+	testLazyAnimations(debug, "testdata/spineboy/spineboy-ess.json", "testdata/spineboy/spineboy.atlas");
+	testParallelAnimations("testdata/spineboy/spineboy-ess.json", "testdata/spineboy/spineboy.atlas");
+	testMappedFiles(debug);
+	testUnloadWhileUsed("testdata/spineboy/spineboy-ess.json", "testdata/spineboy/spineboy.atlas");
+	testSwirlBatch();
 
 	debug.reportLeaks();
+	printf("\n%d failed checks\n", failures);
+	return failures ? 1 : 0;
 }
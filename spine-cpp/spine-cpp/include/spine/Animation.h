@@ -44,6 +44,30 @@ class Skeleton;
 
 class Event;
 
+class AnimationLoader;
+
+/// Counts the track entries using an animation. Kept apart from the Animation and referenced by it and by each entry,
+/// so an AnimationState may still be deleted after the SkeletonData its animations belong to.
+class SP_API AnimationUses : public SpineObject {
+	friend class Animation;
+
+	friend class TrackEntry;
+
+	friend class AnimationState;
+
+private:
+	AnimationUses();
+
+	/// A track entry starts using the animation.
+	void acquire();
+
+	/// A track entry stops using it, or the animation is deleted. Deletes the counter once nothing references it.
+	void release(bool use);
+
+	volatile int _count;
+	volatile int _references;
+};
+
 class SP_API Animation : public SpineObject {
 	friend class AnimationState;
 
@@ -81,9 +105,14 @@ class SP_API Animation : public SpineObject {
 
 	friend class TwoColorTimeline;
 
+	friend class AnimationLoader;
+
 public:
 	Animation(const String &name, Vector<Timeline *> &timelines, float duration);
 
+	/// Creates an animation whose timelines are read by the loader on first use.
+	Animation(const String &name, AnimationLoader *loader, size_t loaderOffset);
+
 	~Animation();
 
 	/// Applies all the animation's timelines to the specified skeleton.
@@ -101,13 +130,32 @@ public:
 
 	void setDuration(float inValue);
 
+	/// False until the timelines of a lazily read animation are read, which happens on first use.
+	bool isLoaded();
+
+	/// Reads the timelines of a lazily read animation now, e.g. to prefetch it before it is set on a track. Safe to
+	/// call from several threads, the animation is read once and the other callers wait for it.
+	/// @return False if the data could not be read, the animation is then empty. See AnimationLoader::getError().
+	bool load();
+
+	/// Frees the timelines of a lazily read animation, they are read again on next use. Does nothing for animations
+	/// that were read eagerly, are loading or are used by a TrackEntry. Safe against concurrent load() calls and
+	/// track entries being created on other threads, but not against code using getTimelines() or apply() directly
+	/// outside of an AnimationState.
+	void unload();
 
+	/// The number of track entries currently playing or queued with this animation.
+	int getUseCount();
 
 private:
 	Vector<Timeline *> _timelines;
 	HashMap<int, bool> _timelineIds;
 	float _duration;
 	String _name;
+	AnimationLoader *_loader;
+	size_t _loaderOffset;
+	volatile int _loadState;
+	AnimationUses *_uses;
 
 	/// @param target After the first and before the last entry.
 	static int binarySearch(Vector<float> &values, float target, int step);
@@ -0,0 +1,71 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef Spine_AnimationLoader_h
+#define Spine_AnimationLoader_h
+
+#include <spine/SpineObject.h>
+#include <spine/SpineString.h>
+
+namespace spine {
+	class Animation;
+
+	/// Reads the timelines of animations on demand, see SkeletonJson::setLazyAnimations and
+	/// SkeletonBinary::setLazyAnimations. Owned by the SkeletonData it was read with.
+	class SP_API AnimationLoader : public SpineObject {
+	public:
+		explicit AnimationLoader(float scale);
+
+		virtual ~AnimationLoader();
+
+		/// Reads the timelines and duration of the animation stored at the offset recorded when the skeleton data
+		/// was read. Called from any thread, implementations decode with a reader of their own per call.
+		/// @return False if the data is invalid, see getError().
+		virtual bool loadAnimation(Animation& animation, size_t offset) = 0;
+
+		/// The last error of a failed loadAnimation, read it once the loading threads are done.
+		String& getError() { return _error; }
+
+	protected:
+		/// Sets the error, which failing loads on several threads may do at once.
+		void setError(const String& error);
+
+		/// The reader's scale for decoding animations.
+		float _scale;
+
+		/// Moves the timelines and duration of the decoded animation into the lazily read one.
+		static void setTimelines(Animation& animation, Animation& decoded);
+
+	private:
+		String _error;
+		volatile int _errorLock;
+	};
+}
+
+#endif /* Spine_AnimationLoader_h */
@@ -56,6 +56,7 @@ namespace spine {
 	class TrackEntry;
 
 	class Animation;
+	class AnimationUses;
 	class Event;
 	class AnimationStateData;
 	class Skeleton;
@@ -234,6 +235,7 @@ namespace spine {
 
 	private:
 		Animation* _animation;
+		AnimationUses* _uses;
 
 		TrackEntry* _next;
 		TrackEntry* _mixingFrom;
@@ -115,6 +115,8 @@ public:
 
 	Vector<AtlasPage*> &getPages();
 
+	Vector<AtlasRegion*> &getRegions();
+
 private:
 	Vector<AtlasPage *> _pages;
 	Vector<AtlasRegion *> _regions;
@@ -51,9 +51,17 @@ public:
 	void reference();
 	void dereference();
 
+	/// Incremented when the setup geometry the attachment computes world vertices from changes: by
+	/// RegionAttachment::updateOffset, or when a MeshAttachment takes the vertices of its parent mesh. Call
+	/// geometryChanged after modifying the vertices or bones of a VertexAttachment directly.
+	unsigned int getGeometryVersion();
+
+	void geometryChanged();
+
 private:
 	const String _name;
 	int _refCount;
+	unsigned int _geometryVersion;
 };
 }
 
@@ -225,6 +225,10 @@ public:
 
 	void setActive(bool inValue);
 
+	/// Incremented whenever the world transform changes, so renderers can tell which bones moved since they last looked.
+	/// Setting the world transform values directly increments it too.
+	unsigned int getWorldVersion();
+
 private:
 	static bool yDown;
 
@@ -239,6 +243,11 @@ private:
 	float _c, _d, _worldY;
 	bool _sorted;
 	bool _active;
+	unsigned int _worldVersion;
+	float _ux, _uy, _urotation, _uscaleX, _uscaleY, _ushearX, _ushearY;
+	unsigned int _updateVersion, _parentVersion;
+
+	void computeWorldTransform(float x, float y, float rotation, float scaleX, float scaleY, float shearX, float shearY);
 
 	/// Computes the individual applied transform values from the world transform. This can be useful to perform processing using
 	/// the applied transform after the world transform has been modified directly (eg, by a constraint)..
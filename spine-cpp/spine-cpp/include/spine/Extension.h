@@ -65,6 +65,14 @@ public:
 		return getInstance()->_readFile(path, length);
 	}
 
+	static const char *mapFile(const String &path, int *length) {
+		return getInstance()->_mapFile(path, length);
+	}
+
+	static void unmapFile(const char *data, int length) {
+		getInstance()->_unmapFile(data, length);
+	}
+
 	static void setInstance(SpineExtension *inSpineExtension);
 
 	static SpineExtension *getInstance();
@@ -83,6 +91,14 @@ public:
 
 	virtual char *_readFile(const String &path, int *length) = 0;
 
+	/// Implement this function to hand out read-only file contents without copying them, e.g. by memory mapping.
+	/// The default reads the file with _readFile. The data is not null terminated. Atlas and SkeletonBinary parse
+	/// straight from it. Json unescapes strings in place in a copy of its text, so json files are read with _readFile.
+	virtual const char *_mapFile(const String &path, int *length);
+
+	/// Releases data returned by _mapFile.
+	virtual void _unmapFile(const char *data, int length);
+
 protected:
 	SpineExtension();
 
@@ -106,6 +122,10 @@ protected:
 	virtual void _free(void *mem, const char *file, int line);
 
 	virtual char *_readFile(const String &path, int *length);
+
+	virtual const char *_mapFile(const String &path, int *length);
+
+	virtual void _unmapFile(const char *data, int length);
 };
 
 // This function is to be implemented by engine specific runtimes to provide
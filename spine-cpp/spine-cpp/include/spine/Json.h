@@ -31,6 +31,7 @@
 #define Spine_Json_h
 
 #include <spine/SpineObject.h>
+#include <spine/Threading.h>
 
 #ifndef SPINE_JSON_HAVE_PREV
 /* spine doesn't use the "prev" link in the Json sibling lists. */
@@ -41,6 +42,8 @@ namespace spine {
 class SP_API Json : public SpineObject {
 	friend class SkeletonJson;
 
+	friend class SkeletonBinaryWriter;
+
 public:
 	/* Json Types: */
 	static const int JSON_FALSE;
@@ -65,15 +68,25 @@ public:
 	/* For analysing failed parses. This returns a pointer to the parse error. You'll probably need to look a few chars back to make sense of it. Defined when Json_create() returns 0. 0 when Json_create() succeeds. */
 	static const char *getError();
 
-	/* Supply a block of JSON, and this returns a Json object you can interrogate. Call Json_dispose when finished. */
+	/* Supply a block of JSON, and this returns a Json object you can interrogate. Call Json_dispose when finished.
+	 * The text is copied once into the root's arena and parsed in place, all nodes and strings live in that arena. */
 	explicit Json(const char *value);
 
+	/* Same as above for text that is not null terminated, e.g. a mapped file. */
+	Json(const char *value, size_t length);
+
 	~Json();
 
 
 
 private:
-	static const char *_error;
+	/* Bump allocator for the nodes and the in-situ string buffer of one document, owned by the root item. */
+	class Arena;
+
+	/* Per thread, so documents can be parsed concurrently. */
+	static SP_THREAD_LOCAL const char *_error;
+
+	Arena *_arena;
 
 	Json *_next;
 #if SPINE_JSON_HAVE_PREV
@@ -90,23 +103,34 @@ private:
 
 	const char *_name; /* The item's name string, if this item is the child of, or is in the list of subitems of an object. */
 
+	void parse(const char *value, size_t length);
+
+	/* Offset in the parsed text of a name or string value of this root's document. Strings are unescaped in place,
+	 * starting at their opening quote, so this is also where the quoted string is in the text passed to the constructor. */
+	size_t getTextOffset(const char *string);
+
 	/* Utility to jump whitespace and cr/lf */
 	static const char *skip(const char *inValue);
 
+	static char *skip(char *inValue);
+
+	/* Allocate an empty item from the arena. */
+	static Json *newItem(Arena *arena);
+
 	/* Parser core - when encountering text, process appropriately. */
-	static const char *parseValue(Json *item, const char *value);
+	static char *parseValue(Json *item, char *value, Arena *arena);
 
-	/* Parse the input text into an unescaped cstring, and populate item. */
-	static const char *parseString(Json *item, const char *str);
+	/* Unescape the input text in place into a cstring, and populate item. */
+	static char *parseString(Json *item, char *str);
 
 	/* Parse the input text to generate a number, and populate the result into item. */
-	static const char *parseNumber(Json *item, const char *num);
+	static char *parseNumber(Json *item, char *num);
 
 	/* Build an array from input text. */
-	static const char *parseArray(Json *item, const char *value);
+	static char *parseArray(Json *item, char *value, Arena *arena);
 
 	/* Build an object from the text. */
-	static const char *parseObject(Json *item, const char *value);
+	static char *parseObject(Json *item, char *value, Arena *arena);
 
 	static int json_strcasecmp(const char *s1, const char *s2);
 };
@@ -58,6 +58,8 @@ class Attachment;
 class SP_API Skeleton : public SpineObject {
 	friend class AnimationState;
 
+	friend class Bone;
+
 	friend class SkeletonBounds;
 
 	friend class SkeletonClipping;
@@ -104,6 +106,13 @@ public:
 	/// Updates the world transform for each bone and applies constraints.
 	void updateWorldTransform();
 
+	/// When true, updateWorldTransform skips bones whose local transform is the same as when their world transform was last
+	/// computed, as long as their parent's world transform and the skeleton's position and scale didn't change either. Bones
+	/// changed by a constraint are always computed again on the next update. Default is false.
+	void setSkipUnchangedBones(bool inValue);
+
+	bool getSkipUnchangedBones();
+
 	/// Sets the bones, constraints, and slots to their setup pose values.
 	void setToSetupPose();
 
@@ -223,6 +232,10 @@ private:
 	float _time;
 	float _scaleX, _scaleY;
 	float _x, _y;
+	bool _skipUnchangedBones;
+	bool _updateAllBones;
+	bool _bonesChanged;
+	float _updateX, _updateY, _updateScaleX, _updateScaleY;
 
 	void sortIkConstraint(IkConstraint *constraint);
 
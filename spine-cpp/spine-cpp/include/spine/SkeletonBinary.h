@@ -78,6 +78,11 @@ namespace spine {
 
 		void setScale(float scale) { _scale = scale; }
 
+		/// When true, animations are not read up front. Only the names and offsets of the animations are recorded and
+		/// each animation's timelines are read on first use from a copy of the animation data. Errors in an animation
+		/// are reported by AnimationLoader::getError() when it is loaded. See Animation::load().
+		void setLazyAnimations(bool lazyAnimations) { _lazyAnimations = lazyAnimations; }
+
 		String& getError() { return _error; }
 
 	private:
@@ -86,10 +91,13 @@ namespace spine {
 			const unsigned char* end;
 		};
 
+		class LazyAnimationLoader;
+
 		AttachmentLoader* _attachmentLoader;
 		Vector<LinkedMesh*> _linkedMeshes;
 		String _error;
 		float _scale;
+		bool _lazyAnimations;
 		const bool _ownsLoader;
 
 		void setError(const char* value1, const char* value2);
@@ -124,7 +132,12 @@ namespace spine {
 
 		Animation* readAnimation(const String& name, DataInput* input, SkeletonData *skeletonData);
 
+		/// Moves the input past an animation without creating its timelines.
+		void skipAnimation(DataInput* input, SkeletonData* skeletonData);
+
 		void readCurve(DataInput* input, int frameIndex, CurveTimeline* timeline);
+
+		void skipCurve(DataInput* input);
 	};
 }
 
@@ -0,0 +1,113 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef Spine_SkeletonBinaryWriter_h
+#define Spine_SkeletonBinaryWriter_h
+
+#include <spine/Vector.h>
+#include <spine/SpineObject.h>
+#include <spine/SpineString.h>
+
+namespace spine {
+	class Json;
+
+	/// Converts exported skeleton JSON into the binary format read by SkeletonBinary, so that assets can be
+	/// converted once at build time and loaded without parsing text at startup. Nonessential data is kept.
+	class SP_API SkeletonBinaryWriter : public SpineObject {
+	public:
+		SkeletonBinaryWriter();
+
+		~SkeletonBinaryWriter();
+
+		bool writeSkeletonData(const char* json, int length, Vector<unsigned char>& binary);
+
+		bool writeSkeletonDataFile(const String& jsonPath, const String& binaryPath);
+
+		String& getError() { return _error; }
+
+	private:
+		struct DataOutput : public SpineObject {
+			Vector<unsigned char> buffer;
+		};
+
+		Vector<const char*> _strings;
+		Vector<const char*> _bones;
+		Vector<const char*> _slots;
+		Vector<const char*> _ikConstraints;
+		Vector<const char*> _transformConstraints;
+		Vector<const char*> _pathConstraints;
+		Vector<const char*> _skins;
+		Vector<Json*> _events;
+		String _error;
+
+		void setError(const char* value1, const char* value2);
+
+		static int indexOf(Vector<const char*>& names, const char* name);
+
+		void writeString(DataOutput* output, const char* value);
+
+		void writeStringRef(DataOutput* output, const char* value);
+
+		void writeFloat(DataOutput* output, float value);
+
+		void writeByte(DataOutput* output, unsigned char value);
+
+		void writeBoolean(DataOutput* output, bool value);
+
+		void writeInt(DataOutput* output, int value);
+
+		void writeColor(DataOutput* output, const char* value, bool hasAlpha = true);
+
+		void writeVarint(DataOutput* output, int value, bool optimizePositive);
+
+		static int toColor(const char* value, bool hasAlpha);
+
+		bool writeBones(DataOutput* output, Json* root);
+
+		bool writeSlots(DataOutput* output, Json* root);
+
+		bool writeConstraints(DataOutput* output, Json* root);
+
+		bool writeSkins(DataOutput* output, Json* root);
+
+		bool writeSkin(DataOutput* output, Json* skinMap, bool defaultSkin);
+
+		bool writeAttachment(DataOutput* output, Json* attachmentMap, const char* skinAttachmentName);
+
+		void writeVertices(DataOutput* output, Json* attachmentMap, int verticesLength);
+
+		bool writeEvents(DataOutput* output, Json* root);
+
+		bool writeAnimation(DataOutput* output, Json* animationMap);
+
+		void writeCurve(DataOutput* output, Json* frame);
+	};
+}
+
+#endif /* Spine_SkeletonBinaryWriter_h */
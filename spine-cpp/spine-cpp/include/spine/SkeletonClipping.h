@@ -41,6 +41,8 @@ namespace spine {
 	public:
 		SkeletonClipping();
 
+		~SkeletonClipping();
+
 		size_t clipStart(Slot& slot, ClippingAttachment* clip);
 
 		void clipEnd(Slot& slot);
@@ -58,6 +60,16 @@ namespace spine {
 		Vector<float>& getClippedUVs();
 
 	private:
+		/** Convex pieces of a clipping polygon as vertex offsets into its local vertices, valid for any affine transform
+		  * of them, so while its vertices aren't weighted or deformed. */
+		class ConvexDecomposition : public SpineObject {
+		public:
+			ClippingAttachment* _attachment;
+			size_t _verticesLength;
+			Vector<int> _offsets;
+			Vector<int> _counts;
+		};
+
 		Triangulator _triangulator;
 		Vector<float> _clippingPolygon;
 		Vector<float> _clipOutput;
@@ -67,12 +79,24 @@ namespace spine {
 		Vector<float> _scratch;
 		ClippingAttachment* _clipAttachment;
 		Vector< Vector<float>* > *_clippingPolygons;
+		Vector<ConvexDecomposition*> _decompositions;
+		Vector< Vector<float>* > _transformedPolygons;
+		Vector<float> _clippingBounds; /* min x, min y, max x, max y of each clipping polygon */
+		Vector<bool> _clippingRectangles;
+
+		void computeBounds();
+
+		ConvexDecomposition* getDecomposition(ClippingAttachment* clip);
+
+		void transformDecomposition(ConvexDecomposition& decomposition);
 
 		/** Clips the input triangle against the convex, clockwise clipping area. If the triangle lies entirely within the clipping
 		  * area, false is returned. The clipping area must duplicate the first vertex at the end of the vertices list. */
 		bool clip(float x1, float y1, float x2, float y2, float x3, float y3, Vector<float>* clippingArea, Vector<float>* output);
 
 		static void makeClockwise(Vector<float>& polygon);
+
+		static bool isClockwise(Vector<float>& polygon);
 	};
 }
 
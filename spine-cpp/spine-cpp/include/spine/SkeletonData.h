@@ -50,6 +50,8 @@ class TransformConstraintData;
 
 class PathConstraintData;
 
+class AnimationLoader;
+
 /// Stores the setup pose and all of the stateless data for a skeleton.
 class SP_API SkeletonData : public SpineObject {
 	friend class SkeletonBinary;
@@ -83,9 +85,13 @@ public:
 	/// @return May be NULL.
 	spine::EventData *findEvent(const String &eventDataName);
 
+	/// Lazily read animations are loaded before they are returned.
 	/// @return May be NULL.
 	Animation *findAnimation(const String &animationName);
 
+	/// Frees the timelines of lazily read animations that no track entry uses, see Animation::unload().
+	void unloadUnusedAnimations();
+
 	/// @return May be NULL.
 	IkConstraintData *findIkConstraint(const String &constraintName);
 
@@ -173,6 +179,7 @@ private:
 	Skin *_defaultSkin;
 	Vector<EventData *> _events;
 	Vector<Animation *> _animations;
+	AnimationLoader *_animationLoader; // Reads lazily read animations, may be NULL.
 	Vector<IkConstraintData *> _ikConstraints;
 	Vector<TransformConstraintData *> _transformConstraints;
 	Vector<PathConstraintData *> _pathConstraints;
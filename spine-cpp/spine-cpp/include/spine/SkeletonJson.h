@@ -65,14 +65,24 @@ public:
 
 	SkeletonData *readSkeletonData(const char *json);
 
+	SkeletonData *readSkeletonData(const char *json, int length);
+
 	void setScale(float scale) { _scale = scale; }
 
+	/// When true, animations are not read up front. Each animation's timelines are read on first use from a copy of
+	/// its text kept by the SkeletonData; the rest of the document is freed once the skeleton is read. Errors in an animation are reported by
+	/// AnimationLoader::getError() when it is loaded instead of failing readSkeletonData. See Animation::load().
+	void setLazyAnimations(bool lazyAnimations) { _lazyAnimations = lazyAnimations; }
+
 	String &getError() { return _error; }
 
 private:
+	class LazyAnimationLoader;
+
 	AttachmentLoader *_attachmentLoader;
 	Vector<LinkedMesh *> _linkedMeshes;
 	float _scale;
+	bool _lazyAnimations;
 	const bool _ownsLoader;
 	String _error;
 
@@ -112,6 +112,12 @@ public:
 
 	Vector<float> &getDeform();
 
+	/// Incremented when a DeformTimeline writes the deform or setAttachment clears it. Call deformChanged after
+	/// modifying getDeform directly.
+	unsigned int getDeformVersion();
+
+	void deformChanged();
+
 private:
 	SlotData &_data;
 	Bone &_bone;
@@ -123,6 +129,7 @@ private:
 	int _attachmentState;
 	float _attachmentTime;
 	Vector<float> _deform;
+	unsigned int _deformVersion;
 };
 }
 
@@ -0,0 +1,94 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifndef Spine_Threading_h
+#define Spine_Threading_h
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#include <thread>
+#else
+#include <sched.h>
+#endif
+
+/* Skeleton data may be read on several threads at once and shared by skeletons updated on different threads. These
+ * helpers cover the little global and shared state involved, without requiring C++11. */
+#ifdef _MSC_VER
+#define SP_THREAD_LOCAL __declspec(thread)
+#else
+#define SP_THREAD_LOCAL __thread
+#endif
+
+namespace spine {
+	/* Adds delta and returns the new value. Full barrier. */
+	inline int atomicAdd(volatile int *value, int delta) {
+#ifdef _MSC_VER
+		return _InterlockedExchangeAdd((volatile long *) value, delta) + delta;
+#else
+		return __sync_add_and_fetch(value, delta);
+#endif
+	}
+
+	/* Stores desired if *target equals expected and returns the previous value. Full barrier. */
+	inline int atomicCompareExchange(volatile int *target, int expected, int desired) {
+#ifdef _MSC_VER
+		return _InterlockedCompareExchange((volatile long *) target, desired, expected);
+#else
+		return __sync_val_compare_and_swap(target, expected, desired);
+#endif
+	}
+
+	inline void *atomicCompareExchangePointer(void *volatile *target, void *expected, void *desired) {
+#ifdef _MSC_VER
+		return _InterlockedCompareExchangePointer(target, desired, expected);
+#else
+		return __sync_val_compare_and_swap(target, expected, desired);
+#endif
+	}
+
+	/* Reads with acquire semantics, pairs with the barriers above. */
+	inline int atomicLoad(volatile int *value) {
+#ifdef _MSC_VER
+		return _InterlockedOr((volatile long *) value, 0);
+#else
+		return __atomic_load_n(value, __ATOMIC_ACQUIRE);
+#endif
+	}
+
+	/* Gives up the rest of the time slice, for spin waits on work another thread is doing. */
+	inline void threadYield() {
+#ifdef _MSC_VER
+		std::this_thread::yield();
+#else
+		sched_yield();
+#endif
+	}
+}
+
+#endif /* Spine_Threading_h */
@@ -42,6 +42,9 @@ public:
 
 	Vector< Vector<float>* > &decompose(Vector<float> &vertices, Vector<int> &triangles);
 
+	/* Offsets of the vertices of each polygon of the last decompose into its vertices, x at the offset, y after it. */
+	Vector< Vector<int>* > &getConvexPolygonsIndices();
+
 private:
 	Vector<Vector < float>* > _convexPolygons;
 	Vector<Vector < int>* > _convexPolygonsIndices;
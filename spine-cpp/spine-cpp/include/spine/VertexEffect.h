@@ -32,6 +32,7 @@
 
 #include <spine/SpineObject.h>
 #include <spine/MathUtil.h>
+#include <spine/RTTI.h>
 
 namespace spine {
 
@@ -39,18 +40,27 @@ class Skeleton;
 class Color;
 
 class SP_API VertexEffect: public SpineObject {
+RTTI_DECL
+
 public:
 	virtual void begin(Skeleton& skeleton) = 0;
 	virtual void transform(float& x, float& y, float &u, float &v, Color &light, Color &dark) = 0;
+	/// Transforms count vertices in place, positions and uvs hold x, y pairs and colors the light color of each
+	/// vertex. The default calls transform for each vertex with a zero dark color, effects override it to work on
+	/// the whole span without a virtual call per vertex.
+	virtual void transformBatch(float *positions, float *uvs, Color *colors, size_t count);
 	virtual void end() = 0;
 };
 
 class SP_API JitterVertexEffect: public VertexEffect {
+RTTI_DECL
+
 public:
 	JitterVertexEffect(float jitterX, float jitterY);
 
 	void begin(Skeleton& skeleton);
 	void transform(float& x, float& y, float &u, float &v, Color &light, Color &dark);
+	void transformBatch(float *positions, float *uvs, Color *colors, size_t count);
 	void end();
 
 	void setJitterX(float jitterX);
@@ -62,14 +72,18 @@ public:
 protected:
 	float _jitterX;
 	float _jitterY;
+	unsigned int _seed;
 };
 
 class SP_API SwirlVertexEffect: public VertexEffect {
+RTTI_DECL
+
 public:
 	SwirlVertexEffect(float radius, Interpolation &interpolation);
 
 	void begin(Skeleton& skeleton);
 	void transform(float& x, float& y, float &u, float &v, Color &light, Color &dark);
+	void transformBatch(float *positions, float *uvs, Color *colors, size_t count);
 	void end();
 
 	void setCenterX(float centerX);
@@ -90,6 +104,8 @@ public:
 	void setWorldY(float worldY);
 	float getWorldY();
 
+	Interpolation &getInterpolation();
+
 protected:
 	float _centerX;
 	float _centerY;
@@ -35,6 +35,8 @@
 #include <spine/Timeline.h>
 #include <spine/Skeleton.h>
 #include <spine/Event.h>
+#include <spine/AnimationLoader.h>
+#include <spine/Threading.h>
 
 #include <spine/ContainerUtil.h>
 
@@ -42,27 +44,65 @@
 
 using namespace spine;
 
+static const int Unloaded = 0;
+static const int Loading = 1;
+static const int Loaded = 2;
+static const int Unloading = 3;
+
+AnimationUses::AnimationUses() : _count(0), _references(1) {
+}
+
+void AnimationUses::acquire() {
+	atomicAdd(&_references, 1);
+	atomicAdd(&_count, 1);
+}
+
+void AnimationUses::release(bool use) {
+	if (use) atomicAdd(&_count, -1);
+	if (atomicAdd(&_references, -1) == 0) delete this;
+}
+
 Animation::Animation(const String &name, Vector<Timeline *> &timelines, float duration) :
 		_timelines(timelines),
 		_timelineIds(),
 		_duration(duration),
-		_name(name) {
+		_name(name),
+		_loader(NULL),
+		_loaderOffset(0),
+		_loadState(Loaded),
+		_uses(new(__FILE__, __LINE__) AnimationUses()) {
 	assert(_name.length() > 0);
 	for (int i = 0; i < (int)timelines.size(); i++)
 		_timelineIds.put(timelines[i]->getPropertyId(), true);
 }
 
+Animation::Animation(const String &name, AnimationLoader *loader, size_t loaderOffset) :
+		_timelines(),
+		_timelineIds(),
+		_duration(0),
+		_name(name),
+		_loader(loader),
+		_loaderOffset(loaderOffset),
+		_loadState(Unloaded),
+		_uses(new(__FILE__, __LINE__) AnimationUses()) {
+	assert(_name.length() > 0);
+}
+
 bool Animation::hasTimeline(int id) {
+	if (atomicLoad(&_loadState) != Loaded) load();
 	return _timelineIds.containsKey(id);
 }
 
 Animation::~Animation() {
 	ContainerUtil::cleanUpVectorOfPointers(_timelines);
+	_uses->release(false);
 }
 
 void Animation::apply(Skeleton &skeleton, float lastTime, float time, bool loop, Vector<Event *> *pEvents, float alpha,
 	MixBlend blend, MixDirection direction
 ) {
+	if (atomicLoad(&_loadState) != Loaded) load();
+
 	if (loop && _duration != 0) {
 		time = MathUtil::fmod(time, _duration);
 		if (lastTime > 0) {
@@ -80,10 +120,12 @@ const String &Animation::getName() {
 }
 
 Vector<Timeline *> &Animation::getTimelines() {
+	if (atomicLoad(&_loadState) != Loaded) load();
 	return _timelines;
 }
 
 float Animation::getDuration() {
+	if (atomicLoad(&_loadState) != Loaded) load();
 	return _duration;
 }
 
@@ -91,6 +133,42 @@ void Animation::setDuration(float inValue) {
 	_duration = inValue;
 }
 
+bool Animation::isLoaded() {
+	return atomicLoad(&_loadState) == Loaded;
+}
+
+bool Animation::load() {
+	while (true) {
+		int state = atomicLoad(&_loadState);
+		if (state == Loaded) return true;
+		if (state == Unloaded && atomicCompareExchange(&_loadState, Unloaded, Loading) == Unloaded) break;
+		// Another thread is reading or freeing the timelines, which is short.
+		threadYield();
+	}
+	bool result = _loader->loadAnimation(*this, _loaderOffset);
+	// Marked loaded even on failure so an invalid animation is not read again every frame.
+	atomicCompareExchange(&_loadState, Loading, Loaded);
+	return result;
+}
+
+void Animation::unload() {
+	if (!_loader || atomicCompareExchange(&_loadState, Loaded, Unloading) != Loaded) return;
+	// A track entry counts itself before it reads the duration, which waits while the state is Unloading. Both sides
+	// pass a full barrier, so either the entry is seen here or it reads the timelines again afterwards.
+	if (atomicLoad(&_uses->_count) > 0) {
+		atomicCompareExchange(&_loadState, Unloading, Loaded);
+		return;
+	}
+	ContainerUtil::cleanUpVectorOfPointers(_timelines);
+	_timelineIds.clear();
+	_duration = 0;
+	atomicCompareExchange(&_loadState, Unloading, Unloaded);
+}
+
+int Animation::getUseCount() {
+	return atomicLoad(&_uses->_count);
+}
+
 int Animation::binarySearch(Vector<float> &values, float target, int step) {
 	int low = 0;
 	int size = (int)values.size();
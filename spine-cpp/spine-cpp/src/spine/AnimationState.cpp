@@ -32,6 +32,7 @@
 #endif
 
 #include <spine/AnimationState.h>
+#include <spine/Threading.h>
 #include <spine/Animation.h>
 #include <spine/Event.h>
 #include <spine/AnimationStateData.h>
@@ -57,7 +58,7 @@ void dummyOnAnimationEventFunc(AnimationState *state, spine::EventType type, Tra
 	SP_UNUSED(event);
 }
 
-TrackEntry::TrackEntry() : _animation(NULL), _next(NULL), _mixingFrom(NULL), _mixingTo(0), _trackIndex(0), _loop(false), _holdPrevious(false),
+TrackEntry::TrackEntry() : _animation(NULL), _uses(NULL), _next(NULL), _mixingFrom(NULL), _mixingTo(0), _trackIndex(0), _loop(false), _holdPrevious(false),
 	_eventThreshold(0), _attachmentThreshold(0), _drawOrderThreshold(0), _animationStart(0),
 	_animationEnd(0), _animationLast(0), _nextAnimationLast(0), _delay(0), _trackTime(0),
 	_trackLast(0), _nextTrackLast(0), _trackEnd(0), _timeScale(1.0f), _alpha(0), _mixTime(0),
@@ -65,7 +66,10 @@ TrackEntry::TrackEntry() : _animation(NULL), _next(NULL), _mixingFrom(NULL), _mi
 	_listener(dummyOnAnimationEventFunc), _listenerObject(NULL) {
 }
 
-TrackEntry::~TrackEntry() { }
+TrackEntry::~TrackEntry() {
+	// The counter outlives the animation, the SkeletonData may already be deleted
+	if (_uses) _uses->release(true);
+}
 
 int TrackEntry::getTrackIndex() { return _trackIndex; }
 
@@ -173,6 +177,8 @@ void TrackEntry::setListener(AnimationStateListenerObject* inValue) {
 }
 
 void TrackEntry::reset() {
+	if (_uses) _uses->release(true);
+	_uses = NULL;
 	_animation = NULL;
 	_next = NULL;
 	_mixingFrom = NULL;
@@ -940,6 +946,8 @@ TrackEntry *AnimationState::newTrackEntry(size_t trackIndex, Animation *animatio
 
 	entry._trackIndex = trackIndex;
 	entry._animation = animation;
+	entry._uses = animation->_uses;
+	entry._uses->acquire();
 	entry._loop = loop;
 	entry._holdPrevious = 0;
 
@@ -55,12 +55,12 @@ Atlas::Atlas(const String &path, TextureLoader *textureLoader, bool createTextur
 	memcpy(dir, path.buffer(), dirLength);
 	dir[dirLength] = '\0';
 
-	data = SpineExtension::readFile(path, &length);
+	data = SpineExtension::mapFile(path, &length);
 	if (data) {
 		load(data, length, dir, createTexture);
 	}
 
-	SpineExtension::free(data, __FILE__, __LINE__);
+	SpineExtension::unmapFile(data, length);
 	SpineExtension::free(dir, __FILE__, __LINE__);
 }
 
@@ -98,6 +98,10 @@ Vector<AtlasPage*> &Atlas::getPages() {
 	return _pages;
 }
 
+Vector<AtlasRegion*> &Atlas::getRegions() {
+	return _regions;
+}
+
 void Atlas::load(const char *begin, int length, const char *dir, bool createTexture) {
 	static const char *formatNames[] = {"", "Alpha", "Intensity", "LuminanceAlpha", "RGB565", "RGBA4444", "RGB888", "RGBA8888"};
 	static const char *textureFilterNames[] = {"", "Nearest", "Linear", "MipMap", "MipMapNearestNearest", "MipMapLinearNearest",
@@ -132,7 +136,9 @@ void Atlas::load(const char *begin, int length, const char *dir, bool createText
 			page->height = toInt(tuple + 1);
 			readTuple(&begin, end, tuple);
 
-			page->format = (Format) indexOf(formatNames, 8, tuple);
+			/* formatNames starts with an empty name, Format has no unknown value. */
+			int format = indexOf(formatNames, 8, tuple);
+			page->format = format > 0 ? (Format) (format - 1) : Format_RGBA8888;
 
 			readTuple(&begin, end, tuple);
 			page->minFilter = (TextureFilter) indexOf(textureFilterNames, 8, tuple);
@@ -155,11 +161,9 @@ void Atlas::load(const char *begin, int length, const char *dir, bool createText
 				}
 			}
 
-			if (createTexture) {
-				if (_textureLoader) _textureLoader->load(*page, String(path));
-				SpineExtension::free(path, __FILE__, __LINE__);
-			} else
-				page->texturePath = String(path, true);
+			/* Kept so the page can be loaded again after its texture was unloaded. */
+			page->texturePath = String(path, true);
+			if (createTexture && _textureLoader) _textureLoader->load(*page, page->texturePath);
 
 			_pages.add(page);
 		} else {
@@ -268,8 +272,8 @@ int Atlas::readLine(const char **begin, const char *end, Str *str) {
 int Atlas::beginPast(Str *str, char c) {
 	const char *begin = str->begin;
 	while (true) {
-		char lastSkippedChar = *begin;
 		if (begin == str->end) return 0;
+		char lastSkippedChar = *begin;
 		begin++;
 		if (lastSkippedChar == c) break;
 	}
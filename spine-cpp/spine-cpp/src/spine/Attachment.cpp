@@ -39,7 +39,7 @@ using namespace spine;
 
 RTTI_IMPL_NOPARENT(Attachment)
 
-Attachment::Attachment(const String &name) : _name(name), _refCount(0) {
+Attachment::Attachment(const String &name) : _name(name), _refCount(0), _geometryVersion(0) {
 	assert(_name.length() > 0);
 }
 
@@ -61,3 +61,11 @@ void Attachment::reference() {
 void Attachment::dereference() {
 	_refCount--;
 }
+
+unsigned int Attachment::getGeometryVersion() {
+	return _geometryVersion;
+}
+
+void Attachment::geometryChanged() {
+	_geometryVersion++;
+}
@@ -76,13 +76,38 @@ Bone::Bone(BoneData &data, Skeleton &skeleton, Bone *parent) : Updatable(),
 	_d(1),
 	_worldY(0),
 	_sorted(false),
-	_active(false)
+	_active(false),
+	_worldVersion(0),
+	_ux(0),
+	_uy(0),
+	_urotation(0),
+	_uscaleX(0),
+	_uscaleY(0),
+	_ushearX(0),
+	_ushearY(0),
+	_updateVersion(0),
+	_parentVersion(0)
 {
 	setToSetupPose();
 }
 
 void Bone::update() {
+	/* Skip when the world transform is still the one computed from the same local transform and parent. */
+	if (!_skeleton._updateAllBones && _worldVersion == _updateVersion && (!_parent || _parent->_worldVersion == _parentVersion)
+		&& _x == _ux && _y == _uy && _rotation == _urotation && _scaleX == _uscaleX && _scaleY == _uscaleY
+		&& _shearX == _ushearX && _shearY == _ushearY)
+		return;
+
 	updateWorldTransform(_x, _y, _rotation, _scaleX, _scaleY, _shearX, _shearY);
+	_ux = _x;
+	_uy = _y;
+	_urotation = _rotation;
+	_uscaleX = _scaleX;
+	_uscaleY = _scaleY;
+	_ushearX = _shearX;
+	_ushearY = _shearY;
+	_updateVersion = _worldVersion;
+	_parentVersion = _parent ? _parent->_worldVersion : 0;
 }
 
 void Bone::updateWorldTransform() {
@@ -90,6 +115,12 @@ void Bone::updateWorldTransform() {
 }
 
 void Bone::updateWorldTransform(float x, float y, float rotation, float scaleX, float scaleY, float shearX, float shearY) {
+	float a = _a, b = _b, c = _c, d = _d, worldX = _worldX, worldY = _worldY;
+	computeWorldTransform(x, y, rotation, scaleX, scaleY, shearX, shearY);
+	if (_a != a || _b != b || _c != c || _d != d || _worldX != worldX || _worldY != worldY) _worldVersion++;
+}
+
+void Bone::computeWorldTransform(float x, float y, float rotation, float scaleX, float scaleY, float shearX, float shearY) {
 	float cosine, sine;
 	float pa, pb, pc, pd;
 	Bone *parent = _parent;
@@ -266,6 +297,7 @@ void Bone::rotateWorld(float degrees) {
 	_d = sin * b + cos * d;
 
 	_appliedValid = false;
+	_worldVersion++;
 }
 
 float Bone::getWorldToLocalRotationX() {
@@ -434,6 +466,7 @@ float Bone::getA() {
 
 void Bone::setA(float inValue) {
 	_a = inValue;
+	_worldVersion++;
 }
 
 float Bone::getB() {
@@ -442,6 +475,7 @@ float Bone::getB() {
 
 void Bone::setB(float inValue) {
 	_b = inValue;
+	_worldVersion++;
 }
 
 float Bone::getC() {
@@ -450,6 +484,7 @@ float Bone::getC() {
 
 void Bone::setC(float inValue) {
 	_c = inValue;
+	_worldVersion++;
 }
 
 float Bone::getD() {
@@ -458,6 +493,7 @@ float Bone::getD() {
 
 void Bone::setD(float inValue) {
 	_d = inValue;
+	_worldVersion++;
 }
 
 float Bone::getWorldX() {
@@ -466,6 +502,7 @@ float Bone::getWorldX() {
 
 void Bone::setWorldX(float inValue) {
 	_worldX = inValue;
+	_worldVersion++;
 }
 
 float Bone::getWorldY() {
@@ -474,6 +511,7 @@ float Bone::getWorldY() {
 
 void Bone::setWorldY(float inValue) {
 	_worldY = inValue;
+	_worldVersion++;
 }
 
 float Bone::getWorldRotationX() {
@@ -540,6 +578,10 @@ void Bone::updateAppliedTransform() {
 	}
 }
 
+unsigned int Bone::getWorldVersion() {
+	return _worldVersion;
+}
+
 bool Bone::isActive() {
 	return _active;
 }
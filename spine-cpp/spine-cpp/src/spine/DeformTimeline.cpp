@@ -82,6 +82,7 @@ void DeformTimeline::apply(Skeleton &skeleton, float lastTime, float time, Vecto
 	}
 
 	Vector<float> &deformArray = slot._deform;
+	slot._deformVersion++;
 	if (deformArray.size() == 0) {
 		blend = MixBlend_Setup;
 	}
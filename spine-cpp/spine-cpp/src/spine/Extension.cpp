@@ -33,9 +33,18 @@
 
 #include <spine/Extension.h>
 #include <spine/SpineString.h>
+#include <spine/Threading.h>
 
 #include <assert.h>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SPINE_HAVE_MMAP
+#endif
+
 using namespace spine;
 
 SpineExtension *SpineExtension::_instance = NULL;
@@ -47,7 +56,11 @@ void SpineExtension::setInstance(SpineExtension *inValue) {
 }
 
 SpineExtension *SpineExtension::getInstance() {
-	if (!_instance) _instance = spine::getDefaultExtension();
+	if (!_instance) {
+		/* Threads racing on the first call each create an extension, only the first one stored is kept. */
+		SpineExtension *instance = spine::getDefaultExtension();
+		if (atomicCompareExchangePointer((void *volatile *) &_instance, NULL, instance) != NULL) delete instance;
+	}
 	assert(_instance);
 
 	return _instance;
@@ -59,6 +72,17 @@ SpineExtension::~SpineExtension() {
 SpineExtension::SpineExtension() {
 }
 
+const char *SpineExtension::_mapFile(const String &path, int *length) {
+	*length = 0;
+	return _readFile(path, length);
+}
+
+void SpineExtension::_unmapFile(const char *data, int length) {
+	SP_UNUSED(length);
+
+	if (data) _free((void *) data, __FILE__, __LINE__);
+}
+
 DefaultSpineExtension::~DefaultSpineExtension() {
 }
 
@@ -123,5 +147,86 @@ char *DefaultSpineExtension::_readFile(const String &path, int *length) {
 	return data;
 }
 
+#ifdef SPINE_HAVE_MMAP
+/* Stored right before the data returned by _mapFile, tells _unmapFile how it was obtained. */
+struct MappedFileHeader {
+	/* Bytes mapped from the start of the header page, 0 if the data was read into a buffer. */
+	size_t mappedLength;
+	/* Keeps the data 16 byte aligned, as malloc returns it. */
+	size_t padding;
+};
+
+static const char *readWithHeader(const char *path, size_t length) {
+	FILE *file = fopen(path, "rb");
+	if (!file) return NULL;
+	char *buffer = SpineExtension::alloc<char>(sizeof(MappedFileHeader) + length, __FILE__, __LINE__);
+	if (fread(buffer + sizeof(MappedFileHeader), 1, length, file) != length) {
+		SpineExtension::free(buffer, __FILE__, __LINE__);
+		buffer = NULL;
+	}
+	fclose(file);
+	if (!buffer) return NULL;
+	((MappedFileHeader *) buffer)->mappedLength = 0;
+	return buffer + sizeof(MappedFileHeader);
+}
+#endif
+
+const char *DefaultSpineExtension::_mapFile(const String &path, int *length) {
+#ifdef SPINE_HAVE_MMAP
+	*length = 0;
+	int fd = open(path.buffer(), O_RDONLY);
+	if (fd < 0) return NULL;
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+		close(fd);
+		return NULL;
+	}
+
+	/* Parsers may peek one byte past the end, which is only safe inside the zero filled tail of the
+	 * last page. Files that end exactly on a page boundary are read into a buffer instead. */
+	size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+	size_t size = (size_t) st.st_size;
+	const char *data;
+	if (size % pageSize == 0) {
+		close(fd);
+		data = readWithHeader(path.buffer(), size);
+	} else {
+		/* One page is reserved in front of the file for the header. */
+		size_t mappedLength = pageSize + size;
+		char *base = (char *) mmap(NULL, mappedLength, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (base != MAP_FAILED &&
+			mmap(base + pageSize, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED) {
+			munmap(base, mappedLength);
+			base = (char *) MAP_FAILED;
+		}
+		close(fd);
+		if (base == MAP_FAILED) return NULL;
+		((MappedFileHeader *) (base + pageSize) - 1)->mappedLength = mappedLength;
+		data = base + pageSize;
+	}
+	if (data) *length = (int) size;
+	return data;
+#else
+	return SpineExtension::_mapFile(path, length);
+#endif
+}
+
+void DefaultSpineExtension::_unmapFile(const char *data, int length) {
+#ifdef SPINE_HAVE_MMAP
+	SP_UNUSED(length);
+	if (!data) return;
+	MappedFileHeader *header = (MappedFileHeader *) data - 1;
+	if (header->mappedLength == 0) {
+		SpineExtension::free(header, __FILE__, __LINE__);
+	} else {
+		size_t pageSize = (size_t) sysconf(_SC_PAGESIZE);
+		munmap((void *) (data - pageSize), header->mappedLength);
+	}
+#else
+	SpineExtension::_unmapFile(data, length);
+#endif
+}
+
 DefaultSpineExtension::DefaultSpineExtension() : SpineExtension() {
 }
@@ -55,11 +55,57 @@ const int Json::JSON_STRING = 4;
 const int Json::JSON_ARRAY = 5;
 const int Json::JSON_OBJECT = 6;
 
-const char *Json::_error = NULL;
+SP_THREAD_LOCAL const char *Json::_error = NULL;
+
+#define JSON_ARENA_BLOCK_SIZE (64 * 1024)
+#define JSON_ARENA_ALIGN(size) (((size) + sizeof(void *) * 2 - 1) & ~(sizeof(void *) * 2 - 1))
+
+class Json::Arena : public SpineObject {
+public:
+	Arena() : _text(NULL), _blocks(NULL), _cursor(NULL), _end(NULL) {
+	}
+
+	~Arena() {
+		while (_blocks) {
+			Block *next = _blocks->next;
+			SpineExtension::free(_blocks, __FILE__, __LINE__);
+			_blocks = next;
+		}
+	}
+
+	void *alloc(size_t size) {
+		size = JSON_ARENA_ALIGN(size);
+		if (_cursor == NULL || (size_t) (_end - _cursor) < size) {
+			size_t blockSize = size > JSON_ARENA_BLOCK_SIZE ? size : JSON_ARENA_BLOCK_SIZE;
+			Block *block = (Block *) SpineExtension::alloc<char>(JSON_ARENA_ALIGN(sizeof(Block)) + blockSize, __FILE__, __LINE__);
+			if (!block) return NULL;
+			block->next = _blocks;
+			_blocks = block;
+			_cursor = (char *) block + JSON_ARENA_ALIGN(sizeof(Block));
+			_end = _cursor + blockSize;
+		}
+		void *result = _cursor;
+		_cursor += size;
+		return result;
+	}
+
+	char *_text;
+
+private:
+	struct Block {
+		Block *next;
+	};
+
+	Block *_blocks;
+	char *_cursor;
+	char *_end;
+};
 
 Json *Json::getItem(Json *object, const char *string) {
+	/* Cheap first character check (ASCII case folded) before the full compare. */
+	const char first = string ? (char) (*string | 0x20) : 0;
 	Json *c = object->_child;
-	while (c && json_strcasecmp(c->_name, string)) {
+	while (c && (!c->_name || !string || (char) (*c->_name | 0x20) != first || json_strcasecmp(c->_name, string))) {
 		c = c->_next;
 	}
 	return c;
@@ -101,6 +147,7 @@ const char *Json::getError() {
 }
 
 Json::Json(const char *value) :
+		_arena(NULL),
 		_next(NULL),
 #if SPINE_JSON_HAVE_PREV
 		_prev(NULL),
@@ -113,30 +160,51 @@ Json::Json(const char *value) :
 		_valueFloat(0),
 		_name(NULL) {
 	if (value) {
-		value = parseValue(this, skip(value));
+		parse(value, strlen(value));
+	}
+}
 
-		assert(value);
+Json::Json(const char *value, size_t length) :
+		_arena(NULL),
+		_next(NULL),
+#if SPINE_JSON_HAVE_PREV
+		_prev(NULL),
+#endif
+		_child(NULL),
+		_type(0),
+		_size(0),
+		_valueString(NULL),
+		_valueInt(0),
+		_valueFloat(0),
+		_name(NULL) {
+	if (value) {
+		parse(value, length);
 	}
 }
 
 Json::~Json() {
-    spine::Json* curr = nullptr;
-    spine::Json* next = _child;
-    do {
-        curr = next;
-        if (curr) {
-            next = curr->_next;
-        }
-        delete curr;
-    } while(next);
-
-    if (_valueString) {
-        SpineExtension::free(_valueString, __FILE__, __LINE__);
-    }
-
-    if (_name) {
-        SpineExtension::free(_name, __FILE__, __LINE__);
-    }
+	/* Children and strings are owned by the root's arena. */
+	if (_arena) {
+		delete _arena;
+	}
+}
+
+void Json::parse(const char *value, size_t length) {
+	/* Strings are unescaped in place and never grow, so one copy of the text serves as the string storage. */
+	_arena = new(__FILE__, __LINE__) Arena();
+	char *text = (char *) _arena->alloc(length + 1);
+	memcpy(text, value, length);
+	text[length] = '\0';
+	_arena->_text = text;
+
+	const char *end = parseValue(this, skip(text), _arena);
+
+	assert(end);
+	SP_UNUSED(end);
+}
+
+size_t Json::getTextOffset(const char *string) {
+	return (size_t) (string - _arena->_text);
 }
 
 const char *Json::skip(const char *inValue) {
@@ -152,7 +220,19 @@ const char *Json::skip(const char *inValue) {
 	return inValue;
 }
 
-const char *Json::parseValue(Json *item, const char *value) {
+char *Json::skip(char *inValue) {
+	return (char *) skip((const char *) inValue);
+}
+
+Json *Json::newItem(Arena *arena) {
+	void *mem = arena->alloc(sizeof(Json));
+	if (!mem) {
+		return NULL;
+	}
+	return new(mem) Json(NULL);
+}
+
+char *Json::parseValue(Json *item, char *value, Arena *arena) {
 	/* Referenced by constructor, parseArray(), and parseObject(). */
 	/* Always called with the result of skip(). */
 #ifdef SPINE_JSON_DEBUG /* Checked at entry to graph, constructor, and after every parse call. */
@@ -189,9 +269,9 @@ const char *Json::parseValue(Json *item, const char *value) {
 	case '\"':
 		return parseString(item, value);
 	case '[':
-		return parseArray(item, value);
+		return parseArray(item, value, arena);
 	case '{':
-		return parseObject(item, value);
+		return parseObject(item, value, arena);
 	case '-': /* fallthrough */
 	case '0': /* fallthrough */
 	case '1': /* fallthrough */
@@ -214,8 +294,8 @@ const char *Json::parseValue(Json *item, const char *value) {
 
 static const unsigned char firstByteMark[7] = {0x00, 0x00, 0xC0, 0xE0, 0xF0, 0xF8, 0xFC};
 
-const char *Json::parseString(Json *item, const char *str) {
-	const char *ptr = str + 1;
+char *Json::parseString(Json *item, char *str) {
+	char *ptr = str + 1;
 	char *ptr2;
 	char *out;
 	int len = 0;
@@ -226,18 +306,9 @@ const char *Json::parseString(Json *item, const char *str) {
 		return 0;
 	} /* not a string! */
 
-	while (*ptr != '\"' && *ptr && ++len) {
-		if (*ptr++ == '\\') {
-			ptr++; /* Skip escaped quotes. */
-		}
-	}
-
-	out = SpineExtension::alloc<char>(len + 1, __FILE__, __LINE__); /* The length needed for the string, roughly. */
-	if (!out) {
-		return 0;
-	}
-
-	ptr = str + 1;
+	/* Unescaping never makes the string longer, so it is written over the source text. The
+	 * opening quote is overwritten too, which keeps the terminator inside the consumed range. */
+	out = str;
 	ptr2 = out;
 	while (*ptr != '\"' && *ptr) {
 		if (*ptr != '\\') {
@@ -331,10 +402,26 @@ const char *Json::parseString(Json *item, const char *str) {
 	return ptr;
 }
 
-const char *Json::parseNumber(Json *item, const char *num) {
-	double result = 0.0;
+/* Exactly representable powers of ten, larger exponents fall back to pow(). */
+static const double powersOf10[] = {
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static double scaleByPowerOf10(double value, int exponent) {
+	if (exponent >= 0) {
+		return exponent <= 22 ? value * powersOf10[exponent] : value * pow(10.0, exponent);
+	}
+	return -exponent <= 22 ? value / powersOf10[-exponent] : value / pow(10.0, -exponent);
+}
+
+char *Json::parseNumber(Json *item, char *num) {
+	/* Digits are accumulated into an integer mantissa and scaled once at the end. */
+	unsigned long long mantissa = 0;
+	int digits = 0;
+	int exponent = 0;
 	int negative = 0;
-	char *ptr = (char *) num;
+	char *ptr = num;
 
 	if (*ptr == '-') {
 		negative = -1;
@@ -342,31 +429,31 @@ const char *Json::parseNumber(Json *item, const char *num) {
 	}
 
 	while (*ptr >= '0' && *ptr <= '9') {
-		result = result * 10.0 + (*ptr - '0');
+		if (digits < 19) {
+			mantissa = mantissa * 10 + (*ptr - '0');
+			if (mantissa) ++digits;
+		} else {
+			++exponent; /* Drop digits beyond the mantissa's precision. */
+		}
 		++ptr;
 	}
 
 	if (*ptr == '.') {
-		double fraction = 0.0;
-		int n = 0;
 		++ptr;
 
 		while (*ptr >= '0' && *ptr <= '9') {
-			fraction = (fraction * 10.0) + (*ptr - '0');
+			if (digits < 19) {
+				mantissa = mantissa * 10 + (*ptr - '0');
+				if (mantissa) ++digits;
+				--exponent;
+			}
 			++ptr;
-			++n;
 		}
-		result += fraction / pow(10.0, n);
-	}
-
-	if (negative) {
-		result = -result;
 	}
 
 	if (*ptr == 'e' || *ptr == 'E') {
-		double exponent = 0;
+		int explicitExponent = 0;
 		int expNegative = 0;
-		int n = 0;
 		++ptr;
 
 		if (*ptr == '-') {
@@ -377,20 +464,19 @@ const char *Json::parseNumber(Json *item, const char *num) {
 		}
 
 		while (*ptr >= '0' && *ptr <= '9') {
-			exponent = (exponent * 10.0) + (*ptr - '0');
+			if (explicitExponent < 10000) explicitExponent = explicitExponent * 10 + (*ptr - '0');
 			++ptr;
-			++n;
 		}
 
-		if (expNegative) {
-			result = result / pow(10, exponent);
-		} else {
-			result = result * pow(10, exponent);
-		}
+		exponent += expNegative ? -explicitExponent : explicitExponent;
 	}
 
 	if (ptr != num) {
 		/* Parse success, number found. */
+		double result = exponent ? scaleByPowerOf10((double) mantissa, exponent) : (double) mantissa;
+		if (negative) {
+			result = -result;
+		}
 		item->_valueFloat = (float)result;
 		item->_valueInt = (int)result;
 		item->_type = JSON_NUMBER;
@@ -402,7 +488,7 @@ const char *Json::parseNumber(Json *item, const char *num) {
 	}
 }
 
-const char *Json::parseArray(Json *item, const char *value) {
+char *Json::parseArray(Json *item, char *value, Arena *arena) {
 	Json *child;
 
 #ifdef SPINE_JSON_DEBUG /* unnecessary, only callsite (parse_value) verifies this */
@@ -418,12 +504,12 @@ const char *Json::parseArray(Json *item, const char *value) {
 		return value + 1; /* empty array. */
 	}
 
-	item->_child = child = new(__FILE__, __LINE__) Json(NULL);
+	item->_child = child = newItem(arena);
 	if (!item->_child) {
 		return NULL; /* memory fail */
 	}
 
-	value = skip(parseValue(child, skip(value))); /* skip any spacing, get the value. */
+	value = skip(parseValue(child, skip(value), arena)); /* skip any spacing, get the value. */
 
 	if (!value) {
 		return NULL;
@@ -432,7 +518,7 @@ const char *Json::parseArray(Json *item, const char *value) {
 	item->_size = 1;
 
 	while (*value == ',') {
-		Json *new_item = new(__FILE__, __LINE__) Json(NULL);
+		Json *new_item = newItem(arena);
 		if (!new_item) {
 			return NULL; /* memory fail */
 		}
@@ -441,7 +527,7 @@ const char *Json::parseArray(Json *item, const char *value) {
 		new_item->prev = child;
 #endif
 		child = new_item;
-		value = skip(parseValue(child, skip(value + 1)));
+		value = skip(parseValue(child, skip(value + 1), arena));
 		if (!value) {
 			return NULL; /* parse fail */
 		}
@@ -458,7 +544,7 @@ const char *Json::parseArray(Json *item, const char *value) {
 }
 
 /* Build an object from the text. */
-const char *Json::parseObject(Json *item, const char *value) {
+char *Json::parseObject(Json *item, char *value, Arena *arena) {
 	Json *child;
 
 #ifdef SPINE_JSON_DEBUG /* unnecessary, only callsite (parse_value) verifies this */
@@ -474,7 +560,7 @@ const char *Json::parseObject(Json *item, const char *value) {
 		return value + 1; /* empty array. */
 	}
 
-	item->_child = child = new(__FILE__, __LINE__) Json(NULL);
+	item->_child = child = newItem(arena);
 	if (!item->_child) {
 		return NULL;
 	}
@@ -489,7 +575,7 @@ const char *Json::parseObject(Json *item, const char *value) {
 		return NULL;
 	} /* fail! */
 
-	value = skip(parseValue(child, skip(value + 1))); /* skip any spacing, get the value. */
+	value = skip(parseValue(child, skip(value + 1), arena)); /* skip any spacing, get the value. */
 	if (!value) {
 		return NULL;
 	}
@@ -497,7 +583,7 @@ const char *Json::parseObject(Json *item, const char *value) {
 	item->_size = 1;
 
 	while (*value == ',') {
-		Json *new_item = new(__FILE__, __LINE__) Json(NULL);
+		Json *new_item = newItem(arena);
 		if (!new_item) {
 			return NULL; /* memory fail */
 		}
@@ -517,7 +603,7 @@ const char *Json::parseObject(Json *item, const char *value) {
 			return NULL;
 		} /* fail! */
 
-		value = skip(parseValue(child, skip(value + 1))); /* skip any spacing, get the value. */
+		value = skip(parseValue(child, skip(value + 1), arena)); /* skip any spacing, get the value. */
 		if (!value) {
 			return NULL;
 		}
@@ -203,6 +203,7 @@ void PathConstraint::update() {
 		}
 
 		bone._appliedValid = false;
+		bone._worldVersion++;
 	}
 }
 
@@ -101,6 +101,8 @@ void RegionAttachment::updateOffset() {
 	_vertexOffset[URY] = localY2Cos + localX2Sin;
 	_vertexOffset[BRX] = localX2Cos - localYSin;
 	_vertexOffset[BRY] = localYCos + localX2Sin;
+
+	geometryChanged();
 }
 
 void RegionAttachment::setUVs(float u, float v, float u2, float v2, bool rotate) {
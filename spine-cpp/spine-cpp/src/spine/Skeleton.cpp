@@ -65,7 +65,14 @@ Skeleton::Skeleton(SkeletonData *skeletonData) :
 		_scaleX(1),
 		_scaleY(1),
 		_x(0),
-		_y(0) {
+		_y(0),
+		_skipUnchangedBones(false),
+		_updateAllBones(true),
+		_bonesChanged(true),
+		_updateX(0),
+		_updateY(0),
+		_updateScaleX(1),
+		_updateScaleY(1) {
 	_bones.ensureCapacity(_data->getBones().size());
 	for (size_t i = 0; i < _data->getBones().size(); ++i) {
 		BoneData *data = _data->getBones()[i];
@@ -135,6 +142,7 @@ Skeleton::~Skeleton() {
 void Skeleton::updateCache() {
 	_updateCache.clear();
 	_updateCacheReset.clear();
+	_bonesChanged = true;
 
 	for (size_t i = 0, n = _bones.size(); i < n; ++i) {
 		Bone* bone = _bones[i];
@@ -226,11 +234,29 @@ void Skeleton::updateWorldTransform() {
 		bone._appliedValid = true;
 	}
 
+	float scaleY = getScaleY();
+	_updateAllBones = !_skipUnchangedBones || _bonesChanged || _x != _updateX || _y != _updateY || _scaleX != _updateScaleX ||
+		scaleY != _updateScaleY;
+	_bonesChanged = false;
+	_updateX = _x;
+	_updateY = _y;
+	_updateScaleX = _scaleX;
+	_updateScaleY = scaleY;
+
 	for (size_t i = 0, n = _updateCache.size(); i < n; ++i) {
 		_updateCache[i]->update();
 	}
 }
 
+void Skeleton::setSkipUnchangedBones(bool inValue) {
+	_skipUnchangedBones = inValue;
+	_bonesChanged = true;
+}
+
+bool Skeleton::getSkipUnchangedBones() {
+	return _skipUnchangedBones;
+}
+
 void Skeleton::setToSetupPose() {
 	setBonesToSetupPose();
 	setSlotsToSetupPose();
@@ -73,9 +73,39 @@
 #include <spine/DrawOrderTimeline.h>
 #include <spine/EventTimeline.h>
 #include <spine/Event.h>
+#include <spine/AnimationLoader.h>
 
 using namespace spine;
 
+/// Keeps a copy of the animation section and reads one animation at a time.
+class SkeletonBinary::LazyAnimationLoader : public AnimationLoader {
+public:
+	LazyAnimationLoader(SkeletonData *skeletonData, float scale) : AnimationLoader(scale), _skeletonData(skeletonData) {
+	}
+
+	virtual bool loadAnimation(Animation &animation, size_t offset) {
+		DataInput input;
+		input.cursor = _data.buffer() + offset;
+		input.end = _data.buffer() + _data.size();
+		/* A reader per call, animations may be loaded on several threads at once. */
+		SkeletonBinary binary((Atlas *) NULL);
+		binary.setScale(_scale);
+		Animation *decoded = binary.readAnimation(animation.getName(), &input, _skeletonData);
+		if (!decoded) {
+			setError(binary.getError());
+			return false;
+		}
+		setTimelines(animation, *decoded);
+		delete decoded;
+		return true;
+	}
+
+	Vector<unsigned char> _data;
+
+private:
+	SkeletonData *_skeletonData;
+};
+
 const int SkeletonBinary::BONE_ROTATE = 0;
 const int SkeletonBinary::BONE_TRANSLATE = 1;
 const int SkeletonBinary::BONE_SCALE = 2;
@@ -94,12 +124,13 @@ const int SkeletonBinary::CURVE_STEPPED = 1;
 const int SkeletonBinary::CURVE_BEZIER = 2;
 
 SkeletonBinary::SkeletonBinary(Atlas *atlasArray) : _attachmentLoader(
-		new(__FILE__, __LINE__) AtlasAttachmentLoader(atlasArray)), _error(), _scale(1), _ownsLoader(true) {
+		new(__FILE__, __LINE__) AtlasAttachmentLoader(atlasArray)), _error(), _scale(1), _lazyAnimations(false),
+		_ownsLoader(true) {
 
 }
 
 SkeletonBinary::SkeletonBinary(AttachmentLoader *attachmentLoader) : _attachmentLoader(attachmentLoader), _error(),
-	_scale(1), _ownsLoader(false)
+	_scale(1), _lazyAnimations(false), _ownsLoader(false)
 {
 	assert(_attachmentLoader != NULL);
 }
@@ -330,6 +361,21 @@ SkeletonData *SkeletonBinary::readSkeletonData(const unsigned char *binary, cons
 	/* Animations. */
 	int animationsCount = readVarint(input, true);
 	skeletonData->_animations.setSize(animationsCount, 0);
+	if (_lazyAnimations && animationsCount > 0) {
+		LazyAnimationLoader *loader = new(__FILE__, __LINE__) LazyAnimationLoader(skeletonData, _scale);
+		skeletonData->_animationLoader = loader;
+		const unsigned char *start = input->cursor;
+		loader->_data.setSize(input->end - start, 0);
+		memcpy(loader->_data.buffer(), start, input->end - start);
+		for (int i = 0; i < animationsCount; ++i) {
+			String name(readString(input), true);
+			size_t offset = input->cursor - start;
+			skipAnimation(input, skeletonData);
+			skeletonData->_animations[i] = new(__FILE__, __LINE__) Animation(name, loader, offset);
+		}
+		delete input;
+		return skeletonData;
+	}
 	for (int i = 0; i < animationsCount; ++i) {
 		String name(readString(input), true);
 		Animation *animation = readAnimation(name, input, skeletonData);
@@ -348,13 +394,14 @@ SkeletonData *SkeletonBinary::readSkeletonData(const unsigned char *binary, cons
 SkeletonData *SkeletonBinary::readSkeletonDataFile(const String &path) {
 	int length;
 	SkeletonData *skeletonData;
-	const char *binary = SpineExtension::readFile(path.buffer(), &length);
+	const char *binary = SpineExtension::mapFile(path.buffer(), &length);
 	if (length == 0 || !binary) {
+		SpineExtension::unmapFile(binary, length);
 		setError("Unable to read skeleton file: ", path.buffer());
 		return NULL;
 	}
-	skeletonData = readSkeletonData((unsigned char *) binary, length);
-	SpineExtension::free(binary, __FILE__, __LINE__);
+	skeletonData = readSkeletonData((const unsigned char *) binary, length);
+	SpineExtension::unmapFile(binary, length);
 	return skeletonData;
 }
 
@@ -380,7 +427,7 @@ char *SkeletonBinary::readString(DataInput *input) {
 
 char* SkeletonBinary::readStringRef(DataInput* input, SkeletonData* skeletonData) {
 	int index = readVarint(input, true);
-	return index == 0 ? nullptr : skeletonData->_strings[index - 1];
+	return index == 0 ? NULL : skeletonData->_strings[index - 1];
 }
 
 float SkeletonBinary::readFloat(DataInput *input) {
@@ -1017,6 +1064,113 @@ Animation *SkeletonBinary::readAnimation(const String &name, DataInput *input, S
 	return new(__FILE__, __LINE__) Animation(String(name), timelines, duration);
 }
 
+void SkeletonBinary::skipAnimation(DataInput *input, SkeletonData *skeletonData) {
+	// Slot timelines.
+	for (int i = 0, n = readVarint(input, true); i < n; ++i) {
+		readVarint(input, true);
+		for (int ii = 0, nn = readVarint(input, true); ii < nn; ++ii) {
+			unsigned char timelineType = readByte(input);
+			int frameCount = readVarint(input, true);
+			for (int frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+				if (timelineType == SLOT_ATTACHMENT) {
+					input->cursor += 4;
+					readVarint(input, true);
+					continue;
+				}
+				input->cursor += timelineType == SLOT_TWO_COLOR ? 12 : 8;
+				if (frameIndex < frameCount - 1) skipCurve(input);
+			}
+		}
+	}
+
+	// Bone timelines.
+	for (int i = 0, n = readVarint(input, true); i < n; ++i) {
+		readVarint(input, true);
+		for (int ii = 0, nn = readVarint(input, true); ii < nn; ++ii) {
+			unsigned char timelineType = readByte(input);
+			int frameCount = readVarint(input, true);
+			for (int frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+				input->cursor += timelineType == BONE_ROTATE ? 8 : 12;
+				if (frameIndex < frameCount - 1) skipCurve(input);
+			}
+		}
+	}
+
+	// IK timelines.
+	for (int i = 0, n = readVarint(input, true); i < n; ++i) {
+		readVarint(input, true);
+		for (int frameIndex = 0, frameCount = readVarint(input, true); frameIndex < frameCount; ++frameIndex) {
+			input->cursor += 15;
+			if (frameIndex < frameCount - 1) skipCurve(input);
+		}
+	}
+
+	// Transform constraint timelines.
+	for (int i = 0, n = readVarint(input, true); i < n; ++i) {
+		readVarint(input, true);
+		for (int frameIndex = 0, frameCount = readVarint(input, true); frameIndex < frameCount; ++frameIndex) {
+			input->cursor += 20;
+			if (frameIndex < frameCount - 1) skipCurve(input);
+		}
+	}
+
+	// Path constraint timelines.
+	for (int i = 0, n = readVarint(input, true); i < n; ++i) {
+		readVarint(input, true);
+		for (int ii = 0, nn = readVarint(input, true); ii < nn; ++ii) {
+			int timelineType = readSByte(input);
+			int frameCount = readVarint(input, true);
+			if (timelineType != PATH_POSITION && timelineType != PATH_SPACING && timelineType != PATH_MIX) continue;
+			for (int frameIndex = 0; frameIndex < frameCount; ++frameIndex) {
+				input->cursor += timelineType == PATH_MIX ? 12 : 8;
+				if (frameIndex < frameCount - 1) skipCurve(input);
+			}
+		}
+	}
+
+	// Deform timelines.
+	for (int i = 0, n = readVarint(input, true); i < n; ++i) {
+		readVarint(input, true);
+		for (int ii = 0, nn = readVarint(input, true); ii < nn; ++ii) {
+			readVarint(input, true);
+			for (int iii = 0, nnn = readVarint(input, true); iii < nnn; iii++) {
+				readVarint(input, true);
+				for (int frameIndex = 0, frameCount = readVarint(input, true); frameIndex < frameCount; ++frameIndex) {
+					input->cursor += 4;
+					int end = readVarint(input, true);
+					if (end != 0) {
+						readVarint(input, true);
+						input->cursor += end * 4;
+					}
+					if (frameIndex < frameCount - 1) skipCurve(input);
+				}
+			}
+		}
+	}
+
+	// Draw order timeline.
+	for (int i = 0, n = readVarint(input, true); i < n; ++i) {
+		input->cursor += 4;
+		for (int ii = 0, nn = readVarint(input, true); ii < nn; ++ii) {
+			readVarint(input, true);
+			readVarint(input, true);
+		}
+	}
+
+	// Event timeline.
+	for (int i = 0, n = readVarint(input, true); i < n; ++i) {
+		input->cursor += 4;
+		EventData *eventData = skeletonData->_events[readVarint(input, true)];
+		readVarint(input, false);
+		input->cursor += 4;
+		if (readBoolean(input)) {
+			int length = readVarint(input, true);
+			if (length > 1) input->cursor += length - 1;
+		}
+		if (!eventData->_audioPath.isEmpty()) input->cursor += 8;
+	}
+}
+
 void SkeletonBinary::readCurve(DataInput *input, int frameIndex, CurveTimeline *timeline) {
 	switch (readByte(input)) {
 	case CURVE_STEPPED: {
@@ -1033,3 +1187,7 @@ void SkeletonBinary::readCurve(DataInput *input, int frameIndex, CurveTimeline *
 	}
 	}
 }
+
+void SkeletonBinary::skipCurve(DataInput *input) {
+	if (readByte(input) == CURVE_BEZIER) input->cursor += 16;
+}
@@ -0,0 +1,990 @@
+/******************************************************************************
+ * Spine Runtimes License Agreement
+ * Last updated January 1, 2020. Replaces all prior versions.
+ *
+ * Copyright (c) 2013-2020, Esoteric Software LLC
+ *
+ * Integration of the Spine Runtimes into software or otherwise creating
+ * derivative works of the Spine Runtimes is permitted under the terms and
+ * conditions of Section 2 of the Spine Editor License Agreement:
+ * http://esotericsoftware.com/spine-editor-license
+ *
+ * Otherwise, it is permitted to integrate the Spine Runtimes into software
+ * or otherwise create derivative works of the Spine Runtimes (collectively,
+ * "Products"), provided that each user of the Products must obtain their own
+ * Spine Editor license and redistribution of the Products in any form must
+ * include this license and copyright notice.
+ *
+ * THE SPINE RUNTIMES ARE PROVIDED BY ESOTERIC SOFTWARE LLC "AS IS" AND ANY
+ * EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+ * WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+ * DISCLAIMED. IN NO EVENT SHALL ESOTERIC SOFTWARE LLC BE LIABLE FOR ANY
+ * DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+ * (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES,
+ * BUSINESS INTERRUPTION, OR LOSS OF USE, DATA, OR PROFITS) HOWEVER CAUSED AND
+ * ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT
+ * (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF
+ * THE SPINE RUNTIMES, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
+ *****************************************************************************/
+
+#ifdef SPINE_UE4
+#include "SpinePluginPrivatePCH.h"
+#endif
+
+#include <spine/SkeletonBinaryWriter.h>
+
+#include <spine/SkeletonBinary.h>
+#include <spine/Json.h>
+#include <spine/AttachmentType.h>
+#include <spine/TransformMode.h>
+#include <spine/BlendMode.h>
+#include <spine/PositionMode.h>
+#include <spine/SpacingMode.h>
+#include <spine/RotateMode.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+using namespace spine;
+
+SkeletonBinaryWriter::SkeletonBinaryWriter() : _error() {
+}
+
+SkeletonBinaryWriter::~SkeletonBinaryWriter() {
+}
+
+bool SkeletonBinaryWriter::writeSkeletonData(const char *json, int length, Vector<unsigned char> &binary) {
+	_error = "";
+	_strings.clear();
+	_bones.clear();
+	_slots.clear();
+	_ikConstraints.clear();
+	_transformConstraints.clear();
+	_pathConstraints.clear();
+	_skins.clear();
+	_events.clear();
+
+	Json *root = new(__FILE__, __LINE__) Json(json, (size_t) length);
+	if (root->_type != Json::JSON_OBJECT) {
+		delete root;
+		setError("Invalid skeleton JSON: ", Json::getError());
+		return false;
+	}
+
+	DataOutput *header = new(__FILE__, __LINE__) DataOutput();
+	DataOutput *body = new(__FILE__, __LINE__) DataOutput();
+
+	Json *skeleton = Json::getItem(root, "skeleton");
+	writeString(header, skeleton ? Json::getString(skeleton, "hash", 0) : 0);
+	writeString(header, skeleton ? Json::getString(skeleton, "spine", 0) : 0);
+	writeFloat(header, skeleton ? Json::getFloat(skeleton, "x", 0) : 0);
+	writeFloat(header, skeleton ? Json::getFloat(skeleton, "y", 0) : 0);
+	writeFloat(header, skeleton ? Json::getFloat(skeleton, "width", 0) : 0);
+	writeFloat(header, skeleton ? Json::getFloat(skeleton, "height", 0) : 0);
+
+	/* Nonessential data. */
+	writeBoolean(header, true);
+	writeFloat(header, skeleton ? Json::getFloat(skeleton, "fps", 30) : 30);
+	writeString(header, skeleton ? Json::getString(skeleton, "images", 0) : 0);
+	writeString(header, skeleton ? Json::getString(skeleton, "audio", 0) : 0);
+
+	bool ok = writeBones(body, root) && writeSlots(body, root) && writeConstraints(body, root) && writeSkins(body, root) &&
+			  writeEvents(body, root);
+
+	if (ok) {
+		Json *animations = Json::getItem(root, "animations");
+		writeVarint(body, animations ? animations->_size : 0, true);
+		for (Json *animationMap = animations ? animations->_child : NULL; animationMap && ok; animationMap = animationMap->_next) {
+			writeString(body, animationMap->_name);
+			ok = writeAnimation(body, animationMap);
+		}
+	}
+
+	if (ok) {
+		/* The string table precedes the bones, so it is written once every reference is known. */
+		writeVarint(header, (int) _strings.size(), true);
+		for (size_t i = 0; i < _strings.size(); ++i)
+			writeString(header, _strings[i]);
+
+		binary.clear();
+		binary.ensureCapacity(header->buffer.size() + body->buffer.size());
+		for (size_t i = 0; i < header->buffer.size(); ++i)
+			binary.add(header->buffer[i]);
+		for (size_t i = 0; i < body->buffer.size(); ++i)
+			binary.add(body->buffer[i]);
+	}
+
+	/* Names point into the document, release it last. */
+	_strings.clear();
+	_events.clear();
+	delete header;
+	delete body;
+	delete root;
+	return ok;
+}
+
+bool SkeletonBinaryWriter::writeSkeletonDataFile(const String &jsonPath, const String &binaryPath) {
+	int length;
+	char *json = SpineExtension::readFile(jsonPath, &length);
+	if (length == 0 || !json) {
+		setError("Unable to read skeleton file: ", jsonPath.buffer());
+		return false;
+	}
+
+	Vector<unsigned char> binary;
+	bool ok = writeSkeletonData(json, length, binary);
+	SpineExtension::free(json, __FILE__, __LINE__);
+	if (!ok) return false;
+
+	FILE *file = fopen(binaryPath.buffer(), "wb");
+	if (!file) {
+		setError("Unable to write skeleton file: ", binaryPath.buffer());
+		return false;
+	}
+	size_t written = fwrite(binary.buffer(), 1, binary.size(), file);
+	fclose(file);
+	if (written != binary.size()) {
+		setError("Unable to write skeleton file: ", binaryPath.buffer());
+		return false;
+	}
+	return true;
+}
+
+void SkeletonBinaryWriter::setError(const char *value1, const char *value2) {
+	_error = String(value1).append(value2 ? value2 : "");
+}
+
+int SkeletonBinaryWriter::indexOf(Vector<const char *> &names, const char *name) {
+	if (!name) return -1;
+	for (size_t i = 0; i < names.size(); ++i)
+		if (strcmp(names[i], name) == 0) return (int) i;
+	return -1;
+}
+
+void SkeletonBinaryWriter::writeString(DataOutput *output, const char *value) {
+	if (!value) {
+		writeVarint(output, 0, true);
+		return;
+	}
+	int length = (int) strlen(value);
+	writeVarint(output, length + 1, true);
+	for (int i = 0; i < length; ++i)
+		writeByte(output, (unsigned char) value[i]);
+}
+
+void SkeletonBinaryWriter::writeStringRef(DataOutput *output, const char *value) {
+	if (!value) {
+		writeVarint(output, 0, true);
+		return;
+	}
+	int index = indexOf(_strings, value);
+	if (index == -1) {
+		index = (int) _strings.size();
+		_strings.add(value);
+	}
+	writeVarint(output, index + 1, true);
+}
+
+void SkeletonBinaryWriter::writeFloat(DataOutput *output, float value) {
+	union {
+		int intValue;
+		float floatValue;
+	} floatToInt;
+	floatToInt.floatValue = value;
+	writeInt(output, floatToInt.intValue);
+}
+
+void SkeletonBinaryWriter::writeByte(DataOutput *output, unsigned char value) {
+	output->buffer.add(value);
+}
+
+void SkeletonBinaryWriter::writeBoolean(DataOutput *output, bool value) {
+	writeByte(output, value ? 1 : 0);
+}
+
+void SkeletonBinaryWriter::writeInt(DataOutput *output, int value) {
+	writeByte(output, (unsigned char) ((unsigned int) value >> 24));
+	writeByte(output, (unsigned char) ((unsigned int) value >> 16));
+	writeByte(output, (unsigned char) ((unsigned int) value >> 8));
+	writeByte(output, (unsigned char) value);
+}
+
+void SkeletonBinaryWriter::writeColor(DataOutput *output, const char *value, bool hasAlpha) {
+	writeInt(output, toColor(value, hasAlpha));
+}
+
+void SkeletonBinaryWriter::writeVarint(DataOutput *output, int value, bool optimizePositive) {
+	unsigned int bits = optimizePositive ? (unsigned int) value : (((unsigned int) value << 1) ^ (unsigned int) (value >> 31));
+	while (bits > 0x7F) {
+		writeByte(output, (unsigned char) ((bits & 0x7F) | 0x80));
+		bits >>= 7;
+	}
+	writeByte(output, (unsigned char) bits);
+}
+
+int SkeletonBinaryWriter::toColor(const char *value, bool hasAlpha) {
+	/* rrggbbaa, or rrggbb packed as 0x00rrggbb. Missing channels are opaque white. */
+	unsigned int color = 0;
+	int channels = hasAlpha ? 4 : 3;
+	size_t length = value ? strlen(value) : 0;
+	for (int i = 0; i < channels; ++i) {
+		unsigned int channel = 0xff;
+		if (length >= (size_t) (i + 1) * 2) {
+			char digits[3] = {value[i * 2], value[i * 2 + 1], '\0'};
+			channel = (unsigned int) strtoul(digits, NULL, 16);
+		}
+		color = (color << 8) | channel;
+	}
+	return (int) color;
+}
+
+bool SkeletonBinaryWriter::writeBones(DataOutput *output, Json *root) {
+	Json *bones = Json::getItem(root, "bones");
+	writeVarint(output, bones ? bones->_size : 0, true);
+	int i = 0;
+	for (Json *boneMap = bones ? bones->_child : NULL; boneMap; boneMap = boneMap->_next, ++i) {
+		const char *name = Json::getString(boneMap, "name", 0);
+		writeString(output, name);
+		if (i > 0) {
+			/* Only the first bone may be a root. */
+			const char *parentName = Json::getString(boneMap, "parent", 0);
+			int parent = indexOf(_bones, parentName);
+			if (parent == -1) {
+				setError("Parent bone not found: ", parentName ? parentName : name);
+				return false;
+			}
+			writeVarint(output, parent, true);
+		}
+		_bones.add(name);
+
+		writeFloat(output, Json::getFloat(boneMap, "rotation", 0));
+		writeFloat(output, Json::getFloat(boneMap, "x", 0));
+		writeFloat(output, Json::getFloat(boneMap, "y", 0));
+		writeFloat(output, Json::getFloat(boneMap, "scaleX", 1));
+		writeFloat(output, Json::getFloat(boneMap, "scaleY", 1));
+		writeFloat(output, Json::getFloat(boneMap, "shearX", 0));
+		writeFloat(output, Json::getFloat(boneMap, "shearY", 0));
+		writeFloat(output, Json::getFloat(boneMap, "length", 0));
+
+		const char *transformMode = Json::getString(boneMap, "transform", "normal");
+		TransformMode mode = TransformMode_Normal;
+		if (strcmp(transformMode, "onlyTranslation") == 0) mode = TransformMode_OnlyTranslation;
+		else if (strcmp(transformMode, "noRotationOrReflection") == 0) mode = TransformMode_NoRotationOrReflection;
+		else if (strcmp(transformMode, "noScale") == 0) mode = TransformMode_NoScale;
+		else if (strcmp(transformMode, "noScaleOrReflection") == 0) mode = TransformMode_NoScaleOrReflection;
+		writeVarint(output, mode, true);
+		writeBoolean(output, Json::getBoolean(boneMap, "skin", false));
+		writeColor(output, Json::getString(boneMap, "color", "989898ff"));
+	}
+	return true;
+}
+
+bool SkeletonBinaryWriter::writeSlots(DataOutput *output, Json *root) {
+	Json *slots = Json::getItem(root, "slots");
+	writeVarint(output, slots ? slots->_size : 0, true);
+	for (Json *slotMap = slots ? slots->_child : NULL; slotMap; slotMap = slotMap->_next) {
+		const char *name = Json::getString(slotMap, "name", 0);
+		writeString(output, name);
+
+		const char *boneName = Json::getString(slotMap, "bone", 0);
+		int bone = indexOf(_bones, boneName);
+		if (bone == -1) {
+			setError("Slot bone not found: ", boneName);
+			return false;
+		}
+		writeVarint(output, bone, true);
+		writeColor(output, Json::getString(slotMap, "color", "ffffffff"));
+
+		/* An opaque white dark color means none. */
+		const char *dark = Json::getString(slotMap, "dark", 0);
+		writeInt(output, dark ? (toColor(dark, false) << 8) | 0xff : -1);
+
+		Json *item = Json::getItem(slotMap, "attachment");
+		writeStringRef(output, item && item->_type == Json::JSON_STRING ? item->_valueString : NULL);
+
+		BlendMode blendMode = BlendMode_Normal;
+		item = Json::getItem(slotMap, "blend");
+		if (item && item->_type == Json::JSON_STRING) {
+			if (strcmp(item->_valueString, "additive") == 0) blendMode = BlendMode_Additive;
+			else if (strcmp(item->_valueString, "multiply") == 0) blendMode = BlendMode_Multiply;
+			else if (strcmp(item->_valueString, "screen") == 0) blendMode = BlendMode_Screen;
+		}
+		writeVarint(output, blendMode, true);
+		_slots.add(name);
+	}
+	return true;
+}
+
+bool SkeletonBinaryWriter::writeConstraints(DataOutput *output, Json *root) {
+	Json *constraintMap, *boneMap;
+
+	/* IK constraints. */
+	Json *ik = Json::getItem(root, "ik");
+	writeVarint(output, ik ? ik->_size : 0, true);
+	for (constraintMap = ik ? ik->_child : NULL; constraintMap; constraintMap = constraintMap->_next) {
+		const char *name = Json::getString(constraintMap, "name", 0);
+		writeString(output, name);
+		writeVarint(output, Json::getInt(constraintMap, "order", 0), true);
+		writeBoolean(output, Json::getBoolean(constraintMap, "skin", false));
+		Json *bones = Json::getItem(constraintMap, "bones");
+		writeVarint(output, bones ? bones->_size : 0, true);
+		for (boneMap = bones ? bones->_child : NULL; boneMap; boneMap = boneMap->_next) {
+			int bone = indexOf(_bones, boneMap->_valueString);
+			if (bone == -1) {
+				setError("IK bone not found: ", boneMap->_valueString);
+				return false;
+			}
+			writeVarint(output, bone, true);
+		}
+		const char *targetName = Json::getString(constraintMap, "target", 0);
+		int target = indexOf(_bones, targetName);
+		if (target == -1) {
+			setError("Target bone not found: ", targetName);
+			return false;
+		}
+		writeVarint(output, target, true);
+		writeFloat(output, Json::getFloat(constraintMap, "mix", 1));
+		writeFloat(output, Json::getFloat(constraintMap, "softness", 0));
+		writeByte(output, (unsigned char) (signed char) (Json::getInt(constraintMap, "bendPositive", 1) ? 1 : -1));
+		writeBoolean(output, Json::getInt(constraintMap, "compress", 0) != 0);
+		writeBoolean(output, Json::getInt(constraintMap, "stretch", 0) != 0);
+		writeBoolean(output, Json::getInt(constraintMap, "uniform", 0) != 0);
+		_ikConstraints.add(name);
+	}
+
+	/* Transform constraints. */
+	Json *transform = Json::getItem(root, "transform");
+	writeVarint(output, transform ? transform->_size : 0, true);
+	for (constraintMap = transform ? transform->_child : NULL; constraintMap; constraintMap = constraintMap->_next) {
+		const char *name = Json::getString(constraintMap, "name", 0);
+		writeString(output, name);
+		writeVarint(output, Json::getInt(constraintMap, "order", 0), true);
+		writeBoolean(output, Json::getBoolean(constraintMap, "skin", false));
+		Json *bones = Json::getItem(constraintMap, "bones");
+		writeVarint(output, bones ? bones->_size : 0, true);
+		for (boneMap = bones ? bones->_child : NULL; boneMap; boneMap = boneMap->_next) {
+			int bone = indexOf(_bones, boneMap->_valueString);
+			if (bone == -1) {
+				setError("Transform bone not found: ", boneMap->_valueString);
+				return false;
+			}
+			writeVarint(output, bone, true);
+		}
+		const char *targetName = Json::getString(constraintMap, "target", 0);
+		int target = indexOf(_bones, targetName);
+		if (target == -1) {
+			setError("Target bone not found: ", targetName);
+			return false;
+		}
+		writeVarint(output, target, true);
+		writeBoolean(output, Json::getInt(constraintMap, "local", 0) != 0);
+		writeBoolean(output, Json::getInt(constraintMap, "relative", 0) != 0);
+		writeFloat(output, Json::getFloat(constraintMap, "rotation", 0));
+		writeFloat(output, Json::getFloat(constraintMap, "x", 0));
+		writeFloat(output, Json::getFloat(constraintMap, "y", 0));
+		writeFloat(output, Json::getFloat(constraintMap, "scaleX", 0));
+		writeFloat(output, Json::getFloat(constraintMap, "scaleY", 0));
+		writeFloat(output, Json::getFloat(constraintMap, "shearY", 0));
+		writeFloat(output, Json::getFloat(constraintMap, "rotateMix", 1));
+		writeFloat(output, Json::getFloat(constraintMap, "translateMix", 1));
+		writeFloat(output, Json::getFloat(constraintMap, "scaleMix", 1));
+		writeFloat(output, Json::getFloat(constraintMap, "shearMix", 1));
+		_transformConstraints.add(name);
+	}
+
+	/* Path constraints. */
+	Json *path = Json::getItem(root, "path");
+	writeVarint(output, path ? path->_size : 0, true);
+	for (constraintMap = path ? path->_child : NULL; constraintMap; constraintMap = constraintMap->_next) {
+		const char *name = Json::getString(constraintMap, "name", 0);
+		writeString(output, name);
+		writeVarint(output, Json::getInt(constraintMap, "order", 0), true);
+		writeBoolean(output, Json::getBoolean(constraintMap, "skin", false));
+		Json *bones = Json::getItem(constraintMap, "bones");
+		writeVarint(output, bones ? bones->_size : 0, true);
+		for (boneMap = bones ? bones->_child : NULL; boneMap; boneMap = boneMap->_next) {
+			int bone = indexOf(_bones, boneMap->_valueString);
+			if (bone == -1) {
+				setError("Path bone not found: ", boneMap->_valueString);
+				return false;
+			}
+			writeVarint(output, bone, true);
+		}
+		const char *targetName = Json::getString(constraintMap, "target", 0);
+		int target = indexOf(_slots, targetName);
+		if (target == -1) {
+			setError("Target slot not found: ", targetName);
+			return false;
+		}
+		writeVarint(output, target, true);
+
+		const char *item = Json::getString(constraintMap, "positionMode", "percent");
+		writeVarint(output, strcmp(item, "fixed") == 0 ? PositionMode_Fixed : PositionMode_Percent, true);
+
+		item = Json::getString(constraintMap, "spacingMode", "length");
+		SpacingMode spacingMode = SpacingMode_Length;
+		if (strcmp(item, "fixed") == 0) spacingMode = SpacingMode_Fixed;
+		else if (strcmp(item, "percent") == 0) spacingMode = SpacingMode_Percent;
+		writeVarint(output, spacingMode, true);
+
+		item = Json::getString(constraintMap, "rotateMode", "tangent");
+		RotateMode rotateMode = RotateMode_Tangent;
+		if (strcmp(item, "chain") == 0) rotateMode = RotateMode_Chain;
+		else if (strcmp(item, "chainScale") == 0) rotateMode = RotateMode_ChainScale;
+		writeVarint(output, rotateMode, true);
+
+		writeFloat(output, Json::getFloat(constraintMap, "rotation", 0));
+		writeFloat(output, Json::getFloat(constraintMap, "position", 0));
+		writeFloat(output, Json::getFloat(constraintMap, "spacing", 0));
+		writeFloat(output, Json::getFloat(constraintMap, "rotateMix", 1));
+		writeFloat(output, Json::getFloat(constraintMap, "translateMix", 1));
+		_pathConstraints.add(name);
+	}
+	return true;
+}
+
+bool SkeletonBinaryWriter::writeSkins(DataOutput *output, Json *root) {
+	Json *skins = Json::getItem(root, "skins");
+	Json *skinMap, *defaultSkin = NULL;
+	int otherSkins = 0;
+
+	for (skinMap = skins ? skins->_child : NULL; skinMap; skinMap = skinMap->_next) {
+		if (strcmp(Json::getString(skinMap, "name", ""), "default") == 0) defaultSkin = skinMap;
+		else otherSkins++;
+	}
+
+	/* The binary format stores the default skin first and drops it when it has no attachments, deform
+	 * timelines refer to skins by this order. */
+	Json *defaultAttachments = defaultSkin ? Json::getItem(defaultSkin, "attachments") : NULL;
+	if (defaultAttachments && defaultAttachments->_size > 0) _skins.add("default");
+	for (skinMap = skins ? skins->_child : NULL; skinMap; skinMap = skinMap->_next) {
+		if (skinMap != defaultSkin) _skins.add(Json::getString(skinMap, "name", ""));
+	}
+
+	if (defaultSkin) {
+		if (!writeSkin(output, defaultSkin, true)) return false;
+	} else {
+		writeVarint(output, 0, true);
+	}
+
+	writeVarint(output, otherSkins, true);
+	for (skinMap = skins ? skins->_child : NULL; skinMap; skinMap = skinMap->_next) {
+		if (skinMap != defaultSkin && !writeSkin(output, skinMap, false)) return false;
+	}
+	return true;
+}
+
+bool SkeletonBinaryWriter::writeSkin(DataOutput *output, Json *skinMap, bool defaultSkin) {
+	Json *attachments = Json::getItem(skinMap, "attachments");
+	Json *item;
+
+	if (!defaultSkin) {
+		writeStringRef(output, Json::getString(skinMap, "name", ""));
+
+		item = Json::getItem(skinMap, "bones");
+		writeVarint(output, item ? item->_size : 0, true);
+		for (item = item ? item->_child : NULL; item; item = item->_next) {
+			int index = indexOf(_bones, item->_valueString);
+			if (index == -1) {
+				setError("Skin bone not found: ", item->_valueString);
+				return false;
+			}
+			writeVarint(output, index, true);
+		}
+
+		item = Json::getItem(skinMap, "ik");
+		writeVarint(output, item ? item->_size : 0, true);
+		for (item = item ? item->_child : NULL; item; item = item->_next) {
+			int index = indexOf(_ikConstraints, item->_valueString);
+			if (index == -1) {
+				setError("Skin IK constraint not found: ", item->_valueString);
+				return false;
+			}
+			writeVarint(output, index, true);
+		}
+
+		item = Json::getItem(skinMap, "transform");
+		writeVarint(output, item ? item->_size : 0, true);
+		for (item = item ? item->_child : NULL; item; item = item->_next) {
+			int index = indexOf(_transformConstraints, item->_valueString);
+			if (index == -1) {
+				setError("Skin transform constraint not found: ", item->_valueString);
+				return false;
+			}
+			writeVarint(output, index, true);
+		}
+
+		item = Json::getItem(skinMap, "path");
+		writeVarint(output, item ? item->_size : 0, true);
+		for (item = item ? item->_child : NULL; item; item = item->_next) {
+			int index = indexOf(_pathConstraints, item->_valueString);
+			if (index == -1) {
+				setError("Skin path constraint not found: ", item->_valueString);
+				return false;
+			}
+			writeVarint(output, index, true);
+		}
+	}
+
+	writeVarint(output, attachments ? attachments->_size : 0, true);
+	for (Json *attachmentsMap = attachments ? attachments->_child : NULL; attachmentsMap; attachmentsMap = attachmentsMap->_next) {
+		int slotIndex = indexOf(_slots, attachmentsMap->_name);
+		if (slotIndex == -1) {
+			setError("Skin slot not found: ", attachmentsMap->_name);
+			return false;
+		}
+		writeVarint(output, slotIndex, true);
+		writeVarint(output, attachmentsMap->_size, true);
+		for (Json *attachmentMap = attachmentsMap->_child; attachmentMap; attachmentMap = attachmentMap->_next) {
+			writeStringRef(output, attachmentMap->_name);
+			if (!writeAttachment(output, attachmentMap, attachmentMap->_name)) return false;
+		}
+	}
+	return true;
+}
+
+bool SkeletonBinaryWriter::writeAttachment(DataOutput *output, Json *attachmentMap, const char *skinAttachmentName) {
+	const char *name = Json::getString(attachmentMap, "name", skinAttachmentName);
+	const char *path = Json::getString(attachmentMap, "path", name);
+	const char *typeString = Json::getString(attachmentMap, "type", "region");
+	Json *entry;
+
+	/* Names and paths equal to their defaults are left out, SkeletonBinary falls back the same way. */
+	writeStringRef(output, strcmp(name, skinAttachmentName) == 0 ? NULL : name);
+	const char *pathRef = strcmp(path, name) == 0 ? NULL : path;
+
+	if (strcmp(typeString, "region") == 0) {
+		writeByte(output, AttachmentType_Region);
+		writeStringRef(output, pathRef);
+		writeFloat(output, Json::getFloat(attachmentMap, "rotation", 0));
+		writeFloat(output, Json::getFloat(attachmentMap, "x", 0));
+		writeFloat(output, Json::getFloat(attachmentMap, "y", 0));
+		writeFloat(output, Json::getFloat(attachmentMap, "scaleX", 1));
+		writeFloat(output, Json::getFloat(attachmentMap, "scaleY", 1));
+		writeFloat(output, Json::getFloat(attachmentMap, "width", 32));
+		writeFloat(output, Json::getFloat(attachmentMap, "height", 32));
+		writeColor(output, Json::getString(attachmentMap, "color", "ffffffff"));
+	} else if (strcmp(typeString, "mesh") == 0 || strcmp(typeString, "linkedmesh") == 0) {
+		/* Like SkeletonJson, any mesh with a parent is a linked mesh. */
+		entry = Json::getItem(attachmentMap, "parent");
+		if (entry) {
+			writeByte(output, AttachmentType_Linkedmesh);
+			writeStringRef(output, pathRef);
+			writeColor(output, Json::getString(attachmentMap, "color", "ffffffff"));
+			writeStringRef(output, Json::getString(attachmentMap, "skin", 0));
+			writeStringRef(output, entry->_valueString);
+			writeBoolean(output, Json::getInt(attachmentMap, "deform", 1) != 0);
+			writeFloat(output, Json::getFloat(attachmentMap, "width", 32));
+			writeFloat(output, Json::getFloat(attachmentMap, "height", 32));
+		} else {
+			writeByte(output, AttachmentType_Mesh);
+			writeStringRef(output, pathRef);
+			writeColor(output, Json::getString(attachmentMap, "color", "ffffffff"));
+
+			Json *uvs = Json::getItem(attachmentMap, "uvs");
+			int verticesLength = uvs ? uvs->_size : 0;
+			writeVarint(output, verticesLength >> 1, true);
+			for (entry = uvs ? uvs->_child : NULL; entry; entry = entry->_next)
+				writeFloat(output, entry->_valueFloat);
+
+			Json *triangles = Json::getItem(attachmentMap, "triangles");
+			writeVarint(output, triangles ? triangles->_size : 0, true);
+			for (entry = triangles ? triangles->_child : NULL; entry; entry = entry->_next) {
+				writeByte(output, (unsigned char) (entry->_valueInt >> 8));
+				writeByte(output, (unsigned char) entry->_valueInt);
+			}
+
+			writeVertices(output, attachmentMap, verticesLength);
+			writeVarint(output, Json::getInt(attachmentMap, "hull", 0), true);
+
+			Json *edges = Json::getItem(attachmentMap, "edges");
+			writeVarint(output, edges ? edges->_size : 0, true);
+			for (entry = edges ? edges->_child : NULL; entry; entry = entry->_next) {
+				writeByte(output, (unsigned char) (entry->_valueInt >> 8));
+				writeByte(output, (unsigned char) entry->_valueInt);
+			}
+			writeFloat(output, Json::getFloat(attachmentMap, "width", 32));
+			writeFloat(output, Json::getFloat(attachmentMap, "height", 32));
+		}
+	} else if (strcmp(typeString, "boundingbox") == 0) {
+		int vertexCount = Json::getInt(attachmentMap, "vertexCount", 0);
+		writeByte(output, AttachmentType_Boundingbox);
+		writeVarint(output, vertexCount, true);
+		writeVertices(output, attachmentMap, vertexCount << 1);
+		writeColor(output, Json::getString(attachmentMap, "color", "ffffffff"));
+	} else if (strcmp(typeString, "path") == 0) {
+		int vertexCount = Json::getInt(attachmentMap, "vertexCount", 0);
+		writeByte(output, AttachmentType_Path);
+		writeBoolean(output, Json::getInt(attachmentMap, "closed", 0) != 0);
+		writeBoolean(output, Json::getInt(attachmentMap, "constantSpeed", 1) != 0);
+		writeVarint(output, vertexCount, true);
+		writeVertices(output, attachmentMap, vertexCount << 1);
+
+		Json *lengths = Json::getItem(attachmentMap, "lengths");
+		entry = lengths ? lengths->_child : NULL;
+		for (int i = 0, n = vertexCount / 3; i < n; ++i) {
+			writeFloat(output, entry ? entry->_valueFloat : 0);
+			if (entry) entry = entry->_next;
+		}
+		writeColor(output, Json::getString(attachmentMap, "color", "ffffffff"));
+	} else if (strcmp(typeString, "point") == 0) {
+		writeByte(output, AttachmentType_Point);
+		writeFloat(output, Json::getFloat(attachmentMap, "rotation", 0));
+		writeFloat(output, Json::getFloat(attachmentMap, "x", 0));
+		writeFloat(output, Json::getFloat(attachmentMap, "y", 0));
+		writeColor(output, Json::getString(attachmentMap, "color", "ffffffff"));
+	} else if (strcmp(typeString, "clipping") == 0) {
+		const char *end = Json::getString(attachmentMap, "end", 0);
+		int endSlot = indexOf(_slots, end);
+		if (endSlot == -1) {
+			setError("Clipping end slot not found: ", end ? end : skinAttachmentName);
+			return false;
+		}
+		int vertexCount = Json::getInt(attachmentMap, "vertexCount", 0);
+		writeByte(output, AttachmentType_Clipping);
+		writeVarint(output, endSlot, true);
+		writeVarint(output, vertexCount, true);
+		writeVertices(output, attachmentMap, vertexCount << 1);
+		writeColor(output, Json::getString(attachmentMap, "color", "ffffffff"));
+	} else {
+		setError("Unknown attachment type: ", typeString);
+		return false;
+	}
+	return true;
+}
+
+void SkeletonBinaryWriter::writeVertices(DataOutput *output, Json *attachmentMap, int verticesLength) {
+	Json *vertices = Json::getItem(attachmentMap, "vertices");
+	Json *entry = vertices ? vertices->_child : NULL;
+	int entrySize = vertices ? vertices->_size : 0;
+
+	if (verticesLength == entrySize) {
+		writeBoolean(output, false);
+		for (; entry; entry = entry->_next)
+			writeFloat(output, entry->_valueFloat);
+		return;
+	}
+
+	/* Weighted: bone count, then bone index, x, y and weight per bone. */
+	writeBoolean(output, true);
+	while (entry) {
+		int boneCount = entry->_valueInt;
+		writeVarint(output, boneCount, true);
+		entry = entry->_next;
+		for (int i = 0; i < boneCount && entry; ++i) {
+			writeVarint(output, entry->_valueInt, true);
+			entry = entry->_next;
+			for (int ii = 0; ii < 3; ++ii) {
+				writeFloat(output, entry ? entry->_valueFloat : 0);
+				if (entry) entry = entry->_next;
+			}
+		}
+	}
+}
+
+bool SkeletonBinaryWriter::writeEvents(DataOutput *output, Json *root) {
+	Json *events = Json::getItem(root, "events");
+	writeVarint(output, events ? events->_size : 0, true);
+	for (Json *eventMap = events ? events->_child : NULL; eventMap; eventMap = eventMap->_next) {
+		writeStringRef(output, eventMap->_name);
+		writeVarint(output, Json::getInt(eventMap, "int", 0), false);
+		writeFloat(output, Json::getFloat(eventMap, "float", 0));
+		writeString(output, Json::getString(eventMap, "string", 0));
+		const char *audioPath = Json::getString(eventMap, "audio", 0);
+		writeString(output, audioPath);
+		if (audioPath && *audioPath) {
+			writeFloat(output, Json::getFloat(eventMap, "volume", 1));
+			writeFloat(output, Json::getFloat(eventMap, "balance", 0));
+		}
+		_events.add(eventMap);
+	}
+	return true;
+}
+
+bool SkeletonBinaryWriter::writeAnimation(DataOutput *output, Json *animationMap) {
+	Json *bones = Json::getItem(animationMap, "bones");
+	Json *slots = Json::getItem(animationMap, "slots");
+	Json *ik = Json::getItem(animationMap, "ik");
+	Json *transform = Json::getItem(animationMap, "transform");
+	Json *paths = Json::getItem(animationMap, "path");
+	Json *deform = Json::getItem(animationMap, "deform");
+	Json *drawOrder = Json::getItem(animationMap, "drawOrder");
+	Json *events = Json::getItem(animationMap, "events");
+	Json *boneMap, *slotMap, *constraintMap, *timelineMap, *valueMap;
+	if (!drawOrder) drawOrder = Json::getItem(animationMap, "draworder");
+
+	/* Slot timelines. */
+	writeVarint(output, slots ? slots->_size : 0, true);
+	for (slotMap = slots ? slots->_child : NULL; slotMap; slotMap = slotMap->_next) {
+		int slotIndex = indexOf(_slots, slotMap->_name);
+		if (slotIndex == -1) {
+			setError("Slot not found: ", slotMap->_name);
+			return false;
+		}
+		writeVarint(output, slotIndex, true);
+		writeVarint(output, slotMap->_size, true);
+		for (timelineMap = slotMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+			if (strcmp(timelineMap->_name, "attachment") == 0) {
+				writeByte(output, (unsigned char) SkeletonBinary::SLOT_ATTACHMENT);
+				writeVarint(output, timelineMap->_size, true);
+				for (valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+					Json *name = Json::getItem(valueMap, "name");
+					writeFloat(output, Json::getFloat(valueMap, "time", 0));
+					writeStringRef(output, name && name->_type == Json::JSON_STRING ? name->_valueString : NULL);
+				}
+			} else if (strcmp(timelineMap->_name, "color") == 0) {
+				writeByte(output, (unsigned char) SkeletonBinary::SLOT_COLOR);
+				writeVarint(output, timelineMap->_size, true);
+				for (valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+					writeFloat(output, Json::getFloat(valueMap, "time", 0));
+					writeColor(output, Json::getString(valueMap, "color", 0));
+					if (valueMap->_next) writeCurve(output, valueMap);
+				}
+			} else if (strcmp(timelineMap->_name, "twoColor") == 0) {
+				writeByte(output, (unsigned char) SkeletonBinary::SLOT_TWO_COLOR);
+				writeVarint(output, timelineMap->_size, true);
+				for (valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+					writeFloat(output, Json::getFloat(valueMap, "time", 0));
+					writeColor(output, Json::getString(valueMap, "light", 0));
+					writeColor(output, Json::getString(valueMap, "dark", 0), false);
+					if (valueMap->_next) writeCurve(output, valueMap);
+				}
+			} else {
+				setError("Invalid timeline type for a slot: ", timelineMap->_name);
+				return false;
+			}
+		}
+	}
+
+	/* Bone timelines. */
+	writeVarint(output, bones ? bones->_size : 0, true);
+	for (boneMap = bones ? bones->_child : NULL; boneMap; boneMap = boneMap->_next) {
+		int boneIndex = indexOf(_bones, boneMap->_name);
+		if (boneIndex == -1) {
+			setError("Bone not found: ", boneMap->_name);
+			return false;
+		}
+		writeVarint(output, boneIndex, true);
+		writeVarint(output, boneMap->_size, true);
+		for (timelineMap = boneMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+			if (strcmp(timelineMap->_name, "rotate") == 0) {
+				writeByte(output, (unsigned char) SkeletonBinary::BONE_ROTATE);
+				writeVarint(output, timelineMap->_size, true);
+				for (valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+					writeFloat(output, Json::getFloat(valueMap, "time", 0));
+					writeFloat(output, Json::getFloat(valueMap, "angle", 0));
+					if (valueMap->_next) writeCurve(output, valueMap);
+				}
+				continue;
+			}
+
+			int timelineType;
+			float defaultValue = 0;
+			if (strcmp(timelineMap->_name, "translate") == 0) {
+				timelineType = SkeletonBinary::BONE_TRANSLATE;
+			} else if (strcmp(timelineMap->_name, "scale") == 0) {
+				timelineType = SkeletonBinary::BONE_SCALE;
+				defaultValue = 1;
+			} else if (strcmp(timelineMap->_name, "shear") == 0) {
+				timelineType = SkeletonBinary::BONE_SHEAR;
+			} else {
+				setError("Invalid timeline type for a bone: ", timelineMap->_name);
+				return false;
+			}
+			writeByte(output, (unsigned char) timelineType);
+			writeVarint(output, timelineMap->_size, true);
+			for (valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+				writeFloat(output, Json::getFloat(valueMap, "time", 0));
+				writeFloat(output, Json::getFloat(valueMap, "x", defaultValue));
+				writeFloat(output, Json::getFloat(valueMap, "y", defaultValue));
+				if (valueMap->_next) writeCurve(output, valueMap);
+			}
+		}
+	}
+
+	/* IK constraint timelines. */
+	writeVarint(output, ik ? ik->_size : 0, true);
+	for (constraintMap = ik ? ik->_child : NULL; constraintMap; constraintMap = constraintMap->_next) {
+		int index = indexOf(_ikConstraints, constraintMap->_name);
+		if (index == -1) {
+			setError("IK constraint not found: ", constraintMap->_name);
+			return false;
+		}
+		writeVarint(output, index, true);
+		writeVarint(output, constraintMap->_size, true);
+		for (valueMap = constraintMap->_child; valueMap; valueMap = valueMap->_next) {
+			writeFloat(output, Json::getFloat(valueMap, "time", 0));
+			writeFloat(output, Json::getFloat(valueMap, "mix", 1));
+			writeFloat(output, Json::getFloat(valueMap, "softness", 0));
+			writeByte(output, (unsigned char) (signed char) (Json::getInt(valueMap, "bendPositive", 1) ? 1 : -1));
+			writeBoolean(output, Json::getInt(valueMap, "compress", 0) != 0);
+			writeBoolean(output, Json::getInt(valueMap, "stretch", 0) != 0);
+			if (valueMap->_next) writeCurve(output, valueMap);
+		}
+	}
+
+	/* Transform constraint timelines. */
+	writeVarint(output, transform ? transform->_size : 0, true);
+	for (constraintMap = transform ? transform->_child : NULL; constraintMap; constraintMap = constraintMap->_next) {
+		int index = indexOf(_transformConstraints, constraintMap->_name);
+		if (index == -1) {
+			setError("Transform constraint not found: ", constraintMap->_name);
+			return false;
+		}
+		writeVarint(output, index, true);
+		writeVarint(output, constraintMap->_size, true);
+		for (valueMap = constraintMap->_child; valueMap; valueMap = valueMap->_next) {
+			writeFloat(output, Json::getFloat(valueMap, "time", 0));
+			writeFloat(output, Json::getFloat(valueMap, "rotateMix", 1));
+			writeFloat(output, Json::getFloat(valueMap, "translateMix", 1));
+			writeFloat(output, Json::getFloat(valueMap, "scaleMix", 1));
+			writeFloat(output, Json::getFloat(valueMap, "shearMix", 1));
+			if (valueMap->_next) writeCurve(output, valueMap);
+		}
+	}
+
+	/* Path constraint timelines. */
+	writeVarint(output, paths ? paths->_size : 0, true);
+	for (constraintMap = paths ? paths->_child : NULL; constraintMap; constraintMap = constraintMap->_next) {
+		int index = indexOf(_pathConstraints, constraintMap->_name);
+		if (index == -1) {
+			setError("Path constraint not found: ", constraintMap->_name);
+			return false;
+		}
+		writeVarint(output, index, true);
+
+		/* SkeletonJson skips unknown path timelines, so only the known ones are counted. */
+		int timelineCount = 0;
+		for (timelineMap = constraintMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+			if (strcmp(timelineMap->_name, "position") == 0 || strcmp(timelineMap->_name, "spacing") == 0 ||
+				strcmp(timelineMap->_name, "mix") == 0)
+				timelineCount++;
+		}
+		writeVarint(output, timelineCount, true);
+
+		for (timelineMap = constraintMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+			const char *timelineName = timelineMap->_name;
+			if (strcmp(timelineName, "position") == 0 || strcmp(timelineName, "spacing") == 0) {
+				bool spacing = strcmp(timelineName, "spacing") == 0;
+				writeByte(output, (unsigned char) (spacing ? SkeletonBinary::PATH_SPACING : SkeletonBinary::PATH_POSITION));
+				writeVarint(output, timelineMap->_size, true);
+				for (valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+					writeFloat(output, Json::getFloat(valueMap, "time", 0));
+					writeFloat(output, Json::getFloat(valueMap, timelineName, 0));
+					if (valueMap->_next) writeCurve(output, valueMap);
+				}
+			} else if (strcmp(timelineName, "mix") == 0) {
+				writeByte(output, (unsigned char) SkeletonBinary::PATH_MIX);
+				writeVarint(output, timelineMap->_size, true);
+				for (valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+					writeFloat(output, Json::getFloat(valueMap, "time", 0));
+					writeFloat(output, Json::getFloat(valueMap, "rotateMix", 1));
+					writeFloat(output, Json::getFloat(valueMap, "translateMix", 1));
+					if (valueMap->_next) writeCurve(output, valueMap);
+				}
+			}
+		}
+	}
+
+	/* Deform timelines. */
+	writeVarint(output, deform ? deform->_size : 0, true);
+	for (constraintMap = deform ? deform->_child : NULL; constraintMap; constraintMap = constraintMap->_next) {
+		int skinIndex = indexOf(_skins, constraintMap->_name);
+		if (skinIndex == -1) {
+			setError("Skin not found: ", constraintMap->_name);
+			return false;
+		}
+		writeVarint(output, skinIndex, true);
+		writeVarint(output, constraintMap->_size, true);
+		for (slotMap = constraintMap->_child; slotMap; slotMap = slotMap->_next) {
+			int slotIndex = indexOf(_slots, slotMap->_name);
+			if (slotIndex == -1) {
+				setError("Slot not found: ", slotMap->_name);
+				return false;
+			}
+			writeVarint(output, slotIndex, true);
+			writeVarint(output, slotMap->_size, true);
+			for (timelineMap = slotMap->_child; timelineMap; timelineMap = timelineMap->_next) {
+				writeStringRef(output, timelineMap->_name);
+				writeVarint(output, timelineMap->_size, true);
+				for (valueMap = timelineMap->_child; valueMap; valueMap = valueMap->_next) {
+					Json *vertices = Json::getItem(valueMap, "vertices");
+					writeFloat(output, Json::getFloat(valueMap, "time", 0));
+					writeVarint(output, vertices ? vertices->_size : 0, true);
+					if (vertices && vertices->_size > 0) {
+						writeVarint(output, Json::getInt(valueMap, "offset", 0), true);
+						for (Json *vertex = vertices->_child; vertex; vertex = vertex->_next)
+							writeFloat(output, vertex->_valueFloat);
+					}
+					if (valueMap->_next) writeCurve(output, valueMap);
+				}
+			}
+		}
+	}
+
+	/* Draw order timeline. */
+	writeVarint(output, drawOrder ? drawOrder->_size : 0, true);
+	for (valueMap = drawOrder ? drawOrder->_child : NULL; valueMap; valueMap = valueMap->_next) {
+		Json *offsets = Json::getItem(valueMap, "offsets");
+		writeFloat(output, Json::getFloat(valueMap, "time", 0));
+		writeVarint(output, offsets ? offsets->_size : 0, true);
+		for (Json *offsetMap = offsets ? offsets->_child : NULL; offsetMap; offsetMap = offsetMap->_next) {
+			const char *slotName = Json::getString(offsetMap, "slot", 0);
+			int slotIndex = indexOf(_slots, slotName);
+			if (slotIndex == -1) {
+				setError("Slot not found: ", slotName);
+				return false;
+			}
+			writeVarint(output, slotIndex, true);
+			/* Negative offsets are stored as their unsigned 32 bit value, which readVarint restores. */
+			writeVarint(output, Json::getInt(offsetMap, "offset", 0), true);
+		}
+	}
+
+	/* Event timeline. */
+	writeVarint(output, events ? events->_size : 0, true);
+	for (valueMap = events ? events->_child : NULL; valueMap; valueMap = valueMap->_next) {
+		const char *eventName = Json::getString(valueMap, "name", 0);
+		Json *eventData = NULL;
+		int eventIndex = 0;
+		for (; eventIndex < (int) _events.size(); ++eventIndex) {
+			if (eventName && strcmp(_events[eventIndex]->_name, eventName) == 0) {
+				eventData = _events[eventIndex];
+				break;
+			}
+		}
+		if (!eventData) {
+			setError("Event not found: ", eventName);
+			return false;
+		}
+
+		writeFloat(output, Json::getFloat(valueMap, "time", 0));
+		writeVarint(output, eventIndex, true);
+		writeVarint(output, Json::getInt(valueMap, "int", Json::getInt(eventData, "int", 0)), false);
+		writeFloat(output, Json::getFloat(valueMap, "float", Json::getFloat(eventData, "float", 0)));
+		Json *string = Json::getItem(valueMap, "string");
+		writeBoolean(output, string != NULL);
+		if (string) writeString(output, string->_valueString);
+		const char *audioPath = Json::getString(eventData, "audio", 0);
+		if (audioPath && *audioPath) {
+			writeFloat(output, Json::getFloat(valueMap, "volume", 1));
+			writeFloat(output, Json::getFloat(valueMap, "balance", 0));
+		}
+	}
+	return true;
+}
+
+void SkeletonBinaryWriter::writeCurve(DataOutput *output, Json *frame) {
+	Json *curve = Json::getItem(frame, "curve");
+	if (!curve) {
+		writeByte(output, (unsigned char) SkeletonBinary::CURVE_LINEAR);
+	} else if (curve->_type == Json::JSON_STRING && strcmp(curve->_valueString, "stepped") == 0) {
+		writeByte(output, (unsigned char) SkeletonBinary::CURVE_STEPPED);
+	} else {
+		writeByte(output, (unsigned char) SkeletonBinary::CURVE_BEZIER);
+		writeFloat(output, Json::getFloat(frame, "curve", 0));
+		writeFloat(output, Json::getFloat(frame, "c2", 0));
+		writeFloat(output, Json::getFloat(frame, "c3", 1));
+		writeFloat(output, Json::getFloat(frame, "c4", 1));
+	}
+}
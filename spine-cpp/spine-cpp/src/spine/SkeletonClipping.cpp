@@ -35,6 +35,7 @@
 
 #include <spine/Slot.h>
 #include <spine/ClippingAttachment.h>
+#include <spine/ContainerUtil.h>
 
 using namespace spine;
 
@@ -45,6 +46,11 @@ SkeletonClipping::SkeletonClipping() : _clipAttachment(NULL) {
 	_clippedUVs.ensureCapacity(128);
 }
 
+SkeletonClipping::~SkeletonClipping() {
+	ContainerUtil::cleanUpVectorOfPointers(_decompositions);
+	ContainerUtil::cleanUpVectorOfPointers(_transformedPolygons);
+}
+
 size_t SkeletonClipping::clipStart(Slot &slot, ClippingAttachment *clip) {
 	if (_clipAttachment != NULL) {
 		return 0;
@@ -55,20 +61,74 @@ size_t SkeletonClipping::clipStart(Slot &slot, ClippingAttachment *clip) {
 	int n = clip->getWorldVerticesLength();
 	_clippingPolygon.setSize(n, 0);
 	clip->computeWorldVertices(slot, 0, n, _clippingPolygon, 0, 2);
-	makeClockwise(_clippingPolygon);
-	_clippingPolygons = &_triangulator.decompose(_clippingPolygon, _triangulator.triangulate(_clippingPolygon));
 
-	for (size_t i = 0; i < _clippingPolygons->size(); ++i) {
-		Vector<float> *polygonP = (*_clippingPolygons)[i];
-		Vector<float> &polygon = *polygonP;
-		makeClockwise(polygon);
-		polygon.add(polygon[0]);
-		polygon.add(polygon[1]);
+	/* A polygon transformed by its bone only keeps its decomposition, skip the triangulation. */
+	if (clip->getBones().size() == 0 && slot.getDeform().size() == 0) {
+		ConvexDecomposition *decomposition = getDecomposition(clip);
+		transformDecomposition(*decomposition);
+		_clippingPolygons = &_transformedPolygons;
+	} else {
+		makeClockwise(_clippingPolygon);
+		_clippingPolygons = &_triangulator.decompose(_clippingPolygon, _triangulator.triangulate(_clippingPolygon));
+
+		for (size_t i = 0; i < _clippingPolygons->size(); ++i) {
+			Vector<float> *polygonP = (*_clippingPolygons)[i];
+			Vector<float> &polygon = *polygonP;
+			makeClockwise(polygon);
+			polygon.add(polygon[0]);
+			polygon.add(polygon[1]);
+		}
 	}
 
+	computeBounds();
 	return (*_clippingPolygons).size();
 }
 
+void SkeletonClipping::computeBounds() {
+	Vector<Vector<float> *> &polygons = *_clippingPolygons;
+	_clippingBounds.setSize(polygons.size() << 2, 0);
+	_clippingRectangles.setSize(polygons.size(), false);
+	for (size_t p = 0; p < polygons.size(); ++p) {
+		Vector<float> &polygon = *polygons[p];
+		float *bounds = &_clippingBounds[p << 2];
+		bounds[0] = bounds[2] = polygon[0];
+		bounds[1] = bounds[3] = polygon[1];
+		bool rectangle = polygon.size() == 10;
+		for (size_t i = 2; i < polygon.size(); i += 2) {
+			float x = polygon[i], y = polygon[i + 1];
+			bounds[0] = MathUtil::min(bounds[0], x);
+			bounds[1] = MathUtil::min(bounds[1], y);
+			bounds[2] = MathUtil::max(bounds[2], x);
+			bounds[3] = MathUtil::max(bounds[3], y);
+			rectangle = rectangle && (x == polygon[i - 2] || y == polygon[i - 1]);
+		}
+		_clippingRectangles[p] = rectangle;
+	}
+}
+
+/* Whether clip() would keep the triangle whole: all three vertices strictly inside every edge of the clockwise polygon.
+ * The sides are computed as clip() computes them. */
+static bool insidePolygon(Vector<float> &polygon, const float *xs, const float *ys) {
+	for (size_t i = 0, n = polygon.size() - 2; i < n; i += 2) {
+		float edgeX = polygon[i], edgeY = polygon[i + 1];
+		float edgeX2 = polygon[i + 2], edgeY2 = polygon[i + 3];
+		float deltaX = edgeX - edgeX2, deltaY = edgeY - edgeY2;
+		bool inside = true;
+		for (int v = 0; v < 3; ++v)
+			inside &= deltaX * (ys[v] - edgeY2) - deltaY * (xs[v] - edgeX2) > 0;
+		if (!inside) return false;
+	}
+	return true;
+}
+
+/* The same test against an axis aligned rectangle, each edge reduces to a comparison. */
+static bool insideRectangle(const float *bounds, const float *xs, const float *ys) {
+	bool inside = true;
+	for (int v = 0; v < 3; ++v)
+		inside &= xs[v] > bounds[0] && ys[v] > bounds[1] && xs[v] < bounds[2] && ys[v] < bounds[3];
+	return inside;
+}
+
 void SkeletonClipping::clipEnd(Slot &slot) {
 	if (_clipAttachment != NULL && _clipAttachment->_endSlot == &slot._data) {
 		clipEnd();
@@ -119,9 +179,20 @@ void SkeletonClipping::clipTriangles(float *vertices, unsigned short *triangles,
 		float x3 = vertices[vertexOffset], y3 = vertices[vertexOffset + 1];
 		float u3 = uvs[vertexOffset], v3 = uvs[vertexOffset + 1];
 
+		const float xs[3] = {x1, x2, x3}, ys[3] = {y1, y2, y3};
+		float minX = MathUtil::min(x1, MathUtil::min(x2, x3)), maxX = MathUtil::max(x1, MathUtil::max(x2, x3));
+		float minY = MathUtil::min(y1, MathUtil::min(y2, y3)), maxY = MathUtil::max(y1, MathUtil::max(y2, y3));
+
 		for (size_t p = 0; p < polygonsCount; p++) {
 			size_t s = clippedVertices.size();
-			if (clip(x1, y1, x2, y2, x3, y3, &(*polygons[p]), &clipOutput)) {
+
+			/* Triangles apart from the polygon's bounds clip to nothing, ones inside all its edges are kept whole.
+			 * Only the rest go through clip(). */
+			const float *bounds = &_clippingBounds[p << 2];
+			if (maxX < bounds[0] || maxY < bounds[1] || minX > bounds[2] || minY > bounds[3]) continue;
+			bool inside = _clippingRectangles[p] ? insideRectangle(bounds, xs, ys) : insidePolygon(*polygons[p], xs, ys);
+
+			if (!inside && clip(x1, y1, x2, y2, x3, y3, &(*polygons[p]), &clipOutput)) {
 				size_t clipOutputLength = clipOutput.size();
 				if (clipOutputLength == 0) continue;
 				float d0 = y2 - y3, d1 = x3 - x2, d2 = x1 - x3, d4 = y3 - y1;
@@ -301,7 +372,59 @@ bool SkeletonClipping::clip(float x1, float y1, float x2, float y2, float x3, fl
 	return clipped;
 }
 
-void SkeletonClipping::makeClockwise(Vector<float> &polygon) {
+SkeletonClipping::ConvexDecomposition *SkeletonClipping::getDecomposition(ClippingAttachment *clip) {
+	size_t verticesLength = clip->getWorldVerticesLength();
+	for (size_t i = 0; i < _decompositions.size(); ++i) {
+		ConvexDecomposition *decomposition = _decompositions[i];
+		if (decomposition->_attachment == clip && decomposition->_verticesLength == verticesLength) return decomposition;
+	}
+
+	/* Triangulate the setup vertices, with offsets into them as they are, whichever way they wind. */
+	Vector<float> polygon;
+	polygon.addAll(clip->getVertices());
+	bool reversed = !isClockwise(polygon);
+	makeClockwise(polygon);
+	Vector< Vector<float>* > &polygons = _triangulator.decompose(polygon, _triangulator.triangulate(polygon));
+	Vector< Vector<int>* > &polygonsOffsets = _triangulator.getConvexPolygonsIndices();
+
+	ConvexDecomposition *decomposition = new (__FILE__, __LINE__) ConvexDecomposition();
+	decomposition->_attachment = clip;
+	decomposition->_verticesLength = verticesLength;
+	for (size_t i = 0; i < polygons.size(); ++i) {
+		Vector<int> &offsets = *polygonsOffsets[i];
+		for (size_t ii = 0; ii < offsets.size(); ++ii)
+			decomposition->_offsets.add(reversed ? (int)verticesLength - 2 - offsets[ii] : offsets[ii]);
+		decomposition->_counts.add((int)offsets.size());
+	}
+	_decompositions.add(decomposition);
+	return decomposition;
+}
+
+void SkeletonClipping::transformDecomposition(ConvexDecomposition &decomposition) {
+	Vector<int> &counts = decomposition._counts;
+	while (_transformedPolygons.size() < counts.size())
+		_transformedPolygons.add(new (__FILE__, __LINE__) Vector<float>());
+	while (_transformedPolygons.size() > counts.size()) {
+		delete _transformedPolygons[_transformedPolygons.size() - 1];
+		_transformedPolygons.removeAt(_transformedPolygons.size() - 1);
+	}
+
+	const int *offsets = decomposition._offsets.buffer();
+	for (size_t i = 0; i < counts.size(); ++i) {
+		Vector<float> &polygon = *_transformedPolygons[i];
+		polygon.clear();
+		for (int ii = 0; ii < counts[i]; ++ii, ++offsets) {
+			polygon.add(_clippingPolygon[*offsets]);
+			polygon.add(_clippingPolygon[*offsets + 1]);
+		}
+		/* A mirroring bone flips the winding. */
+		makeClockwise(polygon);
+		polygon.add(polygon[0]);
+		polygon.add(polygon[1]);
+	}
+}
+
+bool SkeletonClipping::isClockwise(Vector<float> &polygon) {
 	size_t verticeslength = polygon.size();
 
 	float area = polygon[verticeslength - 2] * polygon[1] - polygon[0] * polygon[verticeslength - 1];
@@ -315,7 +438,13 @@ void SkeletonClipping::makeClockwise(Vector<float> &polygon) {
 		area += p1x * p2y - p2x * p1y;
 	}
 
-	if (area < 0) return;
+	return area < 0;
+}
+
+void SkeletonClipping::makeClockwise(Vector<float> &polygon) {
+	size_t verticeslength = polygon.size();
+
+	if (isClockwise(polygon)) return;
 
 	for (size_t i = 0, lastX = verticeslength - 2, n = verticeslength >> 1; i < n; i += 2) {
 		float x = polygon[i], y = polygon[i + 1];
@@ -38,6 +38,7 @@
 #include <spine/Skin.h>
 #include <spine/EventData.h>
 #include <spine/Animation.h>
+#include <spine/AnimationLoader.h>
 #include <spine/IkConstraintData.h>
 #include <spine/TransformConstraintData.h>
 #include <spine/PathConstraintData.h>
@@ -49,6 +50,7 @@ using namespace spine;
 SkeletonData::SkeletonData() :
 		_name(),
 		_defaultSkin(NULL),
+		_animationLoader(NULL),
 		_x(0),
 		_y(0),
 		_width(0),
@@ -68,6 +70,7 @@ SkeletonData::~SkeletonData() {
 
 	ContainerUtil::cleanUpVectorOfPointers(_events);
 	ContainerUtil::cleanUpVectorOfPointers(_animations);
+	delete _animationLoader;
 	ContainerUtil::cleanUpVectorOfPointers(_ikConstraints);
 	ContainerUtil::cleanUpVectorOfPointers(_transformConstraints);
 	ContainerUtil::cleanUpVectorOfPointers(_pathConstraints);
@@ -101,7 +104,14 @@ spine::EventData *SkeletonData::findEvent(const String &eventDataName) {
 }
 
 Animation *SkeletonData::findAnimation(const String &animationName) {
-	return ContainerUtil::findWithName(_animations, animationName);
+	Animation *animation = ContainerUtil::findWithName(_animations, animationName);
+	if (animation) animation->load();
+	return animation;
+}
+
+void SkeletonData::unloadUnusedAnimations() {
+	for (size_t i = 0; i < _animations.size(); ++i)
+		_animations[i]->unload();
 }
 
 IkConstraintData *SkeletonData::findIkConstraint(const String &constraintName) {
@@ -73,6 +73,7 @@
 #include <spine/EventTimeline.h>
 #include <spine/Event.h>
 #include <spine/Vertices.h>
+#include <spine/AnimationLoader.h>
 
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32) && !defined(__CYGWIN__)
 #define strdup _strdup
@@ -80,12 +81,86 @@
 
 using namespace spine;
 
+/* Index after the string starting with the quote at text[i], 0 if the text ends first. */
+static size_t skipJsonString(const char *text, size_t length, size_t i) {
+	for (i++; i < length; i++) {
+		if (text[i] == '\\')
+			i++;
+		else if (text[i] == '"')
+			return i + 1;
+	}
+	return 0;
+}
+
+/* Index after the object or array starting at or after text[i], 0 if the text ends first. */
+static size_t skipJsonObject(const char *text, size_t length, size_t i) {
+	int depth = 0;
+	while (i < length) {
+		char c = text[i];
+		if (c == '"') {
+			i = skipJsonString(text, length, i);
+			if (!i) return 0;
+			continue;
+		}
+		if (c == '{' || c == '[')
+			depth++;
+		else if ((c == '}' || c == ']') && --depth == 0)
+			return i + 1;
+		i++;
+	}
+	return 0;
+}
+
+/// Keeps the text of each animation map and parses one at a time, the document itself is not kept.
+class SkeletonJson::LazyAnimationLoader : public AnimationLoader {
+public:
+	LazyAnimationLoader(SkeletonData *skeletonData, float scale) : AnimationLoader(scale), _skeletonData(skeletonData) {
+		_starts.add(0);
+	}
+
+	/// Copies `"name": { ... }` from the document text, start is the offset of the name's opening quote.
+	bool addAnimation(const char *text, size_t length, size_t start) {
+		if (start >= length || text[start] != '"') return false;
+		size_t end = skipJsonObject(text, length, skipJsonString(text, length, start));
+		if (end == 0) return false;
+
+		/* In braces the copy is a document whose only child is the animation map. */
+		_text.add('{');
+		for (size_t i = start; i < end; i++)
+			_text.add(text[i]);
+		_text.add('}');
+		_starts.add(_text.size());
+		return true;
+	}
+
+	virtual bool loadAnimation(Animation &animation, size_t offset) {
+		Json *root = new(__FILE__, __LINE__) Json(_text.buffer() + _starts[offset], _starts[offset + 1] - _starts[offset]);
+		/* A reader per call, animations may be loaded on several threads at once. */
+		SkeletonJson json((Atlas *) NULL);
+		json.setScale(_scale);
+		Animation *decoded = json.readAnimation(root->_child, _skeletonData);
+		delete root;
+		if (!decoded) {
+			setError(json.getError());
+			return false;
+		}
+		setTimelines(animation, *decoded);
+		delete decoded;
+		return true;
+	}
+
+private:
+	Vector<char> _text;
+	Vector<size_t> _starts;
+	SkeletonData *_skeletonData;
+};
+
 SkeletonJson::SkeletonJson(Atlas *atlas) : _attachmentLoader(new(__FILE__, __LINE__) AtlasAttachmentLoader(atlas)),
-	_scale(1), _ownsLoader(true)
+	_scale(1), _lazyAnimations(false), _ownsLoader(true)
 {}
 
 SkeletonJson::SkeletonJson(AttachmentLoader *attachmentLoader) : _attachmentLoader(attachmentLoader), _scale(1),
-	_ownsLoader(false)
+	_lazyAnimations(false), _ownsLoader(false)
 {
 	assert(_attachmentLoader != NULL);
 }
@@ -99,13 +174,14 @@ SkeletonJson::~SkeletonJson() {
 SkeletonData *SkeletonJson::readSkeletonDataFile(const String &path) {
 	int length;
 	SkeletonData *skeletonData;
-	const char *json = SpineExtension::readFile(path, &length);
+	char *json = SpineExtension::readFile(path, &length);
 	if (length == 0 || !json) {
+		if (json) SpineExtension::free(json, __FILE__, __LINE__);
 		setError(NULL, "Unable to read skeleton file: ", path);
 		return NULL;
 	}
 
-	skeletonData = readSkeletonData(json);
+	skeletonData = readSkeletonData(json, length);
 
 	SpineExtension::free(json, __FILE__, __LINE__);
 
@@ -113,6 +189,10 @@ SkeletonData *SkeletonJson::readSkeletonDataFile(const String &path) {
 }
 
 SkeletonData *SkeletonJson::readSkeletonData(const char *json) {
+	return readSkeletonData(json, (int) strlen(json));
+}
+
+SkeletonData *SkeletonJson::readSkeletonData(const char *json, int length) {
 	int i, ii;
 	SkeletonData *skeletonData;
 	Json *root, *skeleton, *bones, *boneMap, *ik, *transform, *path, *slots, *skins, *animations, *events;
@@ -120,7 +200,7 @@ SkeletonData *SkeletonJson::readSkeletonData(const char *json) {
 	_error = "";
 	_linkedMeshes.clear();
 
-	root = new(__FILE__, __LINE__) Json(json);
+	root = new(__FILE__, __LINE__) Json(json, (size_t) length);
 
 	if (!root) {
 		setError(NULL, "Invalid skeleton JSON: ", Json::getError());
@@ -705,7 +785,21 @@ SkeletonData *SkeletonJson::readSkeletonData(const char *json) {
 
 	/* Animations. */
 	animations = Json::getItem(root, "animations");
-	if (animations) {
+	if (animations && _lazyAnimations) {
+		LazyAnimationLoader *loader = new(__FILE__, __LINE__) LazyAnimationLoader(skeletonData, _scale);
+		skeletonData->_animationLoader = loader;
+		skeletonData->_animations.setSize(animations->_size, 0);
+		int animationsIndex = 0;
+		for (Json *animationMap = animations->_child; animationMap; animationMap = animationMap->_next, ++animationsIndex) {
+			if (!loader->addAnimation(json, (size_t) length, root->getTextOffset(animationMap->_name))) {
+				delete skeletonData;
+				setError(root, "Invalid animation JSON: ", animationMap->_name);
+				return NULL;
+			}
+			skeletonData->_animations[animationsIndex] = new(__FILE__, __LINE__) Animation(String(animationMap->_name),
+				loader, animationsIndex);
+		}
+	} else if (animations) {
 		Json *animationMap;
 		skeletonData->_animations.ensureCapacity(animations->_size);
 		skeletonData->_animations.setSize(animations->_size, 0);
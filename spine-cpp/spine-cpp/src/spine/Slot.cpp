@@ -49,12 +49,14 @@ Slot::Slot(SlotData &data, Bone &bone) :
 		_hasDarkColor(data.hasDarkColor()),
 		_attachment(NULL),
 		_attachmentState(0),
-		_attachmentTime(0) {
+		_attachmentTime(0),
+		_deformVersion(0) {
 	setToSetupPose();
 }
 
 void Slot::setToSetupPose() {
 	_color.set(_data.getColor());
+	if (_hasDarkColor) _darkColor.set(_data.getDarkColor());
 
 	const String &attachmentName = _data.getAttachmentName();
 	if (attachmentName.length() > 0) {
@@ -101,6 +103,7 @@ void Slot::setAttachment(Attachment *inValue) {
 	_attachment = inValue;
 	_attachmentTime = _skeleton.getTime();
 	_deform.clear();
+	_deformVersion++;
 }
 
 int Slot::getAttachmentState() {
@@ -122,3 +125,11 @@ void Slot::setAttachmentTime(float inValue) {
 Vector<float> &Slot::getDeform() {
 	return _deform;
 }
+
+unsigned int Slot::getDeformVersion() {
+	return _deformVersion;
+}
+
+void Slot::deformChanged() {
+	_deformVersion++;
+}
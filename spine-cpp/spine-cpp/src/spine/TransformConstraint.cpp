@@ -202,7 +202,10 @@ void TransformConstraint::applyAbsoluteWorld() {
 			modified = true;
 		}
 
-		if (modified) bone._appliedValid = false;
+		if (modified) {
+			bone._appliedValid = false;
+			bone._worldVersion++;
+		}
 	}
 }
 
@@ -268,7 +271,10 @@ void TransformConstraint::applyRelativeWorld() {
 			modified = true;
 		}
 
-		if (modified) bone._appliedValid = false;
+		if (modified) {
+			bone._appliedValid = false;
+			bone._worldVersion++;
+		}
 	}
 }
 
@@ -269,6 +269,10 @@ Vector<Vector<float> *> &Triangulator::decompose(Vector<float> &vertices, Vector
 	return convexPolygons;
 }
 
+Vector< Vector<int>* > &Triangulator::getConvexPolygonsIndices() {
+	return _convexPolygonsIndices;
+}
+
 bool Triangulator::isConcave(int index, int vertexCount, Vector<float> &vertices, Vector<int> &indices) {
 	int previous = indices[(vertexCount + index - 1) % vertexCount] << 1;
 	int current = indices[index] << 1;
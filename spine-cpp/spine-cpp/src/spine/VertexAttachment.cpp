@@ -37,6 +37,7 @@
 
 #include <spine/Bone.h>
 #include <spine/Skeleton.h>
+#include <spine/Threading.h>
 
 using namespace spine;
 
@@ -156,9 +157,9 @@ void VertexAttachment::setDeformAttachment(VertexAttachment* attachment) {
 }
 
 int VertexAttachment::getNextID() {
-	static int nextID = 0;
+	static volatile int nextID = 0;
 
-	return (nextID++ & 65535) << 11;
+	return ((atomicAdd(&nextID, 1) - 1) & 65535) << 11;
 }
 
 void VertexAttachment::copyTo(VertexAttachment* other) {
@@ -34,10 +34,39 @@
 #include <spine/VertexEffect.h>
 #include <spine/MathUtil.h>
 #include <spine/Skeleton.h>
+#include <spine/Color.h>
+
+#include <stdlib.h>
 
 using namespace spine;
 
-JitterVertexEffect::JitterVertexEffect(float jitterX, float jitterY): _jitterX(jitterX), _jitterY(jitterY) {
+RTTI_IMPL_NOPARENT(VertexEffect)
+
+RTTI_IMPL(JitterVertexEffect, VertexEffect)
+
+RTTI_IMPL(SwirlVertexEffect, VertexEffect)
+
+void VertexEffect::transformBatch(float *positions, float *uvs, Color *colors, size_t count) {
+	Color dark;
+	for (size_t i = 0; i < count; i++) {
+		dark.r = dark.g = dark.b = dark.a = 0;
+		transform(positions[i << 1], positions[(i << 1) + 1], uvs[i << 1], uvs[(i << 1) + 1], colors[i], dark);
+	}
+}
+
+/// Maps a counter to a uniform float in [0, 1). Stateless, so a loop of them has no dependency between iterations
+/// and vectorizes, unlike ::rand.
+static inline float hashUniform(unsigned int n) {
+	n ^= n >> 16;
+	n *= 0x7feb352dU;
+	n ^= n >> 15;
+	n *= 0x846ca68bU;
+	n ^= n >> 16;
+	return (float)(int)(n >> 8) * (1.0f / 16777216.0f);
+}
+
+JitterVertexEffect::JitterVertexEffect(float jitterX, float jitterY): _jitterX(jitterX), _jitterY(jitterY),
+	_seed((unsigned int)::rand()) {
 }
 
 void JitterVertexEffect::begin(Skeleton &skeleton) {
@@ -52,7 +81,21 @@ void JitterVertexEffect::transform(float &x, float &y, float &u, float &v, Color
 	float jitterX = _jitterX;
 	float jitterY = _jitterY;
 	x += MathUtil::randomTriangular(-jitterX, jitterX);
-	y += MathUtil::randomTriangular(-jitterX, jitterY);
+	y += MathUtil::randomTriangular(-jitterY, jitterY);
+}
+
+void JitterVertexEffect::transformBatch(float *positions, float *uvs, Color *colors, size_t count) {
+	SP_UNUSED(uvs);
+	SP_UNUSED(colors);
+	// the sum of two uniform numbers is triangular around their mean, as randomTriangular(-jitter, jitter)
+	float jitterX = _jitterX, jitterY = _jitterY;
+	unsigned int seed = _seed;
+	for (size_t i = 0; i < count; i++) {
+		unsigned int n = seed + (unsigned int)(i << 2);
+		positions[i << 1] += (hashUniform(n) + hashUniform(n + 1) - 1) * jitterX;
+		positions[(i << 1) + 1] += (hashUniform(n + 2) + hashUniform(n + 3) - 1) * jitterY;
+	}
+	_seed = seed + (unsigned int)(count << 2);
 }
 
 void JitterVertexEffect::end() {
@@ -106,6 +149,23 @@ void SwirlVertexEffect::transform(float &positionX, float &positionY, float &u,
 	}
 }
 
+void SwirlVertexEffect::transformBatch(float *positions, float *uvs, Color *colors, size_t count) {
+	SP_UNUSED(uvs);
+	SP_UNUSED(colors);
+	float worldX = _worldX, worldY = _worldY, radius = _radius, angle = _angle;
+	for (size_t i = 0; i < count; i++) {
+		float x = positions[i << 1] - worldX;
+		float y = positions[(i << 1) + 1] - worldY;
+		// the same test as transform, squared distances round differently at the edge
+		float dist = (float)MathUtil::sqrt(x * x + y * y);
+		if (!(dist < radius)) continue;
+		float theta = angle * _interpolation.apply((radius - dist) / radius);
+		float cos = MathUtil::cos(theta), sin = MathUtil::sin(theta);
+		positions[i << 1] = cos * x - sin * y + worldX;
+		positions[(i << 1) + 1] = sin * x + cos * y + worldY;
+	}
+}
+
 void SwirlVertexEffect::end() {
 
 }
@@ -157,3 +217,7 @@ void SwirlVertexEffect::setWorldY(float worldY) {
 float SwirlVertexEffect::getWorldY() {
 	return _worldY;
 }
+
+Interpolation &SwirlVertexEffect::getInterpolation() {
+	return _interpolation;
+}